@@ -0,0 +1,78 @@
+// Generated by tools/gen_dashboard.py from dashboard.html - do not edit.
+#pragma once
+
+#define DASHBOARD_ETAG "\"a47412ade5992557\""
+#define DASHBOARD_HTML_GZ_LEN 1115
+
+const uint8_t DASHBOARD_HTML_GZ[] PROGMEM = {
+  0x1f,0x8b,0x08,0x00,0x00,0x00,0x00,0x00,0x02,0x03,0xc5,0x56,0xdb,0x6e,0xe3,0x36,
+  0x10,0x7d,0xd7,0x57,0x70,0x37,0x28,0x28,0x21,0xb1,0x7c,0x49,0xd2,0x16,0x96,0xa5,
+  0x22,0x57,0x34,0xc5,0x66,0x37,0x58,0xa7,0x0f,0xfb,0x48,0x8b,0x63,0x9b,0x8d,0x4c,
+  0x0a,0x24,0x65,0xc7,0x35,0xfc,0x4f,0xfd,0x86,0x7e,0x59,0x87,0x92,0xec,0xc8,0x49,
+  0x6c,0x6c,0x1f,0x8a,0x3e,0x25,0x1c,0xce,0xe5,0x9c,0x33,0xc3,0xb1,0x06,0x1f,0xae,
+  0xbf,0x5c,0x3d,0x7e,0x7b,0xb8,0x21,0x53,0x3b,0xcb,0x12,0x6f,0xb0,0xf9,0x03,0x8c,
+  0xe3,0x9f,0x19,0x58,0x46,0x24,0x9b,0x41,0x4c,0xe7,0x02,0x16,0xb9,0xd2,0x96,0x92,
+  0x54,0x49,0x0b,0xd2,0xc6,0x74,0x21,0xb8,0x9d,0xc6,0x1c,0xe6,0x22,0x85,0x56,0x79,
+  0x38,0x11,0x52,0x58,0xc1,0xb2,0x96,0x49,0x59,0x06,0x71,0x97,0x62,0x0e,0x63,0x97,
+  0x19,0x24,0xde,0x48,0xf1,0xe5,0x6a,0x8c,0xa1,0xad,0x31,0x9b,0x89,0x6c,0xd9,0xbf,
+  0xd0,0xe8,0x18,0x8d,0x58,0xfa,0x34,0xd1,0xaa,0x90,0xbc,0x7f,0xd4,0xed,0x76,0xa3,
+  0x54,0x65,0x4a,0xf7,0x8f,0xc6,0xe3,0x71,0x34,0x63,0x7a,0x22,0x64,0xbf,0x13,0xe5,
+  0x8c,0x73,0x21,0x27,0xfd,0x5e,0x27,0x7f,0x5e,0x7b,0x61,0xca,0x34,0x5f,0x35,0xe3,
+  0x7a,0xbd,0x5e,0x34,0x52,0x9a,0x83,0x6e,0x69,0xc6,0x45,0x61,0xfa,0x3f,0xe7,0xcf,
+  0xdb,0xa8,0xee,0x39,0x1e,0xea,0x5c,0x5d,0xcc,0x40,0x3a,0x6b,0x6f,0xda,0x5d,0xd5,
+  0x85,0x3a,0x3f,0xdd,0xde,0x62,0xce,0x91,0x95,0x3b,0x29,0x9d,0x79,0x83,0xa5,0xd3,
+  0xe9,0xd4,0xe9,0xfb,0x52,0x49,0x78,0x49,0xdc,0xc3,0x64,0xbd,0x33,0xcc,0x5e,0xd2,
+  0x32,0xe2,0x4f,0xe8,0x77,0x7f,0xc4,0xe3,0x2e,0x16,0x57,0x3e,0x2d,0xb4,0xc1,0x54,
+  0xb9,0x12,0x28,0x9d,0xde,0xa0,0x39,0x2f,0xe9,0x60,0xe9,0xfe,0x54,0xcd,0x41,0xef,
+  0x02,0x38,0xbf,0xbe,0xae,0x2e,0x5b,0x0b,0xa6,0x77,0xc1,0xdd,0x5e,0xde,0x20,0x87,
+  0x70,0xce,0xb2,0x02,0x9a,0x3c,0x1a,0x38,0x2a,0xa9,0x8e,0x66,0x66,0x72,0xa9,0x9e,
+  0x57,0x65,0x6f,0x90,0x7c,0xe7,0x87,0x17,0xf0,0x9d,0x5d,0xdc,0x67,0x5b,0x91,0x5a,
+  0x56,0xe5,0xd5,0x75,0xb3,0xe6,0xe9,0xe9,0x69,0xb3,0x37,0xb5,0x1e,0x5d,0x54,0xc0,
+  0xa8,0x4c,0x70,0x52,0x01,0x78,0xc3,0x7c,0xed,0x0d,0xda,0xf5,0x00,0x0c,0xda,0xf5,
+  0x50,0xb9,0x49,0x70,0x23,0xd6,0x4d,0xee,0x71,0x5c,0xae,0x94,0xc4,0x0c,0x40,0xee,
+  0x15,0x8e,0x8e,0xd2,0xe8,0xd5,0xc5,0x4b,0x2e,0xe6,0x24,0xcd,0x98,0x31,0x31,0x75,
+  0xed,0x76,0x73,0x34,0xed,0x25,0x43,0x40,0x5f,0x6d,0x88,0xff,0x49,0xcc,0x21,0x40,
+  0xd7,0x1e,0xda,0xf3,0xe4,0x41,0xd8,0x74,0xda,0x27,0x03,0x93,0x33,0xb9,0x89,0x2a,
+  0xc5,0xa1,0x44,0xf0,0x98,0xe6,0xee,0x9a,0x26,0xad,0x16,0x42,0x41,0x8f,0xe4,0xef,
+  0xbf,0x06,0xed,0xbc,0x0c,0xfc,0xaa,0xb2,0x6c,0x7f,0x9c,0xc6,0xdb,0x77,0xc3,0xbe,
+  0xb1,0xc5,0xfe,0xa8,0x25,0x5b,0xbc,0x13,0xd4,0x46,0x42,0x7b,0x69,0x7d,0x06,0xbb,
+  0x50,0xfa,0x69,0xcb,0x67,0x38,0xbc,0xbb,0xde,0x5f,0xc0,0x18,0xc1,0x1b,0x15,0x36,
+  0xa0,0xee,0x1e,0xf6,0x87,0x88,0xfc,0x9d,0x80,0xa1,0x98,0x48,0x76,0x88,0x3e,0x16,
+  0x6a,0x84,0x11,0x7e,0x39,0xfb,0x0e,0x2e,0xd8,0x4e,0x8b,0xc2,0x99,0x9a,0xcc,0xa8,
+  0xb0,0x56,0x6d,0xb3,0xe3,0x34,0x93,0xcd,0x44,0x53,0xa2,0x64,0x9a,0x89,0xf4,0x29,
+  0xa6,0x56,0x8b,0xc9,0x04,0xf4,0x25,0x40,0xee,0x07,0x34,0x79,0xac,0x8e,0xc4,0x9d,
+  0xd1,0x89,0x5c,0x97,0x0b,0x66,0xd0,0xae,0x72,0xb9,0x32,0xa7,0x6e,0x12,0x38,0xb9,
+  0x07,0x63,0xd8,0x04,0x88,0x55,0x5b,0x1f,0xbc,0xf2,0x06,0x42,0xe6,0x85,0x25,0x76,
+  0x99,0xe3,0xda,0xb2,0xf0,0x6c,0x2b,0x3e,0xd5,0x5b,0xa0,0x24,0xcf,0x58,0x0a,0x53,
+  0x95,0xe1,0xa0,0xc6,0xf4,0x11,0x9d,0xc8,0xac,0xca,0x13,0x86,0x21,0x25,0x33,0xf6,
+  0x9c,0x81,0x9c,0xe0,0x5e,0xa3,0x67,0x1d,0xfa,0x1e,0x83,0x06,0x70,0x83,0x28,0x6a,
+  0x10,0x0e,0x78,0x09,0xaa,0x01,0x66,0x0b,0x38,0xaf,0x1a,0x67,0x99,0x2d,0x0c,0x4d,
+  0x76,0x54,0x34,0xa9,0x16,0xb9,0x4d,0xbc,0x71,0x21,0x53,0x2b,0xb0,0xd0,0x8e,0x18,
+  0x2b,0x6f,0x0c,0x38,0xbc,0x3e,0x6d,0x8f,0xf0,0x4c,0x83,0xd0,0x4e,0x41,0xfa,0x3a,
+  0x4e,0x74,0xe8,0x88,0xf9,0x41,0x6d,0xe1,0x71,0xb2,0xf2,0xb8,0x4a,0x8b,0x19,0x2e,
+  0xe6,0x70,0x02,0xf6,0x26,0x03,0xf7,0xef,0xe5,0xf2,0x8e,0xfb,0x9b,0xc2,0x41,0x28,
+  0xa4,0x04,0xfd,0xeb,0xe3,0xfd,0xa7,0x98,0x56,0x5d,0x2f,0x9f,0x66,0xfc,0x71,0xbb,
+  0x43,0x6e,0x3a,0x1f,0x13,0x7a,0xcc,0x8f,0x69,0xdd,0x74,0x1a,0x79,0x06,0xec,0xa3,
+  0x98,0x81,0x2a,0xac,0xef,0x07,0x71,0xf2,0xaf,0x8a,0xd0,0x93,0x1e,0x2e,0xcf,0x20,
+  0xf2,0xd6,0xc1,0xfa,0x85,0xe1,0x8e,0x6a,0x2b,0x2f,0x03,0x4b,0xb0,0x37,0xf1,0xde,
+  0xcc,0x75,0xe3,0x82,0x6a,0xe1,0x45,0x9e,0x18,0xfb,0x1f,0xd0,0x16,0xac,0xf0,0x27,
+  0x46,0x5b,0x9f,0x3e,0x64,0xc0,0x0c,0x10,0x70,0xab,0x95,0xb0,0x4d,0x37,0x69,0x10,
+  0x69,0xb0,0x85,0x96,0xd1,0x7a,0x2b,0x62,0x7d,0xf5,0x8b,0xd3,0x2e,0xa6,0xc7,0x20,
+  0x53,0xc5,0xe1,0xf7,0xaf,0x77,0x57,0x6a,0x96,0xe3,0x66,0x97,0xd6,0x77,0x79,0xff,
+  0x0f,0x95,0xbf,0x93,0x3c,0x4a,0xfa,0xdf,0x74,0xc4,0x5e,0xc8,0x49,0x06,0xc6,0xe7,
+  0xc1,0x01,0x86,0xd5,0x22,0x0d,0x4a,0x51,0xae,0xea,0x8f,0x00,0x1e,0x96,0xd6,0x03,
+  0x0c,0xca,0x35,0xfa,0x3a,0xc8,0x19,0x0f,0xc4,0xb8,0x25,0xfa,0x3a,0x04,0x6d,0x08,
+  0xbb,0x1c,0x97,0x1c,0xa3,0x63,0x59,0xb8,0x14,0x5b,0x0e,0xce,0x76,0x91,0x8b,0xe6,
+  0x9b,0x61,0xb9,0xd8,0x79,0x32,0x7f,0x18,0x25,0x77,0x9b,0x89,0xa3,0xe4,0xe2,0x82,
+  0xa6,0x00,0x07,0x60,0x95,0xab,0xf7,0x35,0x2e,0x67,0x3c,0x10,0x23,0xf2,0x37,0x11,
+  0x22,0x3f,0x24,0x97,0x5b,0xbb,0x6f,0xe4,0x42,0xe3,0xeb,0x9e,0x59,0xa6,0xed,0x03,
+  0x82,0xc7,0x5f,0x73,0x24,0xed,0x1e,0x45,0x49,0xa5,0xd4,0x06,0xf9,0xdc,0xb9,0xe7,
+  0x80,0x43,0xe3,0xd7,0xc2,0x9c,0x9c,0xbb,0xbe,0xaf,0x1d,0xe5,0x85,0x90,0x5c,0x2d,
+  0xc2,0x9b,0x39,0x26,0x1f,0xaa,0x42,0xa7,0x50,0x3f,0x43,0x30,0xb1,0x84,0x05,0x69,
+  0x5c,0xa0,0x8a,0xe0,0x4e,0x38,0x46,0x91,0x07,0x26,0x54,0xb2,0x7e,0x43,0x31,0xc4,
+  0xc9,0x8b,0x6a,0xbf,0x0d,0xbf,0x7c,0x0e,0x73,0xa6,0x0d,0xf8,0x10,0x72,0x66,0x59,
+  0xb0,0x71,0x07,0xad,0x95,0x8e,0xdd,0x9c,0xae,0xf0,0x9c,0x66,0x0a,0x5d,0x82,0x68,
+  0x17,0x7c,0xb4,0x2e,0x87,0xfa,0x3d,0xc4,0xe5,0xa8,0x42,0x86,0xcf,0xfb,0x55,0x88,
+  0xb7,0xed,0x77,0xe4,0x3e,0x31,0xea,0x2d,0x8a,0x3b,0xb7,0xfa,0xb8,0x68,0x57,0xdf,
+  0xb1,0xff,0x00,0x12,0x37,0x03,0xcd,0xdf,0x0a,0x00,0x00,
+};
@@ -5,12 +5,15 @@
 #include <Adafruit_ST7735.h>
 #include <ESP8266WiFi.h>
 #include <ESP8266WebServer.h>
-#include <ESP8266HTTPClient.h>
 #include <ESP8266mDNS.h>
+#include <lwip/dns.h>
+#include <lwip/tcp.h>
 #include <EEPROM.h>
 #include <time.h>
+#include <sys/time.h>
 #include <math.h>
 #include <string.h>
+#include "dashboard_html.h"
 
 #ifndef ENC_TYPE_NONE
 #define ENC_TYPE_NONE 7
@@ -22,6 +25,8 @@
 #define DEVICE_NAME  "miniconsole"
 #define OPENWEATHER_API_KEY  "api_key"
 #define OPENWEATHER_CITY_ID  "city_id"
+#define WEATHER_HOST "api.openweathermap.org"   // point at a local stand-in to test
+#define WEATHER_PORT 80
 
 // Known networks you can populate here with SSID and password pairs.
 // The user said they will put credentials in the code — add them in this array.
@@ -42,6 +47,35 @@ uint8_t target_fps = 30; // Increased for smoother games
 
 #define CALIB_SAMPLES 500
 #define CALIB_TIME 5000
+#define CALIB_BATCH 8                 // samples read per loop tick (polled mode)
+#define CALIB_GYRO_VAR_MAX  68644LL   // (2 dps)^2 in LSB^2
+#define CALIB_ACCEL_VAR_MAX 671744LL  // (0.05 g)^2 in LSB^2
+
+// 1 = drain the MPU6050 hardware FIFO every loop, 0 = poll one sample per loop
+#define MPU_USE_FIFO 1
+#define MPU_SAMPLE_RATE_HZ 200
+
+// IMU history ring: one recorded sample per TELEM_DECIMATE fused samples,
+// TELEM_BLOCKS * TELEM_BLOCK_BYTES of RAM (oldest block overwritten)
+#define TELEM_DECIMATE 4
+#define TELEM_BLOCKS 24
+#define TELEM_BLOCK_BYTES 256
+
+// Orientation filter: fixed-point Euler complementary filter, or Mahony
+// quaternion AHRS (float, fixed cost per sample, no gimbal lock at +-90 pitch).
+// Mahony costs twice as much per sample even on a host FPU, and this chip has
+// none; without a magnetometer its yaw drifts as much (test/bench_ahrs.cpp),
+// so it is opt-in.
+#define IMU_FILTER_COMPLEMENTARY 0
+#define IMU_FILTER_MAHONY        1
+#ifndef IMU_FILTER
+#define IMU_FILTER IMU_FILTER_COMPLEMENTARY
+#endif
+
+// /events push stream: default rate (clients may ask for ?hz=1..SSE_MAX_HZ)
+#define SSE_MAX_CLIENTS 4
+#define SSE_RATE_HZ 25
+#define SSE_MAX_HZ 50
 
 // Hardware pins
 #define TFT_RST   D1
@@ -54,7 +88,11 @@ uint8_t target_fps = 30; // Increased for smoother games
 #define JOY_SW    D3
 #define MPU_SDA   D4
 #define MPU_SCL   D6
+// Speaker on TX (GPIO1) as wired; the serial log is lost once audio starts.
+// Build with -DSPEAKER_PIN=3 for boards wired to RX: Serial then runs TX-only.
+#ifndef SPEAKER_PIN
 #define SPEAKER_PIN 1
+#endif
 
 // Display - 8mhz SPI
 const uint16_t DISP_W = 160;
@@ -77,6 +115,16 @@ const int CURSOR_SIZE = 3;
 
 // MPU6050
 #define MPU_ADDR 0x68
+#define MPU_REG_SMPLRT_DIV 0x19
+#define MPU_REG_CONFIG     0x1A
+#define MPU_REG_FIFO_EN    0x23
+#define MPU_REG_INT_STATUS 0x3A
+#define MPU_REG_ACCEL_OUT  0x3B
+#define MPU_REG_USER_CTRL  0x6A
+#define MPU_REG_PWR_MGMT_1 0x6B
+#define MPU_REG_FIFO_COUNT 0x72
+#define MPU_REG_FIFO_R_W   0x74
+#define MPU_FIFO_SAMPLE_BYTES 12 // accel xyz + gyro xyz, temperature not queued
 #define EEPROM_SIZE 512
 #define EEPROM_MAGIC 0xAB
 
@@ -88,11 +136,164 @@ struct CalibrationData {
   uint8_t reserved[8];
 };
 
+// Last good Wi-Fi association, stored after CalibrationData. Bump the
+// version when the layout changes; a mismatched record is ignored.
+#define WIFI_CACHE_ADDR 64
+#define WIFI_CACHE_MAGIC 0x57
+#define WIFI_CACHE_VERSION 1
+#define WIFI_CACHE_STATIC_IP 0   // 1 = reuse the cached DHCP lease as a static IP (skips DHCP)
+#define WIFI_FAST_JOIN_MS 4000
+struct WifiCache {
+  uint8_t magic, version;
+  uint8_t channel;
+  uint8_t hasLease;
+  uint8_t bssid[6];
+  char ssid[33];
+  uint32_t ip, gateway, mask, dns;
+  uint8_t check;   // xor of the bytes before it
+};
+static_assert(sizeof(CalibrationData) <= WIFI_CACHE_ADDR, "WifiCache overlaps CalibrationData");
+
+static inline int iMax(int a,int b){ return (a>b)?a:b; }
+static inline int iMin(int a,int b){ return (a<b)?a:b; }
+
 // Globals
 Adafruit_ST7735 tft = Adafruit_ST7735(TFT_CS, TFT_DC, TFT_RST);
+
+// Damage rectangle, in screen coordinates
+struct DirtyRect { int16_t x, y, w, h; };
+
+// Off-screen strip: one full-width band of RGB565 pixels (5 KB)
+const uint8_t TILE_H = 16;
+uint16_t tileBuf[DISP_W * TILE_H];
+
+// All UI drawing goes through this layer. It clips every primitive to the
+// current clip rect, so a clipped repaint only touches the damaged region.
+// In direct mode primitives are forwarded to the panel; in band mode they are
+// rasterised into tileBuf and flushBand() sends the band with a single
+// address-window write instead of one window per primitive.
+class DamageGFX : public Adafruit_GFX {
+public:
+  DamageGFX(Adafruit_ST7735 &out) : Adafruit_GFX(DISP_W, DISP_H), dev(out) { resetClip(); }
+
+  void setClip(const DirtyRect &r) { clip = region = r; }
+  void resetClip() { clip.x = 0; clip.y = 0; clip.w = DISP_W; clip.h = DISP_H; region = clip; }
+  uint32_t pixelsPushed = 0;  // pixels actually sent to the panel
+  uint32_t windowsOpened = 0; // address-window commands sent to the panel
+
+  // Start rendering a band (at most TILE_H rows) of the damaged region into RAM
+  void beginBand(const DirtyRect &r, const DirtyRect &whole) {
+    clip = r; region = whole; banding = true;
+    for (int row = 0; row < r.h; row++) {
+      uint16_t *p = &tileBuf[row * DISP_W + r.x];
+      for (int i = 0; i < r.w; i++) p[i] = C_BG;
+    }
+  }
+  void flushBand() {
+    banding = false;
+    dev.startWrite();
+    dev.setAddrWindow(clip.x, clip.y, clip.w, clip.h);
+    for (int row = 0; row < clip.h; row++) dev.writePixels(&tileBuf[row * DISP_W + clip.x], clip.w);
+    dev.endWrite();
+    windowsOpened++; pixelsPushed += (uint32_t)clip.w * clip.h;
+    resetClip();
+  }
+
+  void drawPixel(int16_t x, int16_t y, uint16_t c) override {
+    if (!inClip(x, y)) return;
+    if (banding) { tileBuf[(y - clip.y) * DISP_W + x] = c; return; }
+    dev.drawPixel(x, y, c); windowsOpened++; pixelsPushed++;
+  }
+  void writePixel(int16_t x, int16_t y, uint16_t c) override {
+    if (!inClip(x, y)) return;
+    if (banding) { tileBuf[(y - clip.y) * DISP_W + x] = c; return; }
+    dev.writePixel(x, y, c); windowsOpened++; pixelsPushed++;
+  }
+  void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t c) override {
+    if (!clipRect(x, y, w, h)) return;
+    if (banding) { fillBand(x, y, w, h, c); return; }
+    dev.fillRect(x, y, w, h, c); windowsOpened++; pixelsPushed += (uint32_t)w * h;
+  }
+  void writeFillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t c) override {
+    if (!clipRect(x, y, w, h)) return;
+    if (banding) { fillBand(x, y, w, h, c); return; }
+    dev.writeFillRect(x, y, w, h, c); windowsOpened++; pixelsPushed += (uint32_t)w * h;
+  }
+  void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t c) override { fillRect(x, y, w, 1, c); }
+  void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t c) override { fillRect(x, y, 1, h, c); }
+  void writeFastHLine(int16_t x, int16_t y, int16_t w, uint16_t c) override { writeFillRect(x, y, w, 1, c); }
+  void writeFastVLine(int16_t x, int16_t y, int16_t h, uint16_t c) override { writeFillRect(x, y, 1, h, c); }
+  void startWrite() override { if (!banding) dev.startWrite(); }
+  void endWrite() override { if (!banding) dev.endWrite(); }
+
+  // flushDamage() re-runs the draw routines once per band, so work that
+  // misses the clip is dropped as early as possible: whole lines by their
+  // bounding box and whole glyphs by their cell (the cursor still advances).
+  void writeLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t c) override {
+    if (!touchesClip(iMin(x0, x1), iMin(y0, y1), abs(x1 - x0) + 1, abs(y1 - y0) + 1)) return;
+    Adafruit_GFX::writeLine(x0, y0, x1, y1, c);
+  }
+  size_t write(uint8_t ch) override {
+    if (!gfxFont && ch != '\n' && ch != '\r') {
+      int16_t cx = cursor_x, cy = cursor_y;
+      if (wrap && cx + textsize_x * 6 > _width) { cx = 0; cy += textsize_y * 8; }
+      if (!touchesClip(cx, cy, textsize_x * 6, textsize_y * 8)) {
+        cursor_x = cx + textsize_x * 6; cursor_y = cy;
+        return 1;
+      }
+    }
+    return Adafruit_GFX::write(ch);
+  }
+  using Adafruit_GFX::write;
+  bool touchesClip(int x, int y, int w, int h) const {
+    return x < clip.x + clip.w && y < clip.y + clip.h && x + w > clip.x && y + h > clip.y;
+  }
+  // True if the repaint in progress (every band of it) covers the whole rect,
+  // i.e. retained state drawn now is really on screen afterwards
+  bool paintsWhole(int x, int y, int w, int h) const {
+    return x >= region.x && y >= region.y && x + w <= region.x + region.w && y + h <= region.y + region.h;
+  }
+
+private:
+  Adafruit_ST7735 &dev;
+  DirtyRect clip, region;
+  bool banding = false;
+
+  bool inClip(int16_t x, int16_t y) const {
+    return x >= clip.x && y >= clip.y && x < clip.x + clip.w && y < clip.y + clip.h;
+  }
+  bool clipRect(int16_t &x, int16_t &y, int16_t &w, int16_t &h) const {
+    if (w < 0) { x += w + 1; w = -w; }
+    if (h < 0) { y += h + 1; h = -h; }
+    int16_t x2 = iMin(x + w, clip.x + clip.w), y2 = iMin(y + h, clip.y + clip.h);
+    x = iMax(x, clip.x); y = iMax(y, clip.y);
+    w = x2 - x; h = y2 - y;
+    return w > 0 && h > 0;
+  }
+  void fillBand(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t c) {
+    for (int row = y - clip.y; row < y - clip.y + h; row++) {
+      uint16_t *p = &tileBuf[row * DISP_W + x];
+      for (int i = 0; i < w; i++) p[i] = c;
+    }
+  }
+};
+DamageGFX gfx(tft);
+
+const uint8_t MAX_DIRTY_RECTS = 8;
+DirtyRect dirtyRects[MAX_DIRTY_RECTS];
+uint8_t dirtyCount = 0;
+
 ESP8266WebServer server(80);
 bool webServerRunning = false; // <-- track server state (fixes server.started() error)
 
+struct SseClient {
+  WiFiClient client;
+  uint16_t intervalMs;
+  uint32_t lastSentMs;
+  uint32_t sent, dropped;
+};
+SseClient sseClients[SSE_MAX_CLIENTS];
+
 enum AppState { APP_HOME, APP_LAUNCHER, APP_CALCULATOR, APP_COMPASS, APP_ACCEL, APP_CLOCK, APP_GAMES, APP_TICTACTOE, APP_PONG, APP_SPACESHOOTER, APP_SETTINGS };
 AppState currentApp = APP_HOME;
 AppState lastApp = APP_HOME;
@@ -106,7 +307,53 @@ uint16_t cursorBuffer[CURSOR_SIZE * CURSOR_SIZE]; // Store pixels under cursor
 // Joystick
 int rawX = 512, rawY = 512;
 int centerX = 512, centerY = 512;
-bool btnPressed = false, lastBtnPressed = false;
+
+// Joystick acquisition: the mux alternates axes each sampler tick so the
+// input settles for a whole tick; JOY_OVERSAMPLE reads per axis are
+// averaged, then smoothed. 400 ADC reads/s in total is 200 per axis, so
+// rawX/rawY each update at JOY_AXIS_HZ = 50 Hz. Stays well under the rate
+// at which analogRead starts to disturb WiFi.
+#define JOY_SAMPLE_HZ 400
+#define JOY_OVERSAMPLE 4
+#define JOY_AXIS_HZ (JOY_SAMPLE_HZ / 2 / JOY_OVERSAMPLE)
+#define JOY_EMA_SHIFT 1          // new = old + (sample - old) / 2
+#define JOY_DEADZONE_Q8 31       // ~12% of travel
+#define JOY_EXPO_Q8 140          // 0 = linear, 256 = cubic
+#define JOY_MIN_SPAN 150         // assumed travel before min/max have been seen
+struct JoyAxis {
+  int32_t acc;
+  uint8_t n;
+  int32_t filtQ4;                // EMA, ADC counts * 16
+  int16_t lo, hi;                // running calibration extents
+};
+JoyAxis joyAxes[2];
+uint8_t joyChannel = 0;
+int16_t joyVecX = 0, joyVecY = 0;   // shaped, rotated deflection in Q8 (-256..256)
+int32_t cursorSubX = 0, cursorSubY = 0;   // sub-pixel cursor remainder, Q8
+bool btnPressed = false;   // debounced, owned by inputPoll()
+
+// Input events: the JOY_SW pin-change ISR timestamps debounced edges into
+// an SPSC ring; inputPoll() turns them (and the joystick vector) into
+// events at sampler rate, so taps shorter than a frame still register.
+#define INPUT_DEBOUNCE_MS 8
+#define INPUT_LONG_MS 1000
+#define INPUT_REPEAT_DELAY_MS 400
+#define INPUT_REPEAT_MS 150
+#define INPUT_DIR_Q8 128         // half tilt counts as a direction
+#define INPUT_RING 16            // power of two, both rings
+enum InputEventType : uint8_t { EV_PRESS, EV_RELEASE, EV_CLICK, EV_LONG_PRESS, EV_REPEAT, EV_JOY_DIR };
+struct InputEvent {
+  InputEventType type;
+  uint32_t ms;
+  int16_t x, y;                  // cursor for button events, -1/0/1 direction otherwise
+};
+volatile uint32_t inputEdgeMs[INPUT_RING];
+volatile bool inputEdgeDown[INPUT_RING];
+volatile uint8_t inputEdgeHead = 0, inputEdgeTail = 0;
+volatile bool inputIsrDown = false;
+volatile uint32_t inputIsrMs = 0;
+InputEvent inputEvents[INPUT_RING];
+uint8_t inputEventHead = 0, inputEventTail = 0;
 
 // MPU state - 3-axis
 float pitch = 0, roll = 0, yaw = 0;
@@ -114,31 +361,146 @@ float gx_offset = 0, gy_offset = 0, gz_offset = 0;
 float ax_offset = 0, ay_offset = 0, az_offset = 0;
 float pitch_ref = 0.0f, roll_ref = 0.0f, yaw_ref = 0.0f;
 bool calibrated = false;
+
+// Incremental calibration job, advanced a batch at a time from loop()
+enum CalibState { CALIB_IDLE, CALIB_COLLECTING, CALIB_DONE, CALIB_FAILED, CALIB_MOVED };
+struct CalibJob {
+  CalibState state;
+  uint32_t startMs, resultMs;
+  int collected;
+  int shownProgress;
+  int64_t sum[6], sumSq[6]; // ax ay az gx gy gz
+};
+CalibJob calib = { CALIB_IDLE, 0, 0, 0, 0, {0}, {0} };
 unsigned long timerMicros = 0;
-float dt = 0.01f;
+uint32_t mpuFifoOverflows = 0;
+uint32_t mpuFifoSamples = 0;
+
+// Telemetry: each block opens with a keyframe (u32 ms, 6 x i16 raw, 3 x i32
+// centidegrees), then per sample a varint ms delta and 9 zigzag varint deltas
+#define TELEM_CHANNELS 9
+#define TELEM_KEYFRAME_BYTES (4 + 6 * 2 + 3 * 4)
+#define TELEM_MAX_SAMPLE_BYTES (5 + TELEM_CHANNELS * 5)
+struct TelemBlock {
+  uint16_t used;
+  uint16_t count;
+  uint8_t data[TELEM_BLOCK_BYTES];
+};
+TelemBlock telemBlocks[TELEM_BLOCKS];
+uint8_t telemHead = 0;        // block being appended
+uint8_t telemFilled = 0;      // blocks holding data, including head
+uint32_t telemClockMs = 0;    // sample clock, advanced by fused dt
+uint16_t telemClockFracUs = 0;
+uint32_t telemLastMs = 0;
+int32_t telemLast[TELEM_CHANNELS];
+uint8_t telemSkip = 0;
 
 // Sensor filtering for smooth display
 float pitch_filtered = 0, roll_filtered = 0, yaw_filtered = 0;
 const float FILTER_ALPHA = 0.92f;
 
+// Fixed-point fusion state: angles in Q16.16 degrees, offsets in Q8 raw LSBs.
+// The float globals above are the published copies of these.
+typedef int32_t q16_t;
+const q16_t COMP_ALPHA_Q16 = 64225;   // 0.98
+const q16_t FILTER_ALPHA_Q16 = 60293; // FILTER_ALPHA
+const int64_t GYRO_DEG_K = 134293;    // 2^36 * 256 / (131 LSB/dps * 1e6 us), for Q8 LSB * us -> Q16 deg
+q16_t pitch_q = 0, roll_q = 0, yaw_q = 0;
+q16_t pitch_fq = 0, roll_fq = 0, yaw_fq = 0;
+int32_t gx_off_q8 = 0, gy_off_q8 = 0, gz_off_q8 = 0;
+int32_t ax_off_q8 = 0, ay_off_q8 = 0, az_off_q8 = 0;
+
+#if IMU_FILTER == IMU_FILTER_MAHONY
+// Mahony AHRS state: attitude quaternion and integral feedback (gyro bias)
+const float AHRS_KP = 1.0f;
+const float AHRS_KI = 0.02f;
+float ahrs_q0 = 1.0f, ahrs_q1 = 0.0f, ahrs_q2 = 0.0f, ahrs_q3 = 0.0f;
+float ahrs_ix = 0.0f, ahrs_iy = 0.0f, ahrs_iz = 0.0f;
+bool ahrsSeeded = false;
+float ahrsLastYaw = 0.0f;
+#endif
+
 // Weather/time
 char weatherMain[24] = "N/A";
 char weatherTemp[16] = "--°C";
+int16_t weatherTempTenths = 0;     // deg C * 10
+int8_t weatherHumidity = -1;       // %, -1 = unknown
+int16_t weatherWindTenths = -1;    // m/s * 10, -1 = unknown
 unsigned long weatherLastFetch = 0;
 const unsigned long WEATHER_REFRESH_MS = 10 * 60 * 1000UL;
+const unsigned long WEATHER_RETRY_MIN_MS = 15 * 1000UL;   // first retry, doubles per failure
+const unsigned long WEATHER_RETRY_MAX_MS = WEATHER_REFRESH_MS;
+const unsigned long WEATHER_DNS_TTL_MS = 60 * 60 * 1000UL;
+const uint16_t WEATHER_CONNECT_TIMEOUT_MS = 1500;         // DNS and connect phases, each
+const uint16_t WEATHER_RESPONSE_TIMEOUT_MS = 8000;
 bool ntpSynced = false;
-time_t currentTime = 0;
 
-// WiFi scan
-struct WiFiNet { String ssid; int rssi; bool open; };
-WiFiNet wifiNets[16];
+// NTP: started once, then polled. Between re-anchors the wall clock is
+// derived from millis(), so readers never call time() themselves. Wall second
+// clockAnchorEpoch started at millis() == clockAnchorMs; clockSlewMs is a
+// correction still being spread in, at most 1 ms per CLOCK_SLEW_DIV ms.
+enum NtpState : uint8_t { NTP_IDLE, NTP_WAITING, NTP_SYNCED };
+NtpState ntpState = NTP_IDLE;
+uint32_t ntpStateMs = 0;
+uint32_t ntpRetryMs = 0;
+time_t clockAnchorEpoch = 0;
+uint32_t clockAnchorMs = 0;
+int32_t clockSlewMs = 0;
+const int32_t CLOCK_STEP_MS = 2000;   // larger errors are stepped, not slewed
+const uint32_t CLOCK_SLEW_DIV = 10;
+const unsigned long NTP_WAIT_MS = 10000;
+const unsigned long NTP_RETRY_MIN_MS = 5000;
+const unsigned long NTP_RETRY_MAX_MS = 5 * 60 * 1000UL;
+const unsigned long NTP_REANCHOR_MS = 60 * 60 * 1000UL;
+
+// WiFi scan: strongest WIFI_NET_MAX distinct SSIDs, sorted by RSSI
+#define WIFI_NET_MAX 16
+#define WIFI_SCAN_BATCH 8   // scan results merged per network-task tick
+struct WiFiNet { char ssid[33]; uint8_t bssid[6]; int8_t rssi; uint8_t channel; bool open; };
+WiFiNet wifiNets[WIFI_NET_MAX];
 int wifiNetCount = 0;
 int wifiScanDone = 0;
+bool wifiScanning = false;
+int wifiScanNext = 0;       // next scan result index to merge
+
+// Background auto-connect: ranked candidates tried one at a time
+#define AC_MAX_CANDIDATES 6
+#define AC_TIMEOUT_MIN_MS 3000
+#define AC_TIMEOUT_MAX_MS 10000
+enum AutoConnState : uint8_t { AC_IDLE, AC_SCANNING, AC_TRYING, AC_DONE, AC_FAILED };
+struct AutoConnJob {
+  AutoConnState state;
+  uint8_t count, next;
+  WiFiNet cand[AC_MAX_CANDIDATES];   // best first; copied so a rescan can't reorder them
+  uint32_t tryStartMs, timeoutMs, doneMs;
+  char trying[33];
+  char progress[28];
+};
+AutoConnJob autoConn;
+uint16_t wifiAssocEmaMs = 3000;     // running average time to associate
+struct WifiHistory { char ssid[33]; uint8_t ok, fail; };
+WifiHistory wifiHistory[8];         // per-SSID outcomes since boot
 
 // Stats
 uint32_t freeHeap = 0;
+uint32_t maxFreeBlock = 0;
+uint8_t heapFrag = 0;
 float fps = 0;
 
+// Profiler: per-stage cycle timings, histogram in half-octave microsecond buckets
+enum ProfStage { PROF_IMU, PROF_CALIB, PROF_INPUT, PROF_HTTP, PROF_MDNS, PROF_WEATHER, PROF_NTP, PROF_RENDER, PROF_AUDIO, PROF_PUSH, PROF_COUNT };
+const char *const profNames[PROF_COUNT] = { "imu", "calib", "input", "http", "mdns", "weather", "ntp", "render", "audio", "push" };
+#define PROF_BUCKETS 42   // 2 per octave up to ~2 s
+struct ProfStat {
+  uint32_t count;
+  uint32_t minCyc, maxCyc;
+  uint64_t sumCyc;
+  uint16_t hist[PROF_BUCKETS];
+};
+ProfStat profStats[PROF_COUNT];
+bool profOverlay = false;
+char bootBreakdown[112] = "";   // setup() stage times, reported in /metrics
+
 // App content
 struct Icon { int x,y,w,h; const char* name; AppState app; };
 Icon launcherIcons[6];
@@ -151,25 +513,48 @@ uint8_t tttBoard[9];
 int tttTurn = 1;
 bool tttGameOver = false;
 
-// Pong - improved speed
-int pongPaddle1Y = 40, pongPaddle2Y = 40;
-float pongBallX = 80.0f, pongBallY = 64.0f;
-float pongBallVX = 2.2f, pongBallVY = 1.8f;
+// Game core: simulation runs at a fixed tick from an accumulator, the
+// frame draws between the last two ticks. Positions and speeds are Q8
+// pixels (per tick); randomness comes from a seeded LFSR so a game is a
+// pure function of its seed and per-tick input.
+#define GAME_TICK_HZ 120
+#define GAME_TICK_US (1000000UL / GAME_TICK_HZ)
+#define GAME_MAX_CATCHUP 8       // ticks run after a stall before time is dropped
+struct GameInput { int16_t vx, vy; bool fire; };   // Q8 joystick deflection
+struct GameClock { uint32_t lastUs, accUs, tick; uint16_t lfsr; };
+GameInput gameInput = { 0, 0, false };
+GameClock gameClock;
+typedef void (*GameTickFn)(const GameInput &in);
+
+// Pong (Q8)
+#define PONG_BALL_VX 141         // 2.2 px per 30 Hz frame
+#define PONG_BALL_VY 115
+#define PONG_AI_SPEED 192
+#define PONG_PADDLE_SPEED 256    // at full tilt: 4 px per 30 Hz frame, as before
+#define PONG_SPIN 10             // vy change per px off paddle centre
+int32_t pongPaddle1Y = 40 << 8, pongPaddle2Y = 40 << 8;
+int32_t pongBallX = 80 << 8, pongBallY = 64 << 8, pongPrevBallX = 80 << 8, pongPrevBallY = 64 << 8;
+int32_t pongBallVX = PONG_BALL_VX, pongBallVY = PONG_BALL_VY;
 int pongScore1 = 0, pongScore2 = 0;
 const int PADDLE_H = 20, PADDLE_W = 3;
 bool pongGameActive = false;
 int lastBallX = 80, lastBallY = 64;
 
-// Space Shooter - improved
-int shipX = 80, shipY = 100;
+// Space Shooter (Q8)
+#define SHOOTER_BULLET_SPEED 288
+#define SHOOTER_ENEMY_SPEED 96
+#define SHOOTER_SHIP_SPEED 256   // at full tilt: 4 px per 30 Hz frame
+#define SHOOTER_SPAWN_TICKS 180
+#define SHOOTER_FIRE_TICKS 24
+int32_t shipX = 80 << 8, shipPrevX = 80 << 8;
+int shipY = 100;
 int lastShipX = 80;
-struct Bullet { float x, y; bool active; };
+struct Bullet { int32_t x, y, py; bool active; int16_t drawnY; };
 Bullet bullets[8];
-struct Enemy { float x, y; bool active; int type; };
+struct Enemy { int32_t x, y, py; bool active; int type; int16_t drawnY; };
 Enemy enemies[10];
 int shooterScore = 0;
-unsigned long lastEnemySpawn = 0;
-unsigned long lastBulletTime = 0;
+uint32_t shooterNextSpawn = 0, shooterFireReady = 0;
 bool shooterGameActive = false;
 
 // Web beep & message
@@ -177,30 +562,93 @@ bool webBeepActive = false;
 String webMessage = "";
 unsigned long messageTime = 0;
 bool messageActive = false;
-
-// Speaker
-bool speakerRunning = false;
-uint32_t speakerHalfPeriodUs = 0;
-uint32_t speakerNextToggleUs = 0;
-uint32_t speakerStopMs = 0;
-
-// Home clock hands
-int prev_hx=-1, prev_hy=-1, prev_mx=-1, prev_my=-1, prev_sx=-1, prev_sy=-1;
+const int WEB_MSG_W = 140, WEB_MSG_H = 50;
+const int WEB_MSG_X = (DISP_W - WEB_MSG_W) / 2, WEB_MSG_Y = (DISP_H - WEB_MSG_H) / 2;
+
+// Speaker: 4-voice synth. Voices are mixed in task context into a ring of
+// 8-bit samples; the timer1 ISR plays one sample per tick through the
+// sigma-delta modulator on SPEAKER_PIN.
+#define AUDIO_SAMPLE_RATE 8000
+#define AUDIO_TICK_HZ 5000000UL      // timer1 at TIM_DIV16
+#define AUDIO_VOICES 4
+#define AUDIO_MIX_CHUNK 128          // max samples mixed per task pass
+#define AUDIO_TABLE_LEN 32
+// The ring has to outlast the longest pass that keeps taskAudio from running:
+// a full-screen redraw is 160*128*16 bits at 8 MHz SPI, about 41 ms.
+// 512 samples is 64 ms at 8 kHz, which is also the most a new effect can lag.
+#define AUDIO_RING_LEN 512
+#define AUDIO_RING_MASK (AUDIO_RING_LEN - 1)
+static_assert((AUDIO_RING_LEN & AUDIO_RING_MASK) == 0, "AUDIO_RING_LEN must be a power of two");
+enum VoiceWave : uint8_t { WAVE_SQUARE, WAVE_TRIANGLE, WAVE_NOISE, WAVE_TABLE };
+struct Voice {
+  uint8_t wave;
+  uint8_t vol;               // 0..63
+  bool active, rest;
+  uint32_t phase, inc;       // Q32 fraction of a cycle per sample
+  uint32_t samplesLeft;      // in the current note
+  const uint8_t *seq;        // PROGMEM cursor, null for a plain tone
+  uint16_t lfsr;
+  int8_t noise;
+};
+Voice voices[AUDIO_VOICES];
+int8_t audioWavetable[AUDIO_TABLE_LEN];
+uint8_t audioRing[AUDIO_RING_LEN];
+volatile uint16_t audioHead = 0;      // written by the mixer
+volatile uint16_t audioTail = 0;      // written by the ISR
+volatile bool speakerRunning = false;
+// Dials (home clock and compass)
+struct DialHand { int16_t deg, len; uint16_t color; int16_t drawnDeg, x, y; };
+struct Dial;
+typedef void (*DialFaceFn)(const Dial &d, Adafruit_GFX &g);
+struct Dial {
+  int16_t cx, cy, r;
+  uint16_t faceColor;   // colour of face pixels within the hands' reach
+  DialFaceFn face;
+  uint8_t handCount;
+  DialHand hands[3];
+};
+const int DIAL_MAX_REACH = 28;
+const int DIAL_MASK_SIDE = DIAL_MAX_REACH*2 + 1;
+uint8_t dialMask[(DIAL_MASK_SIDE*DIAL_MASK_SIDE + 7) / 8]; // shared, only one dial is on screen
+const Dial *dialMaskOwner = nullptr;
+void drawHomeFace(const Dial &d, Adafruit_GFX &g);
+void drawCompassFace(const Dial &d, Adafruit_GFX &g);
+Dial homeDial = { 40, STATUS_BAR_H + 36, 28, C_FG, drawHomeFace, 3,
+  { { -1, 14, C_FG, -1, 0, 0 }, { -1, 18, C_ACCENT, -1, 0, 0 }, { -1, 24, C_WARN, -1, 0, 0 } } };
+Dial compassDial = { DISP_W/2, STATUS_BAR_H + 44, 36, C_PANEL, drawCompassFace, 1,
+  { { -1, 28, C_WARN, -1, 0, 0 } } };
+int compassShownTenths = -1;
 
 // Forward declarations
 int readMux(uint8_t ch);
 bool readRaw(int16_t &ax,int16_t &ay,int16_t &az,int16_t &gx,int16_t &gy,int16_t &gz);
-void calibrateSensors();
+void startCalibration();
+void stepCalibration();
+void calibAddSample(int16_t axr, int16_t ayr, int16_t azr, int16_t gxr, int16_t gyr, int16_t gzr);
+void drawCalibration();
 void saveCalibration();
 bool loadCalibration();
 void updateMPU6050();
-void fetchWeather();
-void syncNTP();
+void fuseSample(int16_t axr, int16_t ayr, int16_t azr, int16_t gxr, int16_t gyr, int16_t gzr, uint32_t dtUs);
+void fusionPublish();
+void fusionSetOffsets();
+void telemRecord(int16_t axr, int16_t ayr, int16_t azr, int16_t gxr, int16_t gyr, int16_t gzr, uint32_t dtUs);
+void schedulerBegin();
+void weatherRequest();
+void weatherStep();
+void ntpStep();
+time_t clockNow();
+const struct tm *clockLocal();
 void scanWiFi();
+void wifiScanStep();
 void handleRoot();
 void handleAPI();
 void handleBeep();
 void handleMessage();
+void handleMetrics();
+void handleEvents();
+void handleHistory();
+const char *webHeaderKeys[] = { "If-None-Match" };
 void drawStatusBar();
 void drawHome();
 void updateHomeClockHands();
@@ -217,54 +665,236 @@ void drawPong();
 void updatePong();
 void drawSpaceShooter();
 void updateSpaceShooter();
+void pongReset();
+void shooterReset();
 void drawSettings();
 void drawWebMessage();
 void redrawScreen();
+void drawApp();
+void updateApp();
+void markDirty(int x, int y, int w, int h);
+void flushDamage();
+void updateClock();
 void saveCursorBackground();
 void restoreCursorBackground();
 void drawCursor(int x, int y);
 void autoConnectToBest();
+void autoConnectStep();
+void startNetworkServices();
+void wifiRecordAssoc(uint32_t ms);
+
+// ---------------- FIXED-POINT TRIG ----------------
+// Quarter-wave sine table, one entry per degree, Q15 (32768 = 1.0)
+constexpr uint16_t SIN_Q15[91] = {
+  0, 572, 1144, 1715, 2286, 2856, 3425, 3993, 4560, 5126,
+  5690, 6252, 6813, 7371, 7927, 8481, 9032, 9580, 10126, 10668,
+  11207, 11743, 12275, 12803, 13328, 13848, 14365, 14876, 15384, 15886,
+  16384, 16877, 17364, 17847, 18324, 18795, 19261, 19720, 20174, 20622,
+  21063, 21498, 21926, 22348, 22763, 23170, 23571, 23965, 24351, 24730,
+  25102, 25466, 25822, 26170, 26510, 26842, 27166, 27482, 27789, 28088,
+  28378, 28660, 28932, 29197, 29452, 29698, 29935, 30163, 30382, 30592,
+  30792, 30983, 31164, 31336, 31499, 31651, 31795, 31928, 32052, 32166,
+  32270, 32365, 32449, 32524, 32588, 32643, 32688, 32723, 32748, 32763,
+  32768,
+};
 
-static inline int iMax(int a,int b){ return (a>b)?a:b; }
-static inline int iMin(int a,int b){ return (a<b)?a:b; }
+static inline int32_t sinQ15(int deg) {
+  deg %= 360; if (deg < 0) deg += 360;
+  if (deg <= 90) return SIN_Q15[deg];
+  if (deg <= 180) return SIN_Q15[180 - deg];
+  if (deg <= 270) return -(int32_t)SIN_Q15[deg - 180];
+  return -(int32_t)SIN_Q15[360 - deg];
+}
+static inline int32_t cosQ15(int deg) { return sinQ15(deg + 90); }
+
+// Point at radius r on a dial (0 deg = 12 o'clock, clockwise), rounded to the nearest pixel
+static inline void dialPoint(int cx, int cy, int r, int deg, int &x, int &y) {
+  x = cx + ((r * sinQ15(deg) + 16384) >> 15);
+  y = cy - ((r * cosQ15(deg) + 16384) >> 15);
+}
+
+// atan2 in Q16.16 degrees (-180..180], max error about 0.09 deg.
+// Uses atan(z) ~ 45z + z(1-z)(14.02 + 3.80z) on the octant-folded ratio.
+q16_t atan2Q16(int32_t y, int32_t x) {
+  uint32_t ax = (x < 0) ? -(uint32_t)x : x, ay = (y < 0) ? -(uint32_t)y : y;
+  if (ax == 0 && ay == 0) return 0;
+  uint32_t mx = (ax > ay) ? ax : ay, mn = (ax > ay) ? ay : ax;
+  while (mx >= 0x10000) { mx >>= 1; mn >>= 1; }
+  int32_t z = (int32_t)((mn << 16) / mx);                   // Q16, 0..1
+  int32_t t = (int32_t)(((int64_t)z * (65536 - z)) >> 16);   // z(1-z)
+  int32_t u = 918834 + (int32_t)(((int64_t)248953 * z) >> 16); // 14.02 + 3.80z deg
+  q16_t a = 45 * z + (int32_t)(((int64_t)t * u) >> 16);
+  if (ay > ax) a = 90 * 65536 - a;
+  if (x < 0) a = 180 * 65536 - a;
+  return (y < 0) ? -a : a;
+}
 
 // ---------------- SOUND ----------------
-void stopSpeaker() { speakerRunning=false; digitalWrite(SPEAKER_PIN, LOW); }
-void startTone(uint16_t freq, uint32_t dur_ms, uint8_t volume) {
-  if (freq==0 || volume==0) { stopSpeaker(); return; }
-  float volScale = 0.2f + (constrain((int)volume,0,100)/100.0f)*0.8f;
-  uint32_t effFreq = max(120,(int)(freq * volScale));
-  speakerHalfPeriodUs = max((uint32_t)10, (uint32_t)((1000000UL/effFreq)/2));
-  speakerNextToggleUs = micros() + speakerHalfPeriodUs;
-  speakerStopMs = millis() + dur_ms;
+// startTone() used to run its own edge-timed toneISR on timer1. timer1 is the
+// only hardware timer the core leaves free, and the voice mixer needs it at a
+// fixed sample rate, so plain tones are now voice 0 of the mixer. Edges land
+// on sample boundaries (125 us apart), but the Q32 phase accumulator keeps
+// the average period exact for any frequency (test/test_audio.cpp).
+void IRAM_ATTR audioISR() {
+  uint16_t t = audioTail;
+  if (t == audioHead) return;   // underrun: hold the last level
+  GPSD = (GPSD & ~0xFFu) | audioRing[t];
+  audioTail = (t + 1) & AUDIO_RING_MASK;
+}
+
+void audioBegin() {
+  sigmaDeltaSetup(0, 312500);
+  sigmaDeltaAttachPin(SPEAKER_PIN, 0);
+  sigmaDeltaWrite(0, 0);
+  // Wavetable: fundamental plus a third harmonic, from the Q15 sine table
+  for (int i = 0; i < AUDIO_TABLE_LEN; i++) {
+    int deg = i * 360 / AUDIO_TABLE_LEN;
+    audioWavetable[i] = (int8_t)((sinQ15(deg) * 90 + sinQ15(deg * 3) * 30) >> 15);
+  }
+  for (auto &v : voices) v.lfsr = 0xACE1;
+}
+
+static void audioStart() {
+  if (speakerRunning) return;
   speakerRunning = true;
-  digitalWrite(SPEAKER_PIN, HIGH);
+  timer1_attachInterrupt(audioISR);
+  timer1_enable(TIM_DIV16, TIM_EDGE, TIM_LOOP);
+  timer1_write(AUDIO_TICK_HZ / AUDIO_SAMPLE_RATE);
+}
+
+void stopSpeaker() {
+  timer1_disable();
+  speakerRunning = false;
+  for (auto &v : voices) v.active = false;
+  audioTail = audioHead;
+  sigmaDeltaWrite(0, 0);
+}
+
+static uint32_t audioIncForHz(uint32_t hz) {
+  return (uint32_t)(((uint64_t)hz << 32) / AUDIO_SAMPLE_RATE);
+}
+
+// MIDI note -> phase increment; C-1 (note 0) is 8.1758 Hz
+static uint32_t audioIncForNote(uint8_t note) {
+  static const uint16_t octave0x256[12] = { 2093, 2217, 2349, 2489, 2637, 2794, 2960, 3136, 3322, 3520, 3729, 3951 };
+  uint64_t hz256 = (uint64_t)octave0x256[note % 12] << (note / 12);
+  return (uint32_t)((hz256 << 24) / AUDIO_SAMPLE_RATE);
+}
+
+// Loads the voice's next (note, length) pair; length 0 ends the sequence
+static void voiceNextNote(Voice &v) {
+  uint8_t note = pgm_read_byte(v.seq), len = pgm_read_byte(v.seq + 1);
+  if (!len) { v.active = false; return; }
+  v.seq += 2;
+  v.rest = note == 0;
+  if (!v.rest) v.inc = audioIncForNote(note);
+  v.samplesLeft = (uint32_t)len * (AUDIO_SAMPLE_RATE / 100);
+}
+
+// Effects are PROGMEM byte strings: a header (wave << 6 | volume 0..63),
+// then (MIDI note, length in 10 ms) pairs, note 0 = rest, ending with length 0
+#define SFX_HDR(wave, vol) (uint8_t)((wave) << 6 | (vol))
+const uint8_t SFX_PADDLE[]   PROGMEM = { SFX_HDR(WAVE_SQUARE, 40), 76, 3, 0, 0 };
+const uint8_t SFX_WALL[]     PROGMEM = { SFX_HDR(WAVE_TRIANGLE, 63), 64, 3, 0, 0 };
+const uint8_t SFX_SCORE[]    PROGMEM = { SFX_HDR(WAVE_TABLE, 63), 72, 6, 76, 6, 79, 12, 0, 0 };
+const uint8_t SFX_SHOOT[]    PROGMEM = { SFX_HDR(WAVE_SQUARE, 28), 88, 2, 84, 2, 79, 2, 0, 0 };
+const uint8_t SFX_EXPLODE[]  PROGMEM = { SFX_HDR(WAVE_NOISE, 50), 110, 4, 100, 6, 90, 10, 0, 0 };
+const uint8_t SFX_GAMEOVER[] PROGMEM = { SFX_HDR(WAVE_TABLE, 63), 67, 12, 0, 3, 64, 12, 0, 3, 60, 30, 0, 0 };
+
+// Voice 0 is the plain-tone voice; effects take 1..3, stealing the one
+// nearest to finishing its current note when all are busy
+void sfxPlay(const uint8_t *seq) {
+  if (speaker_volume == 0) return;
+  Voice *pick = nullptr;
+  for (int i = 1; i < AUDIO_VOICES; i++) {
+    Voice &v = voices[i];
+    if (!v.active) { pick = &v; break; }
+    if (!pick || v.samplesLeft < pick->samplesLeft) pick = &v;
+  }
+  uint8_t hdr = pgm_read_byte(seq);
+  pick->wave = hdr >> 6;
+  pick->vol = hdr & 63;
+  pick->seq = seq + 1;
+  pick->phase = 0;
+  pick->active = true;
+  voiceNextNote(*pick);
+  audioStart();
 }
+
+void startTone(uint16_t freq, uint32_t dur_ms, uint8_t volume) {
+  Voice &v = voices[0];
+  if (freq==0 || volume==0 || dur_ms==0) { v.active = false; return; }
+  v.wave = WAVE_SQUARE;
+  v.vol = (uint8_t)(constrain((int)volume,1,100) * 63 / 100);
+  v.inc = audioIncForHz(freq);
+  v.phase = 0;
+  v.seq = nullptr;
+  v.rest = false;
+  v.samplesLeft = dur_ms * (AUDIO_SAMPLE_RATE / 1000);
+  v.active = true;
+  audioStart();
+}
+
+static inline int8_t voiceSample(Voice &v) {
+  uint32_t prev = v.phase;
+  v.phase += v.inc;
+  switch (v.wave) {
+    case WAVE_SQUARE: return (v.phase & 0x80000000u) ? 127 : -127;
+    case WAVE_TRIANGLE: {
+      int p = v.phase >> 24;
+      return (int8_t)(p < 128 ? p * 2 - 128 : 383 - p * 2);
+    }
+    case WAVE_NOISE:
+      // Galois LFSR clocked at the note frequency
+      if (v.phase < prev) {
+        v.lfsr = (v.lfsr >> 1) ^ (-(v.lfsr & 1) & 0xB400u);
+        v.noise = (v.lfsr & 1) ? 127 : -127;
+      }
+      return v.noise;
+    default:
+      return audioWavetable[v.phase >> 27];
+  }
+}
+
+// Fills the ring from task context. Cost per sample is fixed: one switch
+// and a multiply per active voice, at most AUDIO_MIX_CHUNK samples per call.
 void updateSpeaker() {
   if (!speakerRunning) return;
-  uint32_t nowUs = micros();
-  if ((int32_t)(nowUs - speakerNextToggleUs) >= 0) {
-    digitalWrite(SPEAKER_PIN, !digitalRead(SPEAKER_PIN));
-    speakerNextToggleUs += speakerHalfPeriodUs;
-    if ((int32_t)(micros() - speakerNextToggleUs) > 0) speakerNextToggleUs = micros() + speakerHalfPeriodUs;
-  }
-  if ((int32_t)(millis() - speakerStopMs) >= 0) {
-    stopSpeaker();
-    if (webBeepActive) webBeepActive = false;
-  }
+  int32_t master = speaker_volume * 256 / 100;
+  bool any = true;
+  for (int n = 0; n < AUDIO_MIX_CHUNK && ((audioHead + 1) & AUDIO_RING_MASK) != audioTail; n++) {
+    int32_t acc = 0;
+    any = false;
+    for (auto &v : voices) {
+      if (!v.active) continue;
+      any = true;
+      if (!v.rest) acc += voiceSample(v) * v.vol;
+      if (--v.samplesLeft == 0) {
+        if (v.seq) voiceNextNote(v);
+        else v.active = false;
+      }
+    }
+    if (!any) break;   // all voices done: let the ring drain
+    // 4 voices * 127 * 63 fits +-2^15; scale to +-127 around mid-level
+    int32_t s = 128 + ((acc * master) >> 16);
+    audioRing[audioHead] = (uint8_t)constrain(s, 0, 255);
+    audioHead = (audioHead + 1) & AUDIO_RING_MASK;
+  }
+  if (!voices[0].active && webBeepActive) webBeepActive = false;
+  if (!any && audioHead == audioTail) stopSpeaker();
 }
 
 void playClick() {
   if (speaker_volume == 0) return;
-  startTone(0, 0, speaker_volume);
+  startTone(2000, 15, speaker_volume);
 }
 void playNavigate() {
   if (speaker_volume == 0) return;
-  startTone(0, 0, speaker_volume);
+  startTone(1200, 40, speaker_volume);
 }
 void playCalibrate() {
   if (speaker_volume == 0) return;
-  startTone(0, 0, speaker_volume);
+  startTone(880, 150, speaker_volume);
 }
 void playGameSound(uint16_t freq, uint32_t dur) {
   if (speaker_volume == 0) return;
@@ -278,30 +908,225 @@ int readMux(uint8_t ch) {
   return analogRead(MUX_Z);
 }
 
+// ---------------- JOYSTICK ----------------
+void joyBegin() {
+  for (int i = 0; i < 2; i++) {
+    int c = i ? centerY : centerX;
+    joyAxes[i] = { 0, 0, c * 16, (int16_t)(c - JOY_MIN_SPAN), (int16_t)(c + JOY_MIN_SPAN) };
+  }
+  joyChannel = 0;
+  digitalWrite(MUX_S0, 0);
+}
+
+// One ADC read per tick on the channel selected last tick, then switch
+void joySample() {
+  JoyAxis &a = joyAxes[joyChannel];
+  a.acc += analogRead(MUX_Z);
+  joyChannel ^= 1;
+  digitalWrite(MUX_S0, joyChannel);
+  if (++a.n < JOY_OVERSAMPLE) return;
+
+  int32_t v = a.acc / JOY_OVERSAMPLE;
+  a.acc = 0; a.n = 0;
+  a.filtQ4 += ((v << 4) - a.filtQ4) >> JOY_EMA_SHIFT;
+  int16_t f = (a.filtQ4 + 8) >> 4;   // rounded: the EMA settles within 1/16 count
+  if (f < a.lo) a.lo = f;
+  if (f > a.hi) a.hi = f;
+  if (&a == &joyAxes[0]) rawX = f; else rawY = f;
+}
+
+// Deflection from center in Q8 with deadzone and expo applied
+static int16_t joyShape(int value, int center, int lo, int hi) {
+  int d = value - center;
+  int span = d >= 0 ? hi - center : center - lo;
+  if (span < 1) return 0;
+  int32_t n = iMin((abs(d) * 256 + span / 2) / span, 256);
+  if (n <= JOY_DEADZONE_Q8) return 0;
+  n = ((n - JOY_DEADZONE_Q8) * 256 + (256 - JOY_DEADZONE_Q8) / 2) / (256 - JOY_DEADZONE_Q8);
+  int32_t cubic = (n * n * n + 32768) >> 16;
+  n = (n * (256 - JOY_EXPO_Q8) + cubic * JOY_EXPO_Q8 + 128) >> 8;
+  return d >= 0 ? n : -n;
+}
+
+void mapJoystickToMovement(int rawXv,int rawYv,int &moveX,int &moveY) {
+  int mvx = joyShape(rawXv, centerX, joyAxes[0].lo, joyAxes[0].hi);
+  int mvy = joyShape(rawYv, centerY, joyAxes[1].lo, joyAxes[1].hi);
+  switch (joystick_rotation) {
+    case 0: moveX = mvx; moveY = mvy; break;
+    case 90: moveX = mvy; moveY = -mvx; break;
+    case 180: moveX = -mvx; moveY = -mvy; break;
+    case 270: default: moveX = -mvy; moveY = mvx; break;
+  }
+}
+
+// ---------------- INPUT EVENTS ----------------
+// Producer side of the edge ring; lockout debounce after each accepted edge
+void IRAM_ATTR inputISR() {
+  bool down = digitalRead(JOY_SW) == LOW;
+  uint32_t now = millis();
+  if (down == inputIsrDown || now - inputIsrMs < INPUT_DEBOUNCE_MS) return;
+  uint8_t h = inputEdgeHead, next = (h + 1) & (INPUT_RING - 1);
+  if (next == inputEdgeTail) return;   // full: drop, level stays unchanged
+  inputEdgeMs[h] = now;
+  inputEdgeDown[h] = down;
+  inputEdgeHead = next;
+  inputIsrDown = down; inputIsrMs = now;
+}
+
+void inputBegin() {
+  inputIsrDown = digitalRead(JOY_SW) == LOW;
+  btnPressed = inputIsrDown;
+  attachInterrupt(digitalPinToInterrupt(JOY_SW), inputISR, CHANGE);
+}
+
+static void inputPush(InputEventType type, uint32_t ms, int x, int y) {
+  uint8_t next = (inputEventHead + 1) & (INPUT_RING - 1);
+  if (next == inputEventTail) return;
+  inputEvents[inputEventHead] = { type, ms, (int16_t)x, (int16_t)y };
+  inputEventHead = next;
+}
+
+static uint8_t inputEventRoom() {
+  return (inputEventTail - inputEventHead - 1) & (INPUT_RING - 1);
+}
+
+bool inputPop(InputEvent &ev) {
+  if (inputEventTail == inputEventHead) return false;
+  ev = inputEvents[inputEventTail];
+  inputEventTail = (inputEventTail + 1) & (INPUT_RING - 1);
+  return true;
+}
+
+// Consumer side: synthesize click/long-press/repeat/direction events
+void inputPoll() {
+  static uint32_t downMs = 0, nextRepeatMs = 0;
+  static bool longFired = false;
+  static int8_t dirX = 0, dirY = 0;
+  uint32_t now = millis();
+
+  // An edge swallowed by the lockout leaves the ISR level stale; resync it
+  if (inputEdgeTail == inputEdgeHead && (digitalRead(JOY_SW) == LOW) != inputIsrDown) {
+    noInterrupts(); inputISR(); interrupts();
+  }
+
+  // An edge makes up to two events; leave it queued until both fit, so a
+  // press is never dropped while its release gets through
+  while (inputEdgeTail != inputEdgeHead && inputEventRoom() >= 2) {
+    uint8_t t = inputEdgeTail;
+    uint32_t ms = inputEdgeMs[t];
+    bool down = inputEdgeDown[t];
+    inputEdgeTail = (t + 1) & (INPUT_RING - 1);
+    if (down) {
+      downMs = ms; longFired = false;
+      inputPush(EV_PRESS, ms, cursorX, cursorY);
+    } else {
+      inputPush(EV_RELEASE, ms, cursorX, cursorY);
+      if (!longFired) inputPush(EV_CLICK, ms, cursorX, cursorY);
+    }
+    btnPressed = down;
+  }
+  if (btnPressed && !longFired && now - downMs >= INPUT_LONG_MS) {
+    longFired = true;
+    inputPush(EV_LONG_PRESS, downMs + INPUT_LONG_MS, cursorX, cursorY);
+  }
+
+  int mvx, mvy;
+  mapJoystickToMovement(rawX, rawY, mvx, mvy);
+  int8_t dx = mvx > INPUT_DIR_Q8 ? 1 : mvx < -INPUT_DIR_Q8 ? -1 : 0;
+  int8_t dy = mvy > INPUT_DIR_Q8 ? 1 : mvy < -INPUT_DIR_Q8 ? -1 : 0;
+  if (dx != dirX || dy != dirY) {
+    dirX = dx; dirY = dy;
+    if (dx || dy) inputPush(EV_JOY_DIR, now, dx, dy);
+    nextRepeatMs = now + INPUT_REPEAT_DELAY_MS;
+  } else if ((dx || dy) && (int32_t)(now - nextRepeatMs) >= 0) {
+    inputPush(EV_REPEAT, now, dx, dy);
+    nextRepeatMs += INPUT_REPEAT_MS;
+  }
+}
+
+// Q8 deflection * pixels-at-full-tilt, carrying the fraction between frames
+static int joyStep(int32_t &sub, int vec, int maxPx) {
+  sub += vec * maxPx;
+  int px = sub / 256;
+  sub -= px * 256;
+  return px;
+}
+
 // ---------------- MPU IMPROVED ----------------
-bool readRaw(int16_t &ax,int16_t &ay,int16_t &az,int16_t &gx,int16_t &gy,int16_t &gz) {
+void mpuWriteReg(uint8_t reg, uint8_t val) {
   Wire.beginTransmission((uint8_t)MPU_ADDR);
-  Wire.write(0x3B);
+  Wire.write(reg);
+  Wire.write(val);
+  Wire.endTransmission();
+}
+
+bool mpuReadBytes(uint8_t reg, uint8_t *buf, uint8_t len) {
+  Wire.beginTransmission((uint8_t)MPU_ADDR);
+  Wire.write(reg);
   Wire.endTransmission(false);
-  Wire.requestFrom((uint8_t)MPU_ADDR, (size_t)14, (bool)true);
+  Wire.requestFrom((uint8_t)MPU_ADDR, (size_t)len, (bool)true);
 
   unsigned long start = micros();
-  while (Wire.available() < 14) {
+  while (Wire.available() < len) {
     if ((unsigned long)(micros() - start) > 2000UL) return false;
     yield();
   }
+  for (uint8_t i = 0; i < len; i++) buf[i] = Wire.read();
+  return true;
+}
+
+static inline int16_t be16(const uint8_t *p) { return (int16_t)((p[0] << 8) | p[1]); }
 
-  int16_t hi, lo;
-  hi = Wire.read(); lo = Wire.read(); ax = (hi << 8) | (lo & 0xFF);
-  hi = Wire.read(); lo = Wire.read(); ay = (hi << 8) | (lo & 0xFF);
-  hi = Wire.read(); lo = Wire.read(); az = (hi << 8) | (lo & 0xFF);
-  Wire.read(); Wire.read();
-  hi = Wire.read(); lo = Wire.read(); gx = (hi << 8) | (lo & 0xFF);
-  hi = Wire.read(); lo = Wire.read(); gy = (hi << 8) | (lo & 0xFF);
-  hi = Wire.read(); lo = Wire.read(); gz = (hi << 8) | (lo & 0xFF);
+bool readRaw(int16_t &ax,int16_t &ay,int16_t &az,int16_t &gx,int16_t &gy,int16_t &gz) {
+  uint8_t b[14];
+  if (!mpuReadBytes(MPU_REG_ACCEL_OUT, b, 14)) return false;
+  ax = be16(b); ay = be16(b+2); az = be16(b+4);
+  gx = be16(b+8); gy = be16(b+10); gz = be16(b+12);
   return true;
 }
 
+// Sample at MPU_SAMPLE_RATE_HZ (DLPF 44 Hz, 1 kHz gyro clock) and queue
+// accel+gyro into the on-chip 1 KB FIFO.
+void mpuSetupFifo() {
+  mpuWriteReg(MPU_REG_CONFIG, 0x03);
+  mpuWriteReg(MPU_REG_SMPLRT_DIV, 1000 / MPU_SAMPLE_RATE_HZ - 1);
+  mpuWriteReg(MPU_REG_FIFO_EN, 0x78);
+  mpuWriteReg(MPU_REG_USER_CTRL, 0x04); // FIFO_RESET
+  mpuWriteReg(MPU_REG_USER_CTRL, 0x40); // FIFO_EN
+}
+
+// Drain every complete sample in the FIFO and integrate each one at the
+// true sample interval. On overflow the FIFO is no longer frame aligned,
+// so it is reset and the overflow counted.
+void mpuDrainFifo() {
+  uint8_t b[BUFFER_LENGTH - BUFFER_LENGTH % MPU_FIFO_SAMPLE_BYTES];
+  if (!mpuReadBytes(MPU_REG_INT_STATUS, b, 1)) return;
+  if (b[0] & 0x10) {
+    mpuFifoOverflows++;
+    mpuWriteReg(MPU_REG_USER_CTRL, 0x44);
+    return;
+  }
+  if (!mpuReadBytes(MPU_REG_FIFO_COUNT, b, 2)) return;
+  int pending = ((b[0] << 8) | b[1]) / MPU_FIFO_SAMPLE_BYTES;
+  const uint32_t sampleUs = 1000000UL / MPU_SAMPLE_RATE_HZ;
+  bool any = false;
+  while (pending > 0) {
+    int batch = iMin(pending, (int)sizeof(b) / MPU_FIFO_SAMPLE_BYTES);
+    if (!mpuReadBytes(MPU_REG_FIFO_R_W, b, batch * MPU_FIFO_SAMPLE_BYTES)) break;
+    for (int i = 0; i < batch; i++) {
+      const uint8_t *p = b + i * MPU_FIFO_SAMPLE_BYTES;
+      fuseSample(be16(p), be16(p+2), be16(p+4), be16(p+6), be16(p+8), be16(p+10), sampleUs);
+      telemRecord(be16(p), be16(p+2), be16(p+4), be16(p+6), be16(p+8), be16(p+10), sampleUs);
+      if (calib.state == CALIB_COLLECTING)
+        calibAddSample(be16(p), be16(p+2), be16(p+4), be16(p+6), be16(p+8), be16(p+10));
+    }
+    mpuFifoSamples += batch;
+    pending -= batch;
+    any = true;
+  }
+  if (any) fusionPublish();
+}
+
 void saveCalibration() {
   CalibrationData d;
   d.magic = EEPROM_MAGIC;
@@ -318,225 +1143,1066 @@ bool loadCalibration() {
     gx_offset = d.gx_offset; gy_offset = d.gy_offset; gz_offset = d.gz_offset;
     ax_offset = d.ax_offset; ay_offset = d.ay_offset; az_offset = d.az_offset;
     pitch_ref = d.pitch_ref; roll_ref = d.roll_ref; yaw_ref = d.yaw_ref;
+    fusionSetOffsets();
     return true;
   }
   return false;
 }
 
-void calibrateSensors() {
-  tft.fillRect(0, STATUS_BAR_H, DISP_W, DISP_H-STATUS_BAR_H, C_BG);
-  tft.setTextColor(C_FG); tft.setTextSize(1);
-  tft.setCursor(10, STATUS_BAR_H + 20); tft.print("Calibrating...");
-  tft.setCursor(10, STATUS_BAR_H + 32); tft.print("Keep flat & still");
-
-  long gx_sum=0, gy_sum=0, gz_sum=0;
-  long ax_sum=0, ay_sum=0, az_sum=0;
-  int collected = 0;
-  unsigned long startTime = millis();
-  
-  while (collected < CALIB_SAMPLES && millis() - startTime < CALIB_TIME + 2000UL) {
-    int16_t axr, ayr, azr, gxr, gyr, gzr;
-    if (readRaw(axr, ayr, azr, gxr, gyr, gzr)) {
-      gx_sum += gxr; gy_sum += gyr; gz_sum += gzr;
-      ax_sum += axr; ay_sum += ayr; az_sum += azr;
-      collected++;
-      if ((collected % 20) == 0) {
-        int p = map(collected, 0, CALIB_SAMPLES, 0, DISP_W - 40);
-        tft.fillRect(20, STATUS_BAR_H + 65, p, 8, C_ACCENT);
-      }
-    } else delay(2);
-    yield();
-  }
+void startCalibration() {
+  if (calib.state != CALIB_IDLE) return;
+  memset(&calib, 0, sizeof(calib));
+  calib.state = CALIB_COLLECTING;
+  calib.startMs = millis();
+  markDirty(0, STATUS_BAR_H, DISP_W, DISP_H - STATUS_BAR_H);
+}
 
-  if (collected == 0) {
-    tft.setCursor(10, STATUS_BAR_H + 100); tft.setTextColor(C_ERROR); 
-    tft.print("Calibration failed");
-    delay(1500);
-    needsFullRedraw = true;
-    return;
-  }
+void calibAddSample(int16_t axr, int16_t ayr, int16_t azr, int16_t gxr, int16_t gyr, int16_t gzr) {
+  const int16_t v[6] = { axr, ayr, azr, gxr, gyr, gzr };
+  for (int i = 0; i < 6; i++) { calib.sum[i] += v[i]; calib.sumSq[i] += (int32_t)v[i] * v[i]; }
+  calib.collected++;
+}
 
-  gx_offset = gx_sum / (float)collected;
-  gy_offset = gy_sum / (float)collected;
-  gz_offset = gz_sum / (float)collected;
-  ax_offset = ax_sum / (float)collected;
-  ay_offset = ay_sum / (float)collected;
-  az_offset = (az_sum / (float)collected) - 16384.0f;
+static void finishCalibration(CalibState result) {
+  calib.state = result;
+  calib.resultMs = millis();
+  markDirty(10, STATUS_BAR_H + 100, DISP_W - 10, 8);
+}
 
-  float ax_avg = (ax_sum / (float)collected) - ax_offset;
-  float ay_avg = (ay_sum / (float)collected) - ay_offset;
-  float az_avg = (az_sum / (float)collected) - az_offset;
+// Commit offsets from the collected samples, unless the variance shows the
+// device was moving while they were taken.
+static void commitCalibration() {
+  int n = calib.collected;
+  for (int i = 0; i < 6; i++) {
+    int64_t var = (n * calib.sumSq[i] - calib.sum[i] * calib.sum[i]) / ((int64_t)n * n);
+    if (var > (i < 3 ? CALIB_ACCEL_VAR_MAX : CALIB_GYRO_VAR_MAX)) { finishCalibration(CALIB_MOVED); return; }
+  }
+
+  gx_offset = calib.sum[3] / (float)n;
+  gy_offset = calib.sum[4] / (float)n;
+  gz_offset = calib.sum[5] / (float)n;
+  ax_offset = calib.sum[0] / (float)n;
+  ay_offset = calib.sum[1] / (float)n;
+  az_offset = (calib.sum[2] / (float)n) - 16384.0f;
+  fusionSetOffsets();
+
+  float ax_avg = (calib.sum[0] / (float)n) - ax_offset;
+  float ay_avg = (calib.sum[1] / (float)n) - ay_offset;
+  float az_avg = (calib.sum[2] / (float)n) - az_offset;
   pitch_ref = atan2(ay_avg/16384.0f, az_avg/16384.0f) * 180.0f / PI;
   roll_ref = atan2(-ax_avg/16384.0f, az_avg/16384.0f) * 180.0f / PI;
   yaw_ref = yaw;
 
   saveCalibration();
   calibrated = true;
-
-  tft.setCursor(10, STATUS_BAR_H + 100); tft.setTextColor(C_SUCCESS); 
-  tft.print("Calibrated!");
   playCalibrate();
-  delay(1000);
-  needsFullRedraw = true;
+  finishCalibration(CALIB_DONE);
+}
+
+// One loop tick of the calibration job. In FIFO mode samples arrive through
+// mpuDrainFifo(); in polled mode a small batch is read here.
+void stepCalibration() {
+  if (calib.state == CALIB_IDLE) return;
+  if (calib.state != CALIB_COLLECTING) {
+    uint32_t hold = (calib.state == CALIB_DONE) ? 1000 : 1500;
+    if (millis() - calib.resultMs >= hold) { calib.state = CALIB_IDLE; needsFullRedraw = true; }
+    return;
+  }
+
+#if !MPU_USE_FIFO
+  for (int i = 0; i < CALIB_BATCH && calib.collected < CALIB_SAMPLES; i++) {
+    int16_t axr, ayr, azr, gxr, gyr, gzr;
+    if (!readRaw(axr, ayr, azr, gxr, gyr, gzr)) break;
+    calibAddSample(axr, ayr, azr, gxr, gyr, gzr);
+  }
+#endif
+
+  int p = map(iMin(calib.collected, CALIB_SAMPLES), 0, CALIB_SAMPLES, 0, DISP_W - 40);
+  if (p / 4 != calib.shownProgress / 4) {
+    calib.shownProgress = p;
+    markDirty(20, STATUS_BAR_H + 65, DISP_W - 40, 8);
+  }
+
+  if (calib.collected >= CALIB_SAMPLES) commitCalibration();
+  else if (millis() - calib.startMs >= CALIB_TIME + 2000UL) {
+    if (calib.collected == 0) finishCalibration(CALIB_FAILED);
+    else commitCalibration();
+  }
+}
+
+// Calibration screen, drawn through the normal render path while the job runs
+void drawCalibration() {
+  gfx.fillRect(0, STATUS_BAR_H, DISP_W, DISP_H-STATUS_BAR_H, C_BG);
+  gfx.setTextColor(C_FG); gfx.setTextSize(1);
+  gfx.setCursor(10, STATUS_BAR_H + 20); gfx.print("Calibrating...");
+  gfx.setCursor(10, STATUS_BAR_H + 32); gfx.print("Keep flat & still");
+  gfx.fillRect(20, STATUS_BAR_H + 65, calib.shownProgress, 8, C_ACCENT);
+
+  gfx.setCursor(10, STATUS_BAR_H + 100);
+  if (calib.state == CALIB_DONE) { gfx.setTextColor(C_SUCCESS); gfx.print("Calibrated!"); }
+  else if (calib.state == CALIB_FAILED) { gfx.setTextColor(C_ERROR); gfx.print("Calibration failed"); }
+  else if (calib.state == CALIB_MOVED) { gfx.setTextColor(C_ERROR); gfx.print("Moved - try again"); }
+}
+
+// Refresh the Q8 offsets used by the fixed-point filter from the float calibration
+void fusionSetOffsets() {
+  gx_off_q8 = (int32_t)lroundf(gx_offset * 256); gy_off_q8 = (int32_t)lroundf(gy_offset * 256);
+  gz_off_q8 = (int32_t)lroundf(gz_offset * 256);
+  ax_off_q8 = (int32_t)lroundf(ax_offset * 256); ay_off_q8 = (int32_t)lroundf(ay_offset * 256);
+  az_off_q8 = (int32_t)lroundf(az_offset * 256);
+}
+
+#if IMU_FILTER == IMU_FILTER_MAHONY
+// One Mahony step: gyro in rad/s, accel in any unit, dt in seconds.
+// Gravity error from the accelerometer feeds back through a PI controller.
+void ahrsUpdate(float gx, float gy, float gz, float ax, float ay, float az, float dt) {
+  float q0 = ahrs_q0, q1 = ahrs_q1, q2 = ahrs_q2, q3 = ahrs_q3;
+  float n = ax*ax + ay*ay + az*az;
+  if (n > 0.0f) {
+    float r = 1.0f / sqrtf(n);
+    ax *= r; ay *= r; az *= r;
+    float vx = 2.0f*(q1*q3 - q0*q2), vy = 2.0f*(q0*q1 + q2*q3), vz = q0*q0 - q1*q1 - q2*q2 + q3*q3;
+    float ex = ay*vz - az*vy, ey = az*vx - ax*vz, ez = ax*vy - ay*vx;
+    ahrs_ix += AHRS_KI * ex * dt; ahrs_iy += AHRS_KI * ey * dt; ahrs_iz += AHRS_KI * ez * dt;
+    gx += AHRS_KP * ex + ahrs_ix; gy += AHRS_KP * ey + ahrs_iy; gz += AHRS_KP * ez + ahrs_iz;
+  }
+  gx *= 0.5f * dt; gy *= 0.5f * dt; gz *= 0.5f * dt;
+  ahrs_q0 = q0 + (-q1*gx - q2*gy - q3*gz);
+  ahrs_q1 = q1 + ( q0*gx + q2*gz - q3*gy);
+  ahrs_q2 = q2 + ( q0*gy - q1*gz + q3*gx);
+  ahrs_q3 = q3 + ( q0*gz + q1*gy - q2*gx);
+  float r = 1.0f / sqrtf(ahrs_q0*ahrs_q0 + ahrs_q1*ahrs_q1 + ahrs_q2*ahrs_q2 + ahrs_q3*ahrs_q3);
+  ahrs_q0 *= r; ahrs_q1 *= r; ahrs_q2 *= r; ahrs_q3 *= r;
+}
+
+// Start from the accelerometer attitude instead of waiting for the filter to converge
+void ahrsSeed(float ax, float ay, float az) {
+  float hp = 0.5f * atan2f(ay, az), hr = 0.5f * atan2f(-ax, sqrtf(ay*ay + az*az));
+  float cp = cosf(hp), sp = sinf(hp), cr = cosf(hr), sr = sinf(hr);
+  ahrs_q0 = cp*cr; ahrs_q1 = sp*cr; ahrs_q2 = cp*sr; ahrs_q3 = -sp*sr;
+  ahrsSeeded = true;
+}
+
+// One AHRS step on a raw sample; Euler angles are written to the Q16 state
+// so the display EMA and publishing are shared with the complementary path.
+void fuseSample(int16_t axr, int16_t ayr, int16_t azr, int16_t gxr, int16_t gyr, int16_t gzr, uint32_t dtUs) {
+  const float lsbToRad = 1.0f / (131.0f * 256.0f) * (float)(PI / 180.0);
+  float ax = axr * 256 - ax_off_q8, ay = ayr * 256 - ay_off_q8, az = azr * 256 - az_off_q8;
+  if (!ahrsSeeded) ahrsSeed(ax, ay, az);
+  ahrsUpdate((gxr * 256 - gx_off_q8) * lsbToRad, (gyr * 256 - gy_off_q8) * lsbToRad,
+             (gzr * 256 - gz_off_q8) * lsbToRad, ax, ay, az, dtUs * 1e-6f);
+
+  float q0 = ahrs_q0, q1 = ahrs_q1, q2 = ahrs_q2, q3 = ahrs_q3;
+  const float toDeg = (float)(180.0 / PI);
+  float p = atan2f(2.0f*(q0*q1 + q2*q3), 1.0f - 2.0f*(q1*q1 + q2*q2)) * toDeg;
+  float sinr = constrain(2.0f*(q0*q2 - q3*q1), -1.0f, 1.0f);
+  float r = asinf(sinr) * toDeg;
+  float y = atan2f(2.0f*(q0*q3 + q1*q2), 1.0f - 2.0f*(q2*q2 + q3*q3)) * toDeg;
+
+  // Keep yaw continuous like the gyro-integrated one: unwrap across +-180
+  float dy = y - ahrsLastYaw;
+  if (dy > 180.0f) dy -= 360.0f; else if (dy < -180.0f) dy += 360.0f;
+  ahrsLastYaw = y;
+
+  pitch_q = (q16_t)(p * 65536.0f);
+  roll_q = (q16_t)(r * 65536.0f);
+  yaw_q += (q16_t)(dy * 65536.0f);
+
+  pitch_fq += (int32_t)(((int64_t)(pitch_q - pitch_fq) * (65536 - FILTER_ALPHA_Q16)) >> 16);
+  roll_fq += (int32_t)(((int64_t)(roll_q - roll_fq) * (65536 - FILTER_ALPHA_Q16)) >> 16);
+  yaw_fq += (int32_t)(((int64_t)(yaw_q - yaw_fq) * (65536 - FILTER_ALPHA_Q16)) >> 16);
+}
+#else
+// One complementary-filter step on a raw sample, all integer math
+void fuseSample(int16_t axr, int16_t ayr, int16_t azr, int16_t gxr, int16_t gyr, int16_t gzr, uint32_t dtUs) {
+  int32_t ax = axr * 256 - ax_off_q8, ay = ayr * 256 - ay_off_q8, az = azr * 256 - az_off_q8;
+  int32_t gx = gxr * 256 - gx_off_q8, gy = gyr * 256 - gy_off_q8, gz = gzr * 256 - gz_off_q8;
+
+  q16_t pitch_acc = atan2Q16(ay, az);
+  q16_t roll_acc = atan2Q16(-ax, az);
+
+  pitch_q += (int32_t)(((int64_t)gx * dtUs * GYRO_DEG_K) >> 36);
+  roll_q += (int32_t)(((int64_t)gy * dtUs * GYRO_DEG_K) >> 36);
+  yaw_q += (int32_t)(((int64_t)gz * dtUs * GYRO_DEG_K) >> 36);
+  pitch_q += (int32_t)(((int64_t)(pitch_acc - pitch_q) * (65536 - COMP_ALPHA_Q16)) >> 16);
+  roll_q += (int32_t)(((int64_t)(roll_acc - roll_q) * (65536 - COMP_ALPHA_Q16)) >> 16);
+
+  pitch_fq += (int32_t)(((int64_t)(pitch_q - pitch_fq) * (65536 - FILTER_ALPHA_Q16)) >> 16);
+  roll_fq += (int32_t)(((int64_t)(roll_q - roll_fq) * (65536 - FILTER_ALPHA_Q16)) >> 16);
+  yaw_fq += (int32_t)(((int64_t)(yaw_q - yaw_fq) * (65536 - FILTER_ALPHA_Q16)) >> 16);
+}
+#endif
+
+// Publish the Q16 state to the float globals the UI and web code read
+void fusionPublish() {
+  const float k = 1.0f / 65536.0f;
+  pitch = pitch_q * k; roll = roll_q * k; yaw = yaw_q * k;
+  pitch_filtered = pitch_fq * k; roll_filtered = roll_fq * k; yaw_filtered = yaw_fq * k;
 }
 
 void updateMPU6050() {
+#if MPU_USE_FIFO
+  mpuDrainFifo();
+#else
   unsigned long now = micros();
   if (timerMicros == 0) timerMicros = now;
-  dt = (now - timerMicros) / 1000000.0f;
-  if (dt < 0.002f) return;
+  uint32_t dtUs = now - timerMicros;
+  if (dtUs < 2000) return;
   timerMicros = now;
+  if (dtUs > 100000) dtUs = 100000; // long stall: don't integrate a huge step
 
   int16_t axr, ayr, azr, gxr, gyr, gzr;
   if (!readRaw(axr, ayr, azr, gxr, gyr, gzr)) return;
+  fuseSample(axr, ayr, azr, gxr, gyr, gzr, dtUs);
+  telemRecord(axr, ayr, azr, gxr, gyr, gzr, dtUs);
+  fusionPublish();
+#endif
+}
+
+// ---------------- TELEMETRY ----------------
+static inline int32_t q16ToCentiDeg(q16_t v) {
+  return (int32_t)(((int64_t)v * 100 + (v < 0 ? -32768 : 32768)) / 65536);
+}
 
-  float ax_g = (axr - ax_offset) / 16384.0f;
-  float ay_g = (ayr - ay_offset) / 16384.0f;
-  float az_g = (azr - az_offset) / 16384.0f;
+static uint8_t *telemPutVarint(uint8_t *p, uint32_t v) {
+  while (v >= 0x80) { *p++ = (uint8_t)v | 0x80; v >>= 7; }
+  *p++ = (uint8_t)v;
+  return p;
+}
 
-  float gx_dps = (gxr - gx_offset) / 131.0f;
-  float gy_dps = (gyr - gy_offset) / 131.0f;
-  float gz_dps = (gzr - gz_offset) / 131.0f;
+static const uint8_t *telemGetVarint(const uint8_t *p, const uint8_t *end, uint32_t &v) {
+  v = 0;
+  for (uint8_t shift = 0; p < end && shift < 35; shift += 7) {
+    uint8_t b = *p++;
+    v |= (uint32_t)(b & 0x7F) << shift;
+    if (!(b & 0x80)) return p;
+  }
+  return nullptr;
+}
 
-  float pitch_acc = atan2(ay_g, az_g) * 180.0f / PI;
-  float roll_acc = atan2(-ax_g, az_g) * 180.0f / PI;
+static void telemPut32(uint8_t *p, uint32_t v) { p[0] = v; p[1] = v >> 8; p[2] = v >> 16; p[3] = v >> 24; }
+static uint32_t telemGet32(const uint8_t *p) { return p[0] | (p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24); }
+
+void telemRecord(int16_t axr, int16_t ayr, int16_t azr, int16_t gxr, int16_t gyr, int16_t gzr, uint32_t dtUs) {
+  uint32_t us = telemClockFracUs + dtUs;
+  telemClockMs += us / 1000;
+  telemClockFracUs = us % 1000;
+  if (++telemSkip < TELEM_DECIMATE) return;
+  telemSkip = 0;
+
+  uint32_t ms = telemClockMs;
+  int32_t v[TELEM_CHANNELS] = { axr, ayr, azr, gxr, gyr, gzr,
+                                q16ToCentiDeg(pitch_q), q16ToCentiDeg(roll_q), q16ToCentiDeg(yaw_q) };
+  TelemBlock *b = &telemBlocks[telemHead];
+  if (b->count && b->used + TELEM_MAX_SAMPLE_BYTES > TELEM_BLOCK_BYTES) {
+    telemHead = (telemHead + 1) % TELEM_BLOCKS;
+    b = &telemBlocks[telemHead];
+    b->used = 0; b->count = 0;
+  }
+  if (!b->count) {
+    if (telemFilled < TELEM_BLOCKS) telemFilled++;
+    uint8_t *p = b->data;
+    telemPut32(p, ms); p += 4;
+    for (int i = 0; i < 6; i++) { *p++ = (uint16_t)v[i]; *p++ = (uint16_t)v[i] >> 8; }
+    for (int i = 6; i < TELEM_CHANNELS; i++) { telemPut32(p, v[i]); p += 4; }
+    b->used = p - b->data;
+  } else {
+    uint8_t *p = b->data + b->used;
+    p = telemPutVarint(p, ms - telemLastMs);
+    for (int i = 0; i < TELEM_CHANNELS; i++) {
+      int32_t d = v[i] - telemLast[i];
+      p = telemPutVarint(p, ((uint32_t)d << 1) ^ (uint32_t)(d >> 31));
+    }
+    b->used = p - b->data;
+  }
+  b->count++;
+  telemLastMs = ms;
+  memcpy(telemLast, v, sizeof(telemLast));
+}
 
-  float alpha = 0.98f;
-  pitch = alpha * (pitch + gx_dps * dt) + (1.0f - alpha) * pitch_acc;
-  roll = alpha * (roll + gy_dps * dt) + (1.0f - alpha) * roll_acc;
-  yaw += gz_dps * dt;
+// Block `idx` counted from the oldest one still held
+const TelemBlock &telemBlockAt(uint8_t idx) {
+  return telemBlocks[(telemHead + TELEM_BLOCKS + 1 - telemFilled + idx) % TELEM_BLOCKS];
+}
 
-  pitch_filtered = FILTER_ALPHA * pitch_filtered + (1.0f - FILTER_ALPHA) * pitch;
-  roll_filtered = FILTER_ALPHA * roll_filtered + (1.0f - FILTER_ALPHA) * roll;
-  yaw_filtered = FILTER_ALPHA * yaw_filtered + (1.0f - FILTER_ALPHA) * yaw;
+// Walks block `idx`, calling fn(ms, values) per sample
+template <typename Fn>
+bool telemDecodeBlock(uint8_t idx, Fn fn) {
+  const TelemBlock &b = telemBlockAt(idx);
+  if (b.used < TELEM_KEYFRAME_BYTES) return false;
+  const uint8_t *p = b.data, *end = b.data + b.used;
+  int32_t v[TELEM_CHANNELS];
+  uint32_t ms = telemGet32(p); p += 4;
+  for (int i = 0; i < 6; i++, p += 2) v[i] = (int16_t)(p[0] | (p[1] << 8));
+  for (int i = 6; i < TELEM_CHANNELS; i++, p += 4) v[i] = (int32_t)telemGet32(p);
+  fn(ms, v);
+  for (uint16_t n = 1; n < b.count; n++) {
+    uint32_t u;
+    if (!(p = telemGetVarint(p, end, u))) return false;
+    ms += u;
+    for (int i = 0; i < TELEM_CHANNELS; i++) {
+      if (!(p = telemGetVarint(p, end, u))) return false;
+      v[i] += (int32_t)((u >> 1) ^ (0u - (u & 1)));
+    }
+    fn(ms, v);
+  }
+  return true;
+}
+
+// ---------------- JSON READER ----------------
+// Pull parser fed in arbitrary chunks. It keeps only the current path
+// ("weather[0].main") and one scalar token, and reports each scalar to
+// onValue. Tokens longer than the buffer are truncated, and keys past
+// the path buffer are dropped.
+#define JSON_MAX_DEPTH 8
+struct JsonReader {
+  enum State : uint8_t { VALUE, KEY_OR_END, KEY, COLON, COMMA_OR_END, STRING, LITERAL, DONE, FAIL };
+
+  void (*onValue)(const char *path, const char *value);
+  char path[48];
+  uint8_t pathLen;
+  uint8_t depth;
+  char kind[JSON_MAX_DEPTH];       // '{' or '['
+  uint8_t base[JSON_MAX_DEPTH];    // pathLen when the container opened
+  uint16_t index[JSON_MAX_DEPTH];
+  char tok[24];
+  uint8_t tokLen;
+  uint8_t state;
+  bool inKey, escape;
+  uint8_t hexSkip;
+
+  explicit JsonReader(void (*cb)(const char *, const char *)) : onValue(cb) { reset(); }
+
+  void reset() {
+    pathLen = 0; path[0] = 0; depth = 0; tokLen = 0; tok[0] = 0;
+    state = VALUE; inKey = escape = false; hexSkip = 0;
+  }
+  bool done() const { return state == DONE; }
+  bool failed() const { return state == FAIL; }
+
+  void feed(const char *buf, size_t n) {
+    for (size_t i = 0; i < n && state < DONE; i++) feed(buf[i]);
+  }
+
+  void feed(char c) {
+    switch (state) {
+      case VALUE:
+        if (isSpace(c)) return;
+        if (c == '{') { if (push('{')) state = KEY_OR_END; }
+        else if (c == '[') { if (push('[')) setIndex(0); }
+        else if (c == ']' && depth && kind[depth - 1] == '[' && index[depth - 1] == 0) pop();
+        else if (c == '"') { tokLen = 0; inKey = false; state = STRING; }
+        else if (c == '-' || (c >= '0' && c <= '9') || (c >= 'a' && c <= 'z')) { tokLen = 0; append(c); state = LITERAL; }
+        else state = FAIL;
+        return;
+      case KEY_OR_END:
+      case KEY:
+        if (isSpace(c)) return;
+        if (c == '"') { tokLen = 0; inKey = true; state = STRING; }
+        else if (c == '}' && state == KEY_OR_END) pop();
+        else state = FAIL;
+        return;
+      case COLON:
+        if (isSpace(c)) return;
+        state = c == ':' ? VALUE : FAIL;
+        return;
+      case STRING:
+        if (hexSkip) { if (--hexSkip == 0) append('?'); return; }
+        if (escape) {
+          escape = false;
+          if (c == 'u') hexSkip = 4;
+          else append(c == 'n' ? '\n' : c == 't' ? '\t' : c == 'r' ? '\r' : c == 'b' || c == 'f' ? ' ' : c);
+          return;
+        }
+        if (c == '\\') { escape = true; return; }
+        if (c != '"') { append(c); return; }
+        if (inKey) { setKey(); state = COLON; }
+        else { onValue(path, tok); state = COMMA_OR_END; }
+        return;
+      case LITERAL:
+        if (c == ',' || c == '}' || c == ']' || isSpace(c)) {
+          onValue(path, tok);
+          state = COMMA_OR_END;
+          feed(c);
+        } else append(c);
+        return;
+      case COMMA_OR_END:
+        if (isSpace(c)) return;
+        if (!depth) { state = FAIL; return; }
+        if (c == ',') {
+          if (kind[depth - 1] == '{') state = KEY;   // no trailing comma
+          else setIndex(index[depth - 1] + 1);
+        } else if (c == (kind[depth - 1] == '{' ? '}' : ']')) pop();
+        else state = FAIL;
+        return;
+    }
+  }
+
+private:
+  static bool isSpace(char c) { return c == ' ' || c == '\n' || c == '\r' || c == '\t'; }
+
+  void append(char c) {
+    if (tokLen < sizeof(tok) - 1) { tok[tokLen++] = c; tok[tokLen] = 0; }
+  }
+  void truncatePath(uint8_t len) { pathLen = len; path[len] = 0; }
+  void appendPath(const char *s) {
+    while (*s && pathLen < sizeof(path) - 1) path[pathLen++] = *s++;
+    path[pathLen] = 0;
+  }
+
+  bool push(char k) {
+    if (depth == JSON_MAX_DEPTH) { state = FAIL; return false; }
+    kind[depth] = k; base[depth] = pathLen; index[depth] = 0;
+    depth++;
+    return true;
+  }
+  void pop() {
+    depth--;
+    truncatePath(base[depth]);
+    state = depth ? COMMA_OR_END : DONE;
+  }
+  void setKey() {
+    truncatePath(base[depth - 1]);
+    if (pathLen) appendPath(".");
+    appendPath(tok);
+  }
+  void setIndex(uint16_t i) {
+    index[depth - 1] = i;
+    char buf[8];
+    snprintf(buf, sizeof(buf), "[%u]", i);
+    truncatePath(base[depth - 1]);
+    appendPath(buf);
+    state = VALUE;
+  }
+};
+
+// "12.34" -> 123 (value * 10, rounded), integer only
+int32_t parseTenths(const char *s) {
+  bool neg = *s == '-';
+  if (neg) s++;
+  int32_t whole = 0;
+  while (*s >= '0' && *s <= '9') whole = whole * 10 + (*s++ - '0');
+  int32_t v = whole * 10;
+  if (*s == '.') {
+    s++;
+    if (*s >= '0' && *s <= '9') {
+      v += *s++ - '0';
+      if (*s >= '5' && *s <= '9') v++;
+    }
+  }
+  return neg ? -v : v;
 }
 
 // ---------------- WEATHER & NTP ----------------
-void fetchWeather() {
-  if (WiFi.status() != WL_CONNECTED) return;
-  WiFiClient client; HTTPClient http;
-  String url = "http://api.openweathermap.org/data/2.5/weather?id=" + String(OPENWEATHER_CITY_ID) + "&units=metric&appid=" + String(OPENWEATHER_API_KEY);
-  http.begin(client, url);
-  http.setTimeout(5000);
-  int code = http.GET();
-  if (code == 200) {
-    String payload = http.getString();
-    int tempIdx = payload.indexOf("\"temp\":");
-    if (tempIdx > 0) {
-      int tempStart = tempIdx + 7;
-      int tempEnd = payload.indexOf(",", tempStart);
-      if (tempEnd > tempStart) {
-        String tempStr = payload.substring(tempStart, tempEnd);
-        int t = (int)tempStr.toFloat();
-        snprintf(weatherTemp, sizeof(weatherTemp), "%d C", t);
+void weatherField(const char *path, const char *value) {
+  if (!strcmp(path, "main.temp")) {
+    weatherTempTenths = parseTenths(value);
+    // Whole degrees truncated from the original value, not the rounded tenths
+    snprintf(weatherTemp, sizeof(weatherTemp), "%d C", atoi(value));
+  } else if (!strcmp(path, "weather[0].main")) {
+    strncpy(weatherMain, value, sizeof(weatherMain)-1);
+    weatherMain[sizeof(weatherMain)-1] = '\0';
+  } else if (!strcmp(path, "main.humidity")) {
+    weatherHumidity = atoi(value);
+  } else if (!strcmp(path, "wind.speed")) {
+    weatherWindTenths = parseTenths(value);
+  }
+}
+
+// Refresh runs as a state machine stepped from the network task and never
+// blocks. DNS (cached for an hour) and the TCP connect go through lwIP's
+// callback APIs and are polled here, each phase capped at
+// WEATHER_CONNECT_TIMEOUT_MS. The callbacks run between loop() passes on
+// this core, so they share the job with the steps without locking. Received
+// data stays in lwIP's pbufs, with the TCP window held shut, until a step
+// parses it. A failure doubles the retry delay.
+enum WeatherState : uint8_t { WX_IDLE, WX_DNS, WX_CONNECT, WX_STATUS, WX_HEADERS, WX_BODY };
+struct WeatherJob {
+  WeatherState state;
+  tcp_pcb *pcb;
+  pbuf *rx;              // received, not yet parsed
+  int8_t dnsResult;      // set by the DNS callback: 1 found, -1 failed
+  bool connected, closed, failed;   // set by the TCP callbacks
+  uint8_t attempt;       // tags DNS lookups; a late answer to an abandoned one is ignored
+  ip_addr_t ip;
+  uint32_t dnsMs;
+  uint32_t startMs;      // start of the current phase
+  uint32_t nextAttemptMs;
+  uint32_t retryMs;
+  uint16_t failures;
+  uint8_t eolMatch;      // progress through "\r\n\r\n"
+  uint16_t status;
+  char line[16];         // start of the status line
+  uint8_t lineLen;
+};
+WeatherJob weather;
+JsonReader weatherJson(weatherField);
+
+void weatherRequest() {
+  weather.nextAttemptMs = millis();
+  weather.retryMs = 0;
+}
+
+static void weatherDnsFound(const char *, const ip_addr_t *ip, void *arg) {
+  if (weather.state != WX_DNS || (uintptr_t)arg != weather.attempt) return;
+  if (ip) weather.ip = *ip;
+  weather.dnsResult = ip ? 1 : -1;
+}
+
+static err_t weatherConnected(void *, tcp_pcb *, err_t) {
+  weather.connected = true;
+  return ERR_OK;
+}
+
+static err_t weatherRecv(void *, tcp_pcb *, pbuf *p, err_t) {
+  if (!p) { weather.closed = true; return ERR_OK; }
+  if (weather.rx) pbuf_cat(weather.rx, p);
+  else weather.rx = p;
+  return ERR_OK;
+}
+
+// lwIP has already freed the pcb when this runs
+static void weatherTcpError(void *, err_t) {
+  weather.pcb = nullptr;
+  weather.failed = true;
+}
+
+static void weatherClose() {
+  if (weather.pcb) {
+    tcp_arg(weather.pcb, nullptr);
+    tcp_recv(weather.pcb, nullptr);
+    tcp_err(weather.pcb, nullptr);
+    if (tcp_close(weather.pcb) != ERR_OK) tcp_abort(weather.pcb);
+    weather.pcb = nullptr;
+  }
+  if (weather.rx) { pbuf_free(weather.rx); weather.rx = nullptr; }
+}
+
+static void weatherFinish(bool ok) {
+  weatherClose();
+  weather.state = WX_IDLE;
+  uint32_t now = millis();
+  if (ok) {
+    weatherLastFetch = now;
+    weather.failures = 0;
+    weather.retryMs = 0;
+    weather.nextAttemptMs = now + WEATHER_REFRESH_MS;
+    if (currentApp == APP_HOME) markDirty(DISP_W - 64, STATUS_BAR_H + 10, 54, 44);
+  } else {
+    weather.failures++;
+    weather.retryMs = weather.retryMs ? iMin(weather.retryMs * 2, WEATHER_RETRY_MAX_MS) : WEATHER_RETRY_MIN_MS;
+    weather.nextAttemptMs = now + weather.retryMs;
+    weather.dnsMs = 0;   // re-resolve in case the address moved
+  }
+}
+
+static bool weatherConnect() {
+  weather.state = WX_CONNECT;
+  weather.startMs = millis();
+  weather.connected = weather.closed = weather.failed = false;
+  weather.pcb = tcp_new();
+  if (!weather.pcb) return false;
+  tcp_arg(weather.pcb, &weather);
+  tcp_recv(weather.pcb, weatherRecv);
+  tcp_err(weather.pcb, weatherTcpError);
+  tcp_nagle_disable(weather.pcb);
+  return tcp_connect(weather.pcb, &weather.ip, WEATHER_PORT, weatherConnected) == ERR_OK;
+}
+
+static bool weatherStart() {
+  uint32_t now = millis();
+  if (weather.dnsMs && now - weather.dnsMs <= WEATHER_DNS_TTL_MS) return weatherConnect();
+  weather.state = WX_DNS;
+  weather.startMs = now;
+  weather.dnsResult = 0;
+  weather.attempt++;
+  err_t e = dns_gethostbyname(WEATHER_HOST, &weather.ip, weatherDnsFound, (void *)(uintptr_t)weather.attempt);
+  if (e != ERR_OK) return e == ERR_INPROGRESS;
+  weather.dnsMs = now;   // answered from lwIP's own cache
+  return weatherConnect();
+}
+
+static bool weatherSendRequest() {
+  // HTTP/1.0: no chunked body and the server closes when done
+  char req[192];
+  int n = snprintf(req, sizeof(req), "GET /data/2.5/weather?id=%s&units=metric&appid=%s HTTP/1.0\r\nHost: %s\r\n\r\n",
+                   OPENWEATHER_CITY_ID, OPENWEATHER_API_KEY, WEATHER_HOST);
+  if (n >= (int)sizeof(req) || n > (int)tcp_sndbuf(weather.pcb)) return false;
+  if (tcp_write(weather.pcb, req, n, TCP_WRITE_FLAG_COPY) != ERR_OK) return false;
+  tcp_output(weather.pcb);
+
+  weather.state = WX_STATUS;
+  weather.startMs = millis();
+  weather.lineLen = 0;
+  weather.eolMatch = 0;
+  weather.status = 0;
+  weatherJson.reset();
+  return true;
+}
+
+void weatherStep() {
+  uint32_t now = millis();
+  switch (weather.state) {
+    case WX_IDLE:
+      if ((int32_t)(now - weather.nextAttemptMs) < 0 || WiFi.status() != WL_CONNECTED) return;
+      if (!weatherStart()) weatherFinish(false);
+      return;
+    case WX_DNS:
+      if (weather.dnsResult > 0) {
+        weather.dnsMs = now;
+        if (!weatherConnect()) weatherFinish(false);
+      } else if (weather.dnsResult < 0 || now - weather.startMs > WEATHER_CONNECT_TIMEOUT_MS) {
+        weatherFinish(false);
       }
+      return;
+    case WX_CONNECT:
+      if (weather.failed || now - weather.startMs > WEATHER_CONNECT_TIMEOUT_MS) weatherFinish(false);
+      else if (weather.connected && !weatherSendRequest()) weatherFinish(false);
+      return;
+    default:
+      break;
+  }
+  if (now - weather.startMs > WEATHER_RESPONSE_TIMEOUT_MS) { weatherFinish(false); return; }
+
+  if (!weather.rx) {
+    if (weather.closed || weather.failed) weatherFinish(weather.state == WX_BODY && weatherJson.done());
+    return;
+  }
+  char chunk[128];
+  int n = pbuf_copy_partial(weather.rx, chunk, sizeof(chunk), 0);
+  weather.rx = pbuf_free_header(weather.rx, n);
+  if (weather.pcb) tcp_recved(weather.pcb, n);
+  for (int i = 0; i < n; i++) {
+    char c = chunk[i];
+    switch (weather.state) {
+      case WX_STATUS:
+        // "HTTP/1.1 200 OK": the code follows the first space
+        if (c != '\n' && weather.lineLen < sizeof(weather.line) - 1) weather.line[weather.lineLen++] = c;
+        if (c != '\n') break;
+        weather.line[weather.lineLen] = 0;
+        {
+          const char *sp = strchr(weather.line, ' ');
+          weather.status = sp ? atoi(sp + 1) : 0;
+        }
+        if (weather.status != 200) { weatherFinish(false); return; }
+        weather.state = WX_HEADERS;
+        weather.eolMatch = 2;   // the status line's CRLF counts toward the blank line
+        break;
+      case WX_HEADERS:
+        if (c == (weather.eolMatch & 1 ? '\n' : '\r')) weather.eolMatch++;
+        else weather.eolMatch = c == '\r' ? 1 : 0;
+        if (weather.eolMatch == 4) weather.state = WX_BODY;
+        break;
+      case WX_BODY:
+        weatherJson.feed(c);
+        if (weatherJson.done()) { weatherFinish(true); return; }
+        if (weatherJson.failed()) { weatherFinish(false); return; }
+        break;
+      default:
+        break;
     }
-    int mainIdx = payload.indexOf("\"main\":\"");
-    if (mainIdx > 0) {
-      int mainStart = mainIdx + 8;
-      int mainEnd = payload.indexOf("\"", mainStart);
-      if (mainEnd > mainStart) {
-        String mainStr = payload.substring(mainStart, mainEnd);
-        strncpy(weatherMain, mainStr.c_str(), sizeof(weatherMain)-1);
-        weatherMain[sizeof(weatherMain)-1] = '\0';
+  }
+}
+
+// Wall time in ms as the display sees it: the anchor plus elapsed millis(),
+// plus as much of the pending slew as the elapsed time allows. Its rate stays
+// within 10% of real time either way, so it never runs backwards.
+static int64_t clockWallMs() {
+  uint32_t elapsed = millis() - clockAnchorMs;
+  int32_t limit = elapsed / CLOCK_SLEW_DIV;
+  return (int64_t)clockAnchorEpoch * 1000 + elapsed + constrain(clockSlewMs, -limit, limit);
+}
+
+// Re-anchor on the system clock including its sub-second part. Once synced,
+// an error up to CLOCK_STEP_MS (millis() drift between re-anchors) is slewed
+// out in either direction so seconds neither repeat nor skip; a larger one
+// is stepped.
+static void clockAnchor(const timeval &tv) {
+  uint32_t now = millis();
+  int64_t wall = (int64_t)tv.tv_sec * 1000 + tv.tv_usec / 1000;
+  if (ntpSynced) {
+    int64_t shown = clockWallMs();
+    int64_t err = wall - shown;
+    if (err >= -CLOCK_STEP_MS && err <= CLOCK_STEP_MS) {
+      clockAnchorEpoch = shown / 1000;
+      clockAnchorMs = now - (uint32_t)(shown % 1000);
+      clockSlewMs = (int32_t)err;
+      return;
+    }
+  }
+  clockAnchorEpoch = tv.tv_sec;
+  clockAnchorMs = now - tv.tv_usec / 1000;
+  clockSlewMs = 0;
+}
+
+time_t clockNow() {
+  return clockWallMs() / 1000;
+}
+
+// Broken-down local time, recomputed at most once per second
+const struct tm *clockLocal() {
+  static struct tm cached;
+  static time_t cachedFor = 0;
+  time_t t = clockNow();
+  if (t != cachedFor) { localtime_r(&t, &cached); cachedFor = t; }
+  return &cached;
+}
+
+// SNTP runs in the background once configTime() starts it; we only poll.
+// No answer within NTP_WAIT_MS restarts it after an exponential backoff.
+void ntpStep() {
+  uint32_t now = millis();
+  switch (ntpState) {
+    case NTP_IDLE:
+      if ((int32_t)(now - ntpStateMs) < 0 || WiFi.status() != WL_CONNECTED) return;
+      configTime(19800, 0, "pool.ntp.org", "time.nist.gov");
+      ntpState = NTP_WAITING;
+      ntpStateMs = now;
+      return;
+    case NTP_WAITING: {
+      timeval tv;
+      gettimeofday(&tv, nullptr);
+      if (tv.tv_sec > 1600000000) {
+        clockAnchor(tv);
+        ntpSynced = true;
+        ntpState = NTP_SYNCED;
+        ntpStateMs = now;
+        ntpRetryMs = 0;
+      } else if (now - ntpStateMs > NTP_WAIT_MS) {
+        ntpRetryMs = ntpRetryMs ? iMin(ntpRetryMs * 2, NTP_RETRY_MAX_MS) : NTP_RETRY_MIN_MS;
+        ntpState = NTP_IDLE;
+        ntpStateMs = now + ntpRetryMs;
       }
+      return;
+    }
+    case NTP_SYNCED: {
+      if (now - ntpStateMs < NTP_REANCHOR_MS) return;
+      timeval tv;
+      gettimeofday(&tv, nullptr);
+      clockAnchor(tv);
+      ntpStateMs = now;
+      return;
     }
-    weatherLastFetch = millis();
   }
-  http.end();
 }
 
-void syncNTP() {
-  if (ntpSynced || WiFi.status() != WL_CONNECTED) return;
-  configTime(19800, 0, "pool.ntp.org", "time.nist.gov");
-  unsigned long start = millis();
-  while (millis() - start < 10000) {
-    currentTime = time(nullptr);
-    if (currentTime > 1600000000) { ntpSynced = true; break; }
-    delay(200);
+// ---------------- PROFILER ----------------
+static uint8_t profBucket(uint32_t us) {
+  if (us < 2) return us;
+  uint8_t lg = 31 - __builtin_clz(us);
+  uint8_t b = lg * 2 + ((us >> (lg - 1)) & 1);
+  return b < PROF_BUCKETS ? b : PROF_BUCKETS - 1;
+}
+
+// Upper edge of bucket b in microseconds
+static uint32_t profBucketLimit(uint8_t b) {
+  if (b < 2) return b + 1;
+  uint32_t base = 1UL << (b / 2);
+  return (b & 1) ? base * 2 : base + base / 2;
+}
+
+void profRecord(uint8_t stage, uint32_t cycles) {
+  ProfStat &s = profStats[stage];
+  if (!s.count || cycles < s.minCyc) s.minCyc = cycles;
+  if (cycles > s.maxCyc) s.maxCyc = cycles;
+  s.sumCyc += cycles;
+  s.count++;
+  uint16_t &h = s.hist[profBucket(cycles / ESP.getCpuFreqMHz())];
+  if (h == 0xFFFF) {
+    for (int i = 0; i < PROF_BUCKETS; i++) s.hist[i] >>= 1;
+  }
+  h++;
+}
+
+uint32_t profPercentileUs(const ProfStat &s, uint8_t pct) {
+  uint32_t total = 0;
+  for (int i = 0; i < PROF_BUCKETS; i++) total += s.hist[i];
+  if (!total) return 0;
+  uint32_t want = (total * pct + 99) / 100, acc = 0;
+  for (int i = 0; i < PROF_BUCKETS; i++) {
+    acc += s.hist[i];
+    if (acc >= want) return profBucketLimit(i);
+  }
+  return profBucketLimit(PROF_BUCKETS - 1);
+}
+
+void profReset() {
+  memset(profStats, 0, sizeof(profStats));
+}
+
+void profSampleHeap() {
+  freeHeap = ESP.getFreeHeap();
+  maxFreeBlock = ESP.getMaxFreeBlockSize();
+  heapFrag = ESP.getHeapFragmentation();
+}
+
+class ProfScope {
+public:
+  explicit ProfScope(uint8_t stage) : stage_(stage), start_(ESP.getCycleCount()) {}
+  ~ProfScope() { profRecord(stage_, ESP.getCycleCount() - start_); }
+private:
+  uint8_t stage_;
+  uint32_t start_;
+};
+
+// Stage with the worst p99 since the last reset
+int profWorstStage(uint32_t &p99) {
+  int worst = -1; p99 = 0;
+  for (int i = 0; i < PROF_COUNT; i++) {
+    uint32_t v = profPercentileUs(profStats[i], 99);
+    if (v > p99) { p99 = v; worst = i; }
   }
+  return worst;
+}
+
+// ---------------- JSON WRITER ----------------
+// Formats straight into a caller-owned buffer; no String temporaries.
+// Output is truncated (and overflow set) rather than reallocated.
+struct JsonWriter {
+  char *buf;
+  size_t cap, len;
+  bool needComma, overflow;
+
+  JsonWriter(char *b, size_t c) : buf(b), cap(c), len(0), needComma(false), overflow(false) { if (cap) buf[0] = 0; }
+
+  void put(char c) {
+    if (len + 1 < cap) { buf[len++] = c; buf[len] = 0; }
+    else overflow = true;
+  }
+  void put(const char *s) { while (*s) put(*s++); }
+  void putUInt(uint32_t v) {
+    char tmp[10]; int n = 0;
+    do { tmp[n++] = '0' + v % 10; v /= 10; } while (v);
+    while (n) put(tmp[--n]);
+  }
+  void putStr(const char *s, size_t maxLen = SIZE_MAX) {
+    put('"');
+    for (size_t i = 0; i < maxLen && s[i]; i++) {
+      char c = s[i];
+      if (c == '"' || c == '\\') { put('\\'); put(c); }
+      else if ((uint8_t)c < 0x20) { put("\\u00"); put("0123456789abcdef"[c >> 4]); put("0123456789abcdef"[c & 15]); }
+      else put(c);
+    }
+    put('"');
+  }
+  void key(const char *k) {
+    if (needComma) put(',');
+    putStr(k); put(':');
+    needComma = true;
+  }
+
+  void beginObject() { if (needComma) put(','); put('{'); needComma = false; }
+  void endObject() { put('}'); needComma = true; }
+  void beginObject(const char *k) { key(k); put('{'); needComma = false; }
+
+  void add(const char *k, const char *v, size_t maxLen = SIZE_MAX) { key(k); putStr(v, maxLen); }
+  void add(const char *k, int32_t v) {
+    key(k);
+    if (v < 0) { put('-'); putUInt(0u - (uint32_t)v); }
+    else putUInt(v);
+  }
+  void add(const char *k, bool v) { key(k); put(v ? "true" : "false"); }
+
+  static uint32_t pow10(uint8_t dec) {
+    uint32_t scale = 1;
+    while (dec--) scale *= 10;
+    return scale;
+  }
+  // `mag` is the magnitude already scaled by 10^dec
+  void putFixed(bool neg, uint32_t mag, uint8_t dec) {
+    uint32_t scale = pow10(dec);
+    if (neg && mag) put('-');
+    putUInt(mag / scale);
+    if (!dec) return;
+    put('.');
+    uint32_t frac = mag % scale;
+    for (uint32_t d = scale / 10; d; d /= 10) { put('0' + frac / d); frac %= d; }
+  }
+  // Integer holding value * 10^dec, e.g. tenths with dec = 1
+  void addFixed(const char *k, int32_t v, uint8_t dec) {
+    key(k);
+    putFixed(v < 0, v < 0 ? 0u - (uint32_t)v : (uint32_t)v, dec);
+  }
+  // Q16.16 value with `dec` (>= 1) decimals, byte-identical to String(float, dec)
+  // on the published float copy: the core's dtostrf keeps the sign of values
+  // that round to zero ("-0.0") and rounds by adding 0.5 ulp in double, which
+  // lands either way on exact ties (0.25 -> "0.3" but 2.25 -> "2.2"). Integer math
+  // gives the same digits everywhere except on ties, which go to dtostrf.
+  void addQ16(const char *k, q16_t v, uint8_t dec) {
+    key(k);
+    q16_t f = (q16_t)(float)v;   // the float copy has 24 bits: large values round
+    uint32_t mag = f < 0 ? 0u - (uint32_t)f : (uint32_t)f;
+    uint64_t scaled = (uint64_t)mag * pow10(dec);
+    if ((scaled & 0xFFFF) == 0x8000) { char t[24]; put(dtostrf(f / 65536.0f, dec + 2, dec, t)); return; }
+    if (f < 0) put('-');
+    putFixed(false, (uint32_t)((scaled + 32768) >> 16), dec);
+  }
+
+  void addIP(const char *k, const IPAddress &ip) {
+    key(k); put('"');
+    for (int i = 0; i < 4; i++) { if (i) put('.'); putUInt(ip[i]); }
+    put('"');
+  }
+};
+
+void sendJson(int code, const JsonWriter &w) {
+  if (w.overflow) { server.send(500, "text/plain", "json overflow"); return; }
+  server.send(code, "application/json", w.buf, w.len);
 }
 
 // ---------------- WEB SERVER ----------------
+// Page lives in flash pre-gzipped (dashboard.html -> tools/gen_dashboard.py)
 void handleRoot() {
-  String html = R"rawliteral(
-<!DOCTYPE html>
-<html>
-<head>
-<meta name='viewport' content='width=device-width,initial-scale=1'>
-<style>
-body{font-family:Arial;background:#111;color:#fff;margin:0;padding:20px}
-.card{background:#222;border-radius:8px;padding:15px;margin:10px 0}
-h1{color:#07FF}
-.btn{background:#07FF;color:#000;border:none;padding:12px 24px;font-size:16px;border-radius:5px;cursor:pointer;margin:5px}
-.btn:hover{background:#05DD}
-.btn-warn{background:#FBE0}
-.value{color:#07FF;font-size:20px}
-#msgBox{width:100%;padding:10px;font-size:14px;margin-top:10px;background:#333;color:#fff;border:1px solid #07FF;border-radius:5px}
-</style>
-</head>
-<body>
-<h1>MiniConsole Monitor</h1>
-<div class='card'>
-<h2>Sensors (Live)</h2>
-<p>Pitch: <span class='value' id='pitch'>--</span>°</p>
-<p>Roll: <span class='value' id='roll'>--</span>°</p>
-<p>Yaw: <span class='value' id='yaw'>--</span>°</p>
-</div>
-<div class='card'>
-<h2>Network</h2>
-<p>SSID: <span class='value' id='ssid'>--</span></p>
-<p>IP: <span class='value' id='ip'>--</span></p>
-<p>Signal: <span class='value' id='rssi'>--</span> dBm</p>
-</div>
-<div class='card'>
-<h2>Controls</h2>
-<button class='btn btn-warn' onclick='triggerBeep()'>Trigger Beep on Device</button>
-<h3>Send Message to Device</h3>
-<input type='text' id='msgBox' placeholder='Type message...' maxlength='40'>
-<button class='btn' onclick='sendMessage()'>Send to Device</button>
-<p id='status'></p>
-</div>
-<script>
-function triggerBeep(){
-fetch('/beep').then(r=>r.text()).then(d=>{
-document.getElementById('status').innerHTML='<span style="color:#07E0">'+d+'</span>';
-setTimeout(()=>document.getElementById('status').innerHTML='',2000);
-})}
-function sendMessage(){
-let msg=document.getElementById('msgBox').value;
-if(!msg){alert('Please enter a message');return;}
-fetch('/message?text='+encodeURIComponent(msg)).then(r=>r.text()).then(d=>{
-document.getElementById('status').innerHTML='<span style="color:#07E0">'+d+'</span>';
-document.getElementById('msgBox').value='';
-setTimeout(()=>document.getElementById('status').innerHTML='',2000);
-})}
-setInterval(()=>{
-fetch('/api').then(r=>r.json()).then(d=>{
-document.getElementById('pitch').textContent=d.pitch;
-document.getElementById('roll').textContent=d.roll;
-document.getElementById('yaw').textContent=d.yaw;
-document.getElementById('ssid').textContent=d.ssid;
-document.getElementById('ip').textContent=d.ip;
-document.getElementById('rssi').textContent=d.rssi;
-})},500);
-</script>
-</body>
-</html>
-)rawliteral";
-  server.send(200, "text/html", html);
+  server.sendHeader("ETag", DASHBOARD_ETAG);
+  server.sendHeader("Cache-Control", "no-cache");
+  if (server.header("If-None-Match").indexOf(DASHBOARD_ETAG) >= 0) {
+    server.send(304);
+    return;
+  }
+  server.sendHeader("Content-Encoding", "gzip");
+  server.send_P(200, "text/html", (PGM_P)DASHBOARD_HTML_GZ, DASHBOARD_HTML_GZ_LEN);
 }
 
 void handleAPI() {
-  String json = "{";
-  json += "\"pitch\":" + String(pitch_filtered, 1) + ",";
-  json += "\"roll\":" + String(roll_filtered, 1) + ",";
-  json += "\"yaw\":" + String(yaw_filtered, 1) + ",";
-  json += "\"ssid\":\"" + WiFi.SSID() + "\",";
-  json += "\"ip\":\"" + WiFi.localIP().toString() + "\",";
-  json += "\"rssi\":" + String(WiFi.RSSI());
-  json += "}";
-  server.send(200, "application/json", json);
+  char buf[288];
+  JsonWriter w(buf, sizeof(buf));
+  struct station_config conf;
+  wifi_station_get_config(&conf);
+
+  w.beginObject();
+  w.addQ16("pitch", pitch_fq, 1);
+  w.addQ16("roll", roll_fq, 1);
+  w.addQ16("yaw", yaw_fq, 1);
+  w.add("ssid", (const char *)conf.ssid, sizeof(conf.ssid));
+  w.addIP("ip", WiFi.localIP());
+  w.add("rssi", (int32_t)WiFi.RSSI());
+  if (weatherLastFetch) {
+    w.beginObject("weather");
+    w.addFixed("temp", weatherTempTenths, 1);
+    w.add("main", weatherMain);
+    if (weatherHumidity >= 0) w.add("humidity", (int32_t)weatherHumidity);
+    if (weatherWindTenths >= 0) w.addFixed("wind", weatherWindTenths, 1);
+    w.endObject();
+  }
+  w.endObject();
+  sendJson(200, w);
+}
+
+void handleMetrics() {
+  if (server.hasArg("overlay")) {
+    profOverlay = server.arg("overlay") != "0";
+    markDirty(0, 0, DISP_W, STATUS_BAR_H);
+  }
+  profSampleHeap();
+  char buf[1024];
+  int n = snprintf(buf, sizeof(buf), "heap %lu maxblk %lu frag %u%%\nfps %.0f px %lu win %lu fifo %lu ovf %lu\n%s\n"
+                   "stage n min avg max p99 (us)\n",
+                   (unsigned long)freeHeap, (unsigned long)maxFreeBlock, heapFrag, fps,
+                   (unsigned long)gfx.pixelsPushed, (unsigned long)gfx.windowsOpened,
+                   (unsigned long)mpuFifoSamples, (unsigned long)mpuFifoOverflows, bootBreakdown);
+  uint32_t mhz = ESP.getCpuFreqMHz();
+  for (int i = 0; i < PROF_COUNT && n < (int)sizeof(buf); i++) {
+    const ProfStat &s = profStats[i];
+    uint32_t avg = s.count ? (uint32_t)(s.sumCyc / s.count / mhz) : 0;
+    n += snprintf(buf + n, sizeof(buf) - n, "%s %lu %lu %lu %lu %lu\n", profNames[i], (unsigned long)s.count,
+                  (unsigned long)(s.minCyc / mhz), (unsigned long)avg, (unsigned long)(s.maxCyc / mhz),
+                  (unsigned long)profPercentileUs(s, 99));
+  }
+  for (int i = 0; i < SSE_MAX_CLIENTS && n < (int)sizeof(buf); i++) {
+    SseClient &s = sseClients[i];
+    if (s.client.connected())
+      n += snprintf(buf + n, sizeof(buf) - n, "sse%d %lums sent %lu dropped %lu\n", i, (unsigned long)s.intervalMs,
+                    (unsigned long)s.sent, (unsigned long)s.dropped);
+  }
+  if (server.hasArg("reset")) profReset();
+  server.send(200, "text/plain", buf);
+}
+
+// Server-Sent Events: the connection is kept open after the handler returns
+// and frames are pushed from taskPush(). A client whose socket can't take a
+// whole frame skips it, so slow viewers see fresh data rather than a backlog.
+void handleEvents() {
+  int slot = -1;
+  for (int i = 0; i < SSE_MAX_CLIENTS; i++) {
+    if (!sseClients[i].client.connected()) { slot = i; break; }
+  }
+  if (slot < 0) { server.send(503, "text/plain", "Too many subscribers"); return; }
+
+  uint32_t hz = server.hasArg("hz") ? server.arg("hz").toInt() : SSE_RATE_HZ;
+  hz = constrain(hz, 1, SSE_MAX_HZ);
+
+  SseClient &s = sseClients[slot];
+  s.client = server.client();
+  s.client.setNoDelay(true);
+  s.client.print(F("HTTP/1.1 200 OK\r\nContent-Type: text/event-stream\r\n"
+                   "Cache-Control: no-cache\r\nConnection: keep-alive\r\n\r\nretry: 2000\n\n"));
+  s.intervalMs = 1000 / hz;
+  s.lastSentMs = millis();
+  s.sent = s.dropped = 0;
+}
+
+void ssePush() {
+  char frame[96];
+  int len = -1;
+  uint32_t now = millis();
+  for (int i = 0; i < SSE_MAX_CLIENTS; i++) {
+    SseClient &s = sseClients[i];
+    if (!s.client.connected()) { s.client = WiFiClient(); continue; }  // release a dropped socket
+    if (now - s.lastSentMs < s.intervalMs) continue;
+    s.lastSentMs = now;
+
+    if (len < 0) {
+      // "data: " prefix + compact JSON, built once per push for all clients
+      memcpy(frame, "data: ", 6);
+      JsonWriter w(frame + 6, sizeof(frame) - 8);
+      w.beginObject();
+      w.addQ16("pitch", pitch_fq, 1);
+      w.addQ16("roll", roll_fq, 1);
+      w.addQ16("yaw", yaw_fq, 1);
+      w.endObject();
+      len = 6 + w.len;
+      frame[len++] = '\n'; frame[len++] = '\n';
+    }
+    if (s.client.availableForWrite() < (size_t)len) { s.dropped++; continue; }
+    s.client.write((const uint8_t *)frame, len);
+    s.sent++;
+  }
+}
+
+// IMU history straight out of the telemetry ring. Binary (default):
+// "MCT1", u8 channels, u8 blocks, then per block u16 used, u16 count and the
+// block bytes, all little-endian; decode with tools/telemetry_decode.py.
+// ?format=csv decodes on the device in small chunks instead.
+void handleHistory() {
+  uint8_t blocks = telemFilled;
+  if (server.arg("format") == "csv") {
+    char chunk[512];
+    int n = snprintf(chunk, sizeof(chunk), "ms,ax,ay,az,gx,gy,gz,pitch_cdeg,roll_cdeg,yaw_cdeg\n");
+    server.setContentLength(CONTENT_LENGTH_UNKNOWN);
+    server.send(200, "text/csv", "");
+    for (uint8_t i = 0; i < blocks; i++) {
+      telemDecodeBlock(i, [&](uint32_t ms, const int32_t *v) {
+        if (n > (int)sizeof(chunk) - 80) { server.sendContent(chunk, n); n = 0; }
+        n += snprintf(chunk + n, sizeof(chunk) - n, "%lu,%ld,%ld,%ld,%ld,%ld,%ld,%ld,%ld,%ld\n", (unsigned long)ms,
+                      (long)v[0], (long)v[1], (long)v[2], (long)v[3], (long)v[4], (long)v[5], (long)v[6], (long)v[7], (long)v[8]);
+      });
+    }
+    if (n) server.sendContent(chunk, n);
+    server.sendContent("");
+    return;
+  }
+
+  size_t total = 6;
+  for (uint8_t i = 0; i < blocks; i++)
+    total += 4 + telemBlockAt(i).used;
+  uint8_t hdr[6] = { 'M', 'C', 'T', '1', TELEM_CHANNELS, blocks };
+  server.setContentLength(total);
+  server.send(200, "application/octet-stream", "");
+  server.sendContent((const char *)hdr, sizeof(hdr));
+  for (uint8_t i = 0; i < blocks; i++) {
+    const TelemBlock &b = telemBlockAt(i);
+    server.sendContent((const char *)&b, 4 + b.used);
+  }
 }
 
 void handleBeep() {
@@ -545,91 +2211,249 @@ void handleBeep() {
   server.send(200, "text/plain", "Beep triggered on device!");
 }
 
-void handleMessage() {
-  if (server.hasArg("text")) {
-    webMessage = server.arg("text");
-    webMessage = webMessage.substring(0, 40); // Limit length
-    messageTime = millis();
-    messageActive = true;
-    server.send(200, "text/plain", "Message sent to device!");
-  } else {
-    server.send(400, "text/plain", "Missing text parameter");
-  }
+void handleMessage() {
+  if (server.hasArg("text")) {
+    webMessage = server.arg("text");
+    webMessage = webMessage.substring(0, 40); // Limit length
+    messageTime = millis();
+    messageActive = true;
+    server.send(200, "text/plain", "Message sent to device!");
+  } else {
+    server.send(400, "text/plain", "Missing text parameter");
+  }
+}
+
+// ---------------- DAMAGE TRACKING ----------------
+static inline bool rectsTouch(const DirtyRect &a, const DirtyRect &b) {
+  return a.x <= b.x + b.w && b.x <= a.x + a.w && a.y <= b.y + b.h && b.y <= a.y + a.h;
+}
+
+static inline DirtyRect rectUnion(const DirtyRect &a, const DirtyRect &b) {
+  int x1 = iMin(a.x, b.x), y1 = iMin(a.y, b.y);
+  int x2 = iMax(a.x + a.w, b.x + b.w), y2 = iMax(a.y + a.h, b.y + b.h);
+  DirtyRect r = { (int16_t)x1, (int16_t)y1, (int16_t)(x2 - x1), (int16_t)(y2 - y1) };
+  return r;
+}
+
+// Report a changed screen region. Touching rects are merged; when the list is
+// full the new rect is folded into whichever existing one grows the least.
+void markDirty(int x, int y, int w, int h) {
+  if (x < 0) { w += x; x = 0; }
+  if (y < 0) { h += y; y = 0; }
+  if (x + w > DISP_W) w = DISP_W - x;
+  if (y + h > DISP_H) h = DISP_H - y;
+  if (w <= 0 || h <= 0) return;
+  DirtyRect r = { (int16_t)x, (int16_t)y, (int16_t)w, (int16_t)h };
+
+  for (;;) {
+    bool merged = false;
+    for (int i = 0; i < dirtyCount; i++) {
+      if (rectsTouch(dirtyRects[i], r)) {
+        r = rectUnion(r, dirtyRects[i]);
+        dirtyRects[i] = dirtyRects[--dirtyCount];
+        merged = true; break;
+      }
+    }
+    if (merged) continue;
+    if (dirtyCount < MAX_DIRTY_RECTS) break;
+    int best = 0; long bestGrow = 0x7FFFFFFFL;
+    for (int i = 0; i < dirtyCount; i++) {
+      DirtyRect u = rectUnion(r, dirtyRects[i]);
+      long grow = (long)u.w * u.h - (long)dirtyRects[i].w * dirtyRects[i].h;
+      if (grow < bestGrow) { bestGrow = grow; best = i; }
+    }
+    r = rectUnion(r, dirtyRects[best]);
+    dirtyRects[best] = dirtyRects[--dirtyCount];
+  }
+  dirtyRects[dirtyCount++] = r;
+}
+
+// Repaint only the damaged regions. Each region is split into TILE_H-row
+// bands; for every band the app's draw routine is re-run into the RAM strip
+// and the band is pushed to the panel in one address-window write.
+// The list is taken before drawing, so damage marked by a draw routine
+// (e.g. a dial that was only partly repainted) is kept for the next frame.
+void flushDamage() {
+  if (dirtyCount == 0) return;
+  DirtyRect rects[MAX_DIRTY_RECTS];
+  int count = dirtyCount;
+  memcpy(rects, dirtyRects, sizeof(DirtyRect) * count);
+  dirtyCount = 0;
+  bool cursorHit = false;
+  for (int i = 0; i < count; i++) {
+    const DirtyRect &r = rects[i];
+    for (int by = r.y; by < r.y + r.h; by += TILE_H) {
+      DirtyRect band = { r.x, (int16_t)by, r.w, (int16_t)iMin(TILE_H, r.y + r.h - by) };
+      gfx.beginBand(band, r);
+      if (band.y + band.h > STATUS_BAR_H) drawApp();
+      if (band.y < STATUS_BAR_H) drawStatusBar();
+      if (messageActive && gfx.touchesClip(WEB_MSG_X, WEB_MSG_Y, WEB_MSG_W, WEB_MSG_H)) drawWebMessage();
+      gfx.flushBand();
+    }
+    DirtyRect cur = { (int16_t)(cursorX - CURSOR_SIZE), (int16_t)(cursorY - CURSOR_SIZE),
+                      (int16_t)(CURSOR_SIZE*2 + 1), (int16_t)(CURSOR_SIZE*2 + 1) };
+    if (rectsTouch(r, cur)) cursorHit = true;
+  }
+  if (cursorHit) drawCursor(cursorX, cursorY);
+}
+
+// ---------------- DIAL WIDGET ----------------
+// Retained-mode dial. The static face is drawn once; the part of it inside
+// the hands' reach is also rasterised into a 1-bit mask, so moving a hand
+// only rewrites that hand's own pixels and puts back any face pixels it was
+// covering. A hand with deg < 0 is hidden.
+class DialMaskGFX : public Adafruit_GFX {
+public:
+  DialMaskGFX(int16_t ox, int16_t oy) : Adafruit_GFX(DISP_W, DISP_H), ox(ox), oy(oy) {}
+  void drawPixel(int16_t x, int16_t y, uint16_t) override {
+    int mx = x - ox, my = y - oy;
+    if (mx < 0 || my < 0 || mx >= DIAL_MASK_SIDE || my >= DIAL_MASK_SIDE) return;
+    int bit = my * DIAL_MASK_SIDE + mx;
+    dialMask[bit >> 3] |= 1 << (bit & 7);
+  }
+private:
+  int16_t ox, oy;
+};
+
+static bool dialMaskAt(const Dial &d, int x, int y) {
+  int mx = x - (d.cx - DIAL_MAX_REACH), my = y - (d.cy - DIAL_MAX_REACH);
+  if (mx < 0 || my < 0 || mx >= DIAL_MASK_SIDE || my >= DIAL_MASK_SIDE) return false;
+  int bit = my * DIAL_MASK_SIDE + mx;
+  return dialMask[bit >> 3] & (1 << (bit & 7));
+}
+
+// Same pixel walk as Adafruit_GFX::writeLine, restoring the face under a hand
+static void dialEraseHand(const Dial &d, int x0, int y0, int x1, int y1) {
+  bool steep = abs(y1 - y0) > abs(x1 - x0);
+  if (steep) { int t = x0; x0 = y0; y0 = t; t = x1; x1 = y1; y1 = t; }
+  if (x0 > x1) { int t = x0; x0 = x1; x1 = t; t = y0; y0 = y1; y1 = t; }
+  int dx = x1 - x0, dy = abs(y1 - y0), err = dx / 2, ystep = (y0 < y1) ? 1 : -1;
+  gfx.startWrite();
+  for (; x0 <= x1; x0++) {
+    int px = steep ? y0 : x0, py = steep ? x0 : y0;
+    gfx.writePixel(px, py, dialMaskAt(d, px, py) ? d.faceColor : C_BG);
+    err -= dy;
+    if (err < 0) { y0 += ystep; err += dx; }
+  }
+  gfx.endWrite();
+}
+
+// The drawn position is only recorded when the repaint covers the whole
+// dial. A partial repaint leaves the old hand outside its clip, so if a hand
+// has moved the whole dial is queued for the next frame instead.
+static void dialDrawHands(Dial &d) {
+  int x0 = d.cx - DIAL_MAX_REACH, y0 = d.cy - DIAL_MAX_REACH;
+  bool whole = gfx.paintsWhole(x0, y0, DIAL_MASK_SIDE, DIAL_MASK_SIDE);
+  bool moved = false;
+  for (int i = 0; i < d.handCount; i++) {
+    DialHand &h = d.hands[i];
+    if (h.deg != h.drawnDeg) moved = true;
+    int x = d.cx, y = d.cy;
+    if (h.deg >= 0) {
+      dialPoint(d.cx, d.cy, h.len, h.deg, x, y);
+      gfx.drawLine(d.cx, d.cy, x, y, h.color);
+    }
+    if (whole) { h.drawnDeg = h.deg; h.x = x; h.y = y; }
+  }
+  gfx.fillCircle(d.cx, d.cy, 2, C_FG);
+  if (!whole && moved) markDirty(x0, y0, DIAL_MASK_SIDE, DIAL_MASK_SIDE);
+}
+
+// Full draw of face and hands (used by the app's draw routine)
+void dialDraw(Dial &d) {
+  if (dialMaskOwner != &d) {
+    memset(dialMask, 0, sizeof(dialMask));
+    DialMaskGFX mask(d.cx - DIAL_MAX_REACH, d.cy - DIAL_MAX_REACH);
+    d.face(d, mask);
+    dialMaskOwner = &d;
+  }
+  d.face(d, gfx);
+  dialDrawHands(d);
+}
+
+void dialSetHand(Dial &d, int i, int deg) {
+  if (deg >= 0) deg %= 360;
+  d.hands[i].deg = deg;
+}
+
+// Incremental update: erase only the hands that moved, then redraw the hands
+// and hub (a moved hand may have crossed another one near the hub).
+void dialUpdate(Dial &d) {
+  bool moved = false;
+  for (int i = 0; i < d.handCount; i++) {
+    DialHand &h = d.hands[i];
+    if (h.deg == h.drawnDeg) continue;
+    if (h.drawnDeg >= 0) dialEraseHand(d, d.cx, d.cy, h.x, h.y);
+    moved = true;
+  }
+  if (moved) dialDrawHands(d);
 }
 
 // ---------------- UI PRIMITIVES ----------------
 void drawStatusBar() {
-  tft.fillRect(0,0,DISP_W,STATUS_BAR_H,C_PANEL);
-  tft.setTextSize(1); tft.setTextColor(C_FG);
-  if (WiFi.status() == WL_CONNECTED) tft.fillCircle(5,5,2,C_SUCCESS); 
-  else tft.drawCircle(5,5,2,C_ERROR);
-  if (ntpSynced) {
-    time_t nowt = time(nullptr); struct tm *tm_info = localtime(&nowt);
+  gfx.fillRect(0,0,DISP_W,STATUS_BAR_H,C_PANEL);
+  gfx.setTextSize(1); gfx.setTextColor(C_FG);
+  if (WiFi.status() == WL_CONNECTED) gfx.fillCircle(5,5,2,C_SUCCESS); 
+  else gfx.drawCircle(5,5,2,C_ERROR);
+  if (profOverlay) {
+    // Heap/max block in KB plus the slowest stage's p99
+    uint32_t p99; int worst = profWorstStage(p99);
+    gfx.setCursor(12,2);
+    gfx.printf("%luK/%luK", (unsigned long)(freeHeap >> 10), (unsigned long)(maxFreeBlock >> 10));
+    if (worst >= 0) {
+      gfx.setTextColor(p99 > 1000000UL / target_fps ? C_WARN : C_FG);
+      if (p99 >= 10000) gfx.printf(" %.5s %lum", profNames[worst], (unsigned long)(p99 / 1000));
+      else gfx.printf(" %.5s %luu", profNames[worst], (unsigned long)p99);
+      gfx.setTextColor(C_FG);
+    }
+  } else if (ntpSynced) {
+    const struct tm *tm_info = clockLocal();
     char buf[20]; snprintf(buf, sizeof(buf), "%02d/%02d %02d:%02d", tm_info->tm_mday, tm_info->tm_mon+1, tm_info->tm_hour, tm_info->tm_min);
-    tft.setCursor(30,2); tft.print(buf);
+    gfx.setCursor(30,2); gfx.print(buf);
   } else {
-    tft.setCursor(30,2); tft.printf("U:%lus", millis()/1000);
+    gfx.setCursor(30,2); gfx.printf("U:%lus", millis()/1000);
   }
-  tft.setCursor(DISP_W - 46, 2); tft.printf("FPS:%2.0f", fps);
+  gfx.setCursor(DISP_W - 46, 2); gfx.printf("FPS:%2.0f", fps);
 }
 
-void drawHome() {
-  tft.fillRect(0,STATUS_BAR_H,DISP_W,DISP_H-STATUS_BAR_H,C_BG);
-  int cx = 40, cy = STATUS_BAR_H + 36, r = 28;
-  tft.drawCircle(cx, cy, r, C_FG);
+void drawHomeFace(const Dial &d, Adafruit_GFX &g) {
+  g.drawCircle(d.cx, d.cy, d.r, C_FG);
   for (int i=0;i<12;i++) {
-    float a = i * 30.0 * PI / 180.0;
-    int x1 = cx + (r-6)*sin(a), y1 = cy - (r-6)*cos(a);
-    int x2 = cx + (r-2)*sin(a), y2 = cy - (r-2)*cos(a);
-    tft.drawLine(x1,y1,x2,y2,C_FG);
+    int x1, y1, x2, y2;
+    dialPoint(d.cx, d.cy, d.r-6, i*30, x1, y1);
+    dialPoint(d.cx, d.cy, d.r-2, i*30, x2, y2);
+    g.drawLine(x1,y1,x2,y2,C_FG);
   }
-  updateHomeClockHands();
+}
+
+void drawHome() {
+  gfx.fillRect(0,STATUS_BAR_H,DISP_W,DISP_H-STATUS_BAR_H,C_BG);
+  dialDraw(homeDial);
 
   int wx = DISP_W - 64, wy = STATUS_BAR_H + 10, ww = 54, wh = 44;
-  tft.drawRoundRect(wx, wy, ww, wh, 4, C_ACCENT);
-  tft.setTextSize(1); tft.setTextColor(C_FG);
-  tft.setCursor(wx+6, wy+6); tft.print("Mumbai");
-  tft.setCursor(wx+6, wy+22); tft.print(weatherTemp);
-  tft.setTextColor(C_ACCENT); tft.setCursor(wx+6, wy+34); tft.print(weatherMain);
+  gfx.drawRoundRect(wx, wy, ww, wh, 4, C_ACCENT);
+  gfx.setTextSize(1); gfx.setTextColor(C_FG);
+  gfx.setCursor(wx+6, wy+6); gfx.print("Mumbai");
+  gfx.setCursor(wx+6, wy+22); gfx.print(weatherTemp);
+  gfx.setTextColor(C_ACCENT); gfx.setCursor(wx+6, wy+34); gfx.print(weatherMain);
 
-  tft.setTextColor(C_FG); tft.setCursor(8, DISP_H - 10); tft.print("Press for Apps ->");
-  prev_hx = prev_hy = prev_mx = prev_my = prev_sx = prev_sy = -1;
+  gfx.setTextColor(C_FG); gfx.setCursor(8, DISP_H - 10); gfx.print("Press for Apps ->");
 }
 
 void updateHomeClockHands() {
   if (!ntpSynced) return;
-  int cx = 40, cy = STATUS_BAR_H + 36, r = 28;
-  time_t nowt = time(nullptr);
-  struct tm *tm_info = localtime(&nowt);
+  const struct tm *tm_info = clockLocal();
   int h = tm_info->tm_hour % 12;
   int m = tm_info->tm_min;
   int s = tm_info->tm_sec;
-  float ha = (h + m/60.0f) * 30.0f * PI / 180.0f;
-  float ma = m * 6.0f * PI / 180.0f;
-  float sa = s * 6.0f * PI / 180.0f;
-
-  int hx = cx + (r/2)*sin(ha), hy = cy - (r/2)*cos(ha);
-  int mx = cx + (r*2/3)*sin(ma), my = cy - (r*2/3)*cos(ma);
-  int sx = cx + (r-4)*sin(sa), sy = cy - (r-4)*cos(sa);
-
-  if (prev_hx != -1) {
-    tft.drawLine(cx, cy, prev_hx, prev_hy, C_BG);
-    tft.drawLine(cx, cy, prev_mx, prev_my, C_BG);
-    tft.drawLine(cx, cy, prev_sx, prev_sy, C_BG);
-  }
-
-  tft.drawLine(cx, cy, hx, hy, C_FG);
-  tft.drawLine(cx, cy, mx, my, C_ACCENT);
-  tft.drawLine(cx, cy, sx, sy, C_WARN);
-  tft.fillCircle(cx, cy, 2, C_FG);
-
-  prev_hx = hx; prev_hy = hy;
-  prev_mx = mx; prev_my = my;
-  prev_sx = sx; prev_sy = sy;
+  dialSetHand(homeDial, 0, h*30 + m/2);
+  dialSetHand(homeDial, 1, m*6);
+  dialSetHand(homeDial, 2, s*6);
+  dialUpdate(homeDial);
 }
 
 void drawLauncher() {
-  tft.fillRect(0,STATUS_BAR_H,DISP_W,DISP_H-STATUS_BAR_H,C_BG);
+  gfx.fillRect(0,STATUS_BAR_H,DISP_W,DISP_H-STATUS_BAR_H,C_BG);
   int margin = 8, gap = 6;
   int iconW = (DISP_W - 2*margin - gap)/2;
   int iconH = 22;
@@ -643,96 +2467,105 @@ void drawLauncher() {
     launcherIcons[i].x = x; launcherIcons[i].y = y; 
     launcherIcons[i].w = iconW; launcherIcons[i].h = iconH;
     launcherIcons[i].name = names[i]; launcherIcons[i].app = apps[i];
-    tft.fillRoundRect(x,y,iconW,iconH,4,C_PANEL);
-    tft.drawRoundRect(x,y,iconW,iconH,4,C_ACCENT);
-    tft.setTextSize(1); tft.setTextColor(C_FG);
+    gfx.fillRoundRect(x,y,iconW,iconH,4,C_PANEL);
+    gfx.drawRoundRect(x,y,iconW,iconH,4,C_ACCENT);
+    gfx.setTextSize(1); gfx.setTextColor(C_FG);
     int tx = x + (iconW - (int)strlen(names[i])*6)/2;
     int ty = y + (iconH - 8)/2;
-    tft.setCursor(tx, ty); tft.print(names[i]);
+    gfx.setCursor(tx, ty); gfx.print(names[i]);
   }
-  tft.setTextColor(C_FG); tft.setCursor(8, DISP_H-10); tft.print("Long press = Home");
+  gfx.setTextColor(C_FG); gfx.setCursor(8, DISP_H-10); gfx.print("Long press = Home");
 }
 
 void drawCalculator() {
-  tft.fillRect(0,STATUS_BAR_H,DISP_W,DISP_H-STATUS_BAR_H,C_BG);
-  tft.fillRect(8, STATUS_BAR_H+6, DISP_W-16, 18, C_PANEL);
-  tft.setTextColor(C_FG); tft.setTextSize(1); 
-  tft.setCursor(12, STATUS_BAR_H+10); tft.print(calcDisplay);
+  gfx.fillRect(0,STATUS_BAR_H,DISP_W,DISP_H-STATUS_BAR_H,C_BG);
+  gfx.fillRect(8, STATUS_BAR_H+6, DISP_W-16, 18, C_PANEL);
+  gfx.setTextColor(C_FG); gfx.setTextSize(1); 
+  gfx.setCursor(12, STATUS_BAR_H+10); gfx.print(calcDisplay);
   int btnW = 32, btnH = 16, gap = 3, startX = 10, startY = STATUS_BAR_H + 32;
   const char* labels[] = {"7","8","9","/","4","5","6","*","1","2","3","-","0",".","=","+"};
   for (int i=0;i<16;i++) {
     int row = i/4, col = i%4;
     int x = startX + col*(btnW+gap), y = startY + row*(btnH+gap);
-    tft.fillRoundRect(x,y,btnW,btnH,3,C_PANEL);
-    tft.setTextColor(C_FG); tft.setCursor(x + (btnW-6)/2, y+4); tft.print(labels[i]);
+    gfx.fillRoundRect(x,y,btnW,btnH,3,C_PANEL);
+    gfx.setTextColor(C_FG); gfx.setCursor(x + (btnW-6)/2, y+4); gfx.print(labels[i]);
   }
   int y = startY + 4*(btnH+gap);
-  tft.fillRoundRect(startX, y, btnW*2 + gap, btnH, 3, C_PANEL);
-  tft.setCursor(startX + btnW - 3, y+4); tft.print("C");
-  tft.fillRoundRect(startX + btnW*2 + gap*2, y, btnW*2, btnH, 3, C_PANEL);
-  tft.setCursor(startX + btnW*3 + gap*2 - 3, y+4); tft.print("<");
+  gfx.fillRoundRect(startX, y, btnW*2 + gap, btnH, 3, C_PANEL);
+  gfx.setCursor(startX + btnW - 3, y+4); gfx.print("C");
+  gfx.fillRoundRect(startX + btnW*2 + gap*2, y, btnW*2, btnH, 3, C_PANEL);
+  gfx.setCursor(startX + btnW*3 + gap*2 - 3, y+4); gfx.print("<");
 }
 
-void drawCompass() {
-  tft.fillRect(0,STATUS_BAR_H,DISP_W,DISP_H-STATUS_BAR_H,C_BG);
-
-  int cx = DISP_W/2, cy = STATUS_BAR_H + 44, radius = 36;
-
-  tft.drawCircle(cx, cy, radius, C_FG);
-  tft.drawCircle(cx, cy, radius-2, C_PANEL);
-
-  tft.setTextSize(1); tft.setTextColor(C_FG);
-  tft.setCursor(cx - 6, cy - radius - 8); tft.print("");
-  tft.setCursor(cx - 6, cy + radius + 2); tft.print("");
-  tft.setCursor(cx + radius + 2, cy - 4); tft.print("");
-  tft.setCursor(cx - radius - 8, cy - 4); tft.print("");
-
+void drawCompassFace(const Dial &d, Adafruit_GFX &g) {
+  g.drawCircle(d.cx, d.cy, d.r, C_FG);
+  g.drawCircle(d.cx, d.cy, d.r-2, C_PANEL);
   for (int a=0;a<360;a+=30) {
-    float ar = a * PI / 180.0;
-    int x1 = cx + (radius-2) * sin(ar), y1 = cy - (radius-2) * cos(ar);
-    int x2 = cx + (radius-6) * sin(ar), y2 = cy - (radius-6) * cos(ar);
-    tft.drawLine(x1,y1,x2,y2,C_PANEL);
+    int x1, y1, x2, y2;
+    dialPoint(d.cx, d.cy, d.r-2, a, x1, y1);
+    dialPoint(d.cx, d.cy, d.r-6, a, x2, y2);
+    g.drawLine(x1,y1,x2,y2,C_PANEL);
   }
-
-  tft.fillRoundRect(8, DISP_H - 20, 72, 14, 3, C_PANEL);
-  tft.setCursor(14, DISP_H - 18); tft.setTextColor(C_FG); tft.print("Calibrate");
-
-  updateCompass();
 }
 
-void updateCompass() {
-  int cx = DISP_W/2, cy = STATUS_BAR_H + 44, radius = 36;
-  
-  tft.fillCircle(cx, cy, radius-8, C_BG);
-  tft.drawCircle(cx, cy, radius, C_FG);
-  tft.drawCircle(cx, cy, radius-2, C_PANEL);
-  for (int a=0;a<360;a+=30) {
-    float ar = a * PI / 180.0;
-    int x1 = cx + (radius-2) * sin(ar), y1 = cy - (radius-2) * cos(ar);
-    int x2 = cx + (radius-6) * sin(ar), y2 = cy - (radius-6) * cos(ar);
-    tft.drawLine(x1,y1,x2,y2,C_PANEL);
-  }
-
+float compassHeading() {
   float heading = yaw_ref - yaw_filtered;
   while (heading < 0) heading += 360;
   while (heading >= 360) heading -= 360;
+  return heading;
+}
 
-  float ar = heading * PI / 180.0;
-  int nx = cx + (radius-8) * sin(ar), ny = cy - (radius-8) * cos(ar);
-  tft.drawLine(cx, cy, nx, ny, C_WARN);
-  tft.fillCircle(cx, cy, 2, C_FG);
+void drawCompass() {
+  gfx.fillRect(0,STATUS_BAR_H,DISP_W,DISP_H-STATUS_BAR_H,C_BG);
+
+  int cx = compassDial.cx, cy = compassDial.cy, radius = compassDial.r;
+  float heading = compassHeading();
+  dialSetHand(compassDial, 0, (int)(heading + 0.5f));
+  dialDraw(compassDial);
+
+  gfx.setTextSize(1); gfx.setTextColor(C_FG);
+  gfx.setCursor(cx - 6, cy - radius - 8); gfx.print("");
+  gfx.setCursor(cx - 6, cy + radius + 2); gfx.print("");
+  gfx.setCursor(cx + radius + 2, cy - 4); gfx.print("");
+  gfx.setCursor(cx - radius - 8, cy - 4); gfx.print("");
+
+  gfx.fillRoundRect(8, DISP_H - 20, 72, 14, 3, C_PANEL);
+  gfx.setCursor(14, DISP_H - 18); gfx.setTextColor(C_FG); gfx.print("Calibrate");
+
+  // Same rule as the dial: only record digits that are fully on screen
+  int tenths = (int)(heading * 10 + 0.5f);
+  int tx = 8 + 9*6, ty = STATUS_BAR_H + 4;
+  if (gfx.paintsWhole(tx, ty, 6*6, 8)) compassShownTenths = tenths;
+  else if (tenths != compassShownTenths) markDirty(tx, ty, 6*6, 8);
+  gfx.setTextColor(C_FG);
+  gfx.setCursor(8, ty);
+  gfx.printf("Heading: %4d.%d", tenths / 10, tenths % 10);
+}
 
-  int tx = 8, ty = STATUS_BAR_H + 4;
-  tft.fillRect(tx, ty, DISP_W - 16, 12, C_BG);
-  tft.setTextSize(1); tft.setTextColor(C_FG);
-  tft.setCursor(tx, ty); tft.printf("Heading: %6.1f", heading);
+// Only the needle and the heading digits change between frames
+void updateCompass() {
+  float heading = compassHeading();
+  dialSetHand(compassDial, 0, (int)(heading + 0.5f));
+  dialUpdate(compassDial);
+
+  int tenths = (int)(heading * 10 + 0.5f);
+  if (tenths == compassShownTenths) return;
+  compassShownTenths = tenths;
+  // The digits overlap the top of the ring, so restore the face under them
+  DirtyRect box = { 8 + 9*6, STATUS_BAR_H + 4, 6*6, 8 };
+  gfx.setClip(box);
+  gfx.fillRect(box.x, box.y, box.w, box.h, C_BG);
+  compassDial.face(compassDial, gfx);
+  gfx.setTextSize(1); gfx.setTextColor(C_FG);
+  gfx.setCursor(box.x, box.y); gfx.printf("%4d.%d", tenths / 10, tenths % 10);
+  gfx.resetClip();
 }
 
 void drawAccel() {
-  tft.fillRect(0, STATUS_BAR_H, DISP_W, DISP_H - STATUS_BAR_H, C_BG);
+  gfx.fillRect(0, STATUS_BAR_H, DISP_W, DISP_H - STATUS_BAR_H, C_BG);
 
-  tft.setTextSize(1); tft.setTextColor(C_FG);
-  tft.setCursor(8, STATUS_BAR_H + 6); tft.print("Accelerometer (XYZ)");
+  gfx.setTextSize(1); gfx.setTextColor(C_FG);
+  gfx.setCursor(8, STATUS_BAR_H + 6); gfx.print("Accelerometer (XYZ)");
 
   // Calculate deltas from reference
   float dx = pitch_filtered - pitch_ref;
@@ -745,41 +2578,41 @@ void drawAccel() {
   int center = bx + bw/2;
 
   // X-axis (Pitch) bar
-  tft.setTextColor(C_ACCENT);
-  tft.setCursor(bx, by1 - 10); tft.print("X (Pitch):");
-  tft.drawRect(bx, by1, bw, bh, C_FG);
-  tft.fillRect(bx+1, by1+1, bw-2, bh-2, C_BG);
-  tft.drawLine(center, by1, center, by1+bh, C_PANEL);
+  gfx.setTextColor(C_ACCENT);
+  gfx.setCursor(bx, by1 - 10); gfx.print("X (Pitch):");
+  gfx.drawRect(bx, by1, bw, bh, C_FG);
+  gfx.fillRect(bx+1, by1+1, bw-2, bh-2, C_BG);
+  gfx.drawLine(center, by1, center, by1+bh, C_PANEL);
   int lenX = (int)(constrain(dx / 45.0f, -1.0f, 1.0f) * (bw/2));
-  if (lenX < 0) tft.fillRect(center + lenX, by1+2, -lenX, bh-4, C_ACCENT);
-  else tft.fillRect(center, by1+2, lenX, bh-4, C_ACCENT);
-  tft.setCursor(bx + bw + 4, by1 + 2); tft.printf("%+4.0f", dx);
+  if (lenX < 0) gfx.fillRect(center + lenX, by1+2, -lenX, bh-4, C_ACCENT);
+  else gfx.fillRect(center, by1+2, lenX, bh-4, C_ACCENT);
+  gfx.setCursor(bx + bw + 4, by1 + 2); gfx.printf("%+4.0f", dx);
 
   // Y-axis (Roll) bar
-  tft.setTextColor(C_WARN);
-  tft.setCursor(bx, by2 - 10); tft.print("Y (Roll):");
-  tft.drawRect(bx, by2, bw, bh, C_FG);
-  tft.fillRect(bx+1, by2+1, bw-2, bh-2, C_BG);
-  tft.drawLine(center, by2, center, by2+bh, C_PANEL);
+  gfx.setTextColor(C_WARN);
+  gfx.setCursor(bx, by2 - 10); gfx.print("Y (Roll):");
+  gfx.drawRect(bx, by2, bw, bh, C_FG);
+  gfx.fillRect(bx+1, by2+1, bw-2, bh-2, C_BG);
+  gfx.drawLine(center, by2, center, by2+bh, C_PANEL);
   int lenY = (int)(constrain(dy / 45.0f, -1.0f, 1.0f) * (bw/2));
-  if (lenY < 0) tft.fillRect(center + lenY, by2+2, -lenY, bh-4, C_WARN);
-  else tft.fillRect(center, by2+2, lenY, bh-4, C_WARN);
-  tft.setCursor(bx + bw + 4, by2 + 2); tft.printf("%+4.0f", dy);
+  if (lenY < 0) gfx.fillRect(center + lenY, by2+2, -lenY, bh-4, C_WARN);
+  else gfx.fillRect(center, by2+2, lenY, bh-4, C_WARN);
+  gfx.setCursor(bx + bw + 4, by2 + 2); gfx.printf("%+4.0f", dy);
 
   // Z-axis (Yaw) bar
-  tft.setTextColor(C_SUCCESS);
-  tft.setCursor(bx, by3 - 10); tft.print("Z (Yaw):");
-  tft.drawRect(bx, by3, bw, bh, C_FG);
-  tft.fillRect(bx+1, by3+1, bw-2, bh-2, C_BG);
-  tft.drawLine(center, by3, center, by3+bh, C_PANEL);
+  gfx.setTextColor(C_SUCCESS);
+  gfx.setCursor(bx, by3 - 10); gfx.print("Z (Yaw):");
+  gfx.drawRect(bx, by3, bw, bh, C_FG);
+  gfx.fillRect(bx+1, by3+1, bw-2, bh-2, C_BG);
+  gfx.drawLine(center, by3, center, by3+bh, C_PANEL);
   int lenZ = (int)(constrain(dz / 90.0f, -1.0f, 1.0f) * (bw/2));
-  if (lenZ < 0) tft.fillRect(center + lenZ, by3+2, -lenZ, bh-4, C_SUCCESS);
-  else tft.fillRect(center, by3+2, lenZ, bh-4, C_SUCCESS);
-  tft.setCursor(bx + bw + 4, by3 + 2); tft.printf("%+4.0f", dz);
+  if (lenZ < 0) gfx.fillRect(center + lenZ, by3+2, -lenZ, bh-4, C_SUCCESS);
+  else gfx.fillRect(center, by3+2, lenZ, bh-4, C_SUCCESS);
+  gfx.setCursor(bx + bw + 4, by3 + 2); gfx.printf("%+4.0f", dz);
 
   // Calibrate button
-  tft.fillRoundRect(8, DISP_H - 20, 72, 14, 3, C_PANEL);
-  tft.setCursor(14, DISP_H - 18); tft.setTextColor(C_FG); tft.print("Calibrate");
+  gfx.fillRoundRect(8, DISP_H - 20, 72, 14, 3, C_PANEL);
+  gfx.setCursor(14, DISP_H - 18); gfx.setTextColor(C_FG); gfx.print("Calibrate");
 }
 
 void updateAccel() {
@@ -793,69 +2626,83 @@ void updateAccel() {
   int center = bx + bw/2;
 
   // Clear and redraw bars
-  tft.fillRect(bx+1, by1+1, bw-2, bh-2, C_BG);
-  tft.drawLine(center, by1, center, by1+bh, C_PANEL);
+  gfx.fillRect(bx+1, by1+1, bw-2, bh-2, C_BG);
+  gfx.drawLine(center, by1, center, by1+bh, C_PANEL);
   int lenX = (int)(constrain(dx / 45.0f, -1.0f, 1.0f) * (bw/2));
-  if (lenX < 0) tft.fillRect(center + lenX, by1+2, -lenX, bh-4, C_ACCENT);
-  else tft.fillRect(center, by1+2, lenX, bh-4, C_ACCENT);
-  tft.fillRect(bx + bw + 4, by1 + 2, 30, 8, C_BG);
-  tft.setTextSize(1); tft.setTextColor(C_ACCENT);
-  tft.setCursor(bx + bw + 4, by1 + 2); tft.printf("%+4.0f", dx);
-
-  tft.fillRect(bx+1, by2+1, bw-2, bh-2, C_BG);
-  tft.drawLine(center, by2, center, by2+bh, C_PANEL);
+  if (lenX < 0) gfx.fillRect(center + lenX, by1+2, -lenX, bh-4, C_ACCENT);
+  else gfx.fillRect(center, by1+2, lenX, bh-4, C_ACCENT);
+  gfx.fillRect(bx + bw + 4, by1 + 2, 30, 8, C_BG);
+  gfx.setTextSize(1); gfx.setTextColor(C_ACCENT);
+  gfx.setCursor(bx + bw + 4, by1 + 2); gfx.printf("%+4.0f", dx);
+
+  gfx.fillRect(bx+1, by2+1, bw-2, bh-2, C_BG);
+  gfx.drawLine(center, by2, center, by2+bh, C_PANEL);
   int lenY = (int)(constrain(dy / 45.0f, -1.0f, 1.0f) * (bw/2));
-  if (lenY < 0) tft.fillRect(center + lenY, by2+2, -lenY, bh-4, C_WARN);
-  else tft.fillRect(center, by2+2, lenY, bh-4, C_WARN);
-  tft.fillRect(bx + bw + 4, by2 + 2, 30, 8, C_BG);
-  tft.setTextColor(C_WARN);
-  tft.setCursor(bx + bw + 4, by2 + 2); tft.printf("%+4.0f", dy);
-
-  tft.fillRect(bx+1, by3+1, bw-2, bh-2, C_BG);
-  tft.drawLine(center, by3, center, by3+bh, C_PANEL);
+  if (lenY < 0) gfx.fillRect(center + lenY, by2+2, -lenY, bh-4, C_WARN);
+  else gfx.fillRect(center, by2+2, lenY, bh-4, C_WARN);
+  gfx.fillRect(bx + bw + 4, by2 + 2, 30, 8, C_BG);
+  gfx.setTextColor(C_WARN);
+  gfx.setCursor(bx + bw + 4, by2 + 2); gfx.printf("%+4.0f", dy);
+
+  gfx.fillRect(bx+1, by3+1, bw-2, bh-2, C_BG);
+  gfx.drawLine(center, by3, center, by3+bh, C_PANEL);
   int lenZ = (int)(constrain(dz / 90.0f, -1.0f, 1.0f) * (bw/2));
-  if (lenZ < 0) tft.fillRect(center + lenZ, by3+2, -lenZ, bh-4, C_SUCCESS);
-  else tft.fillRect(center, by3+2, lenZ, bh-4, C_SUCCESS);
-  tft.fillRect(bx + bw + 4, by3 + 2, 30, 8, C_BG);
-  tft.setTextColor(C_SUCCESS);
-  tft.setCursor(bx + bw + 4, by3 + 2); tft.printf("%+4.0f", dz);
+  if (lenZ < 0) gfx.fillRect(center + lenZ, by3+2, -lenZ, bh-4, C_SUCCESS);
+  else gfx.fillRect(center, by3+2, lenZ, bh-4, C_SUCCESS);
+  gfx.fillRect(bx + bw + 4, by3 + 2, 30, 8, C_BG);
+  gfx.setTextColor(C_SUCCESS);
+  gfx.setCursor(bx + bw + 4, by3 + 2); gfx.printf("%+4.0f", dz);
 }
 
 void drawClock() {
-  tft.fillRect(0,STATUS_BAR_H,DISP_W,DISP_H-STATUS_BAR_H,C_BG);
-  tft.setTextColor(C_FG); tft.setTextSize(3);
+  gfx.fillRect(0,STATUS_BAR_H,DISP_W,DISP_H-STATUS_BAR_H,C_BG);
+  gfx.setTextColor(C_FG); gfx.setTextSize(3);
   if (ntpSynced) {
-    time_t nowt = time(nullptr); struct tm *tm_info = localtime(&nowt);
+    const struct tm *tm_info = clockLocal();
     char buf[16]; snprintf(buf,sizeof(buf), "%02d:%02d:%02d", tm_info->tm_hour, tm_info->tm_min, tm_info->tm_sec);
-    tft.setCursor(8, STATUS_BAR_H + 40); tft.print(buf);
-    tft.setTextSize(1); char db[20]; 
+    gfx.setCursor(8, STATUS_BAR_H + 40); gfx.print(buf);
+    gfx.setTextSize(1); char db[20]; 
     snprintf(db,sizeof(db), "%02d/%02d/%04d", tm_info->tm_mday, tm_info->tm_mon+1, tm_info->tm_year+1900);
-    tft.setCursor(8, STATUS_BAR_H + 100); tft.print(db);
+    gfx.setCursor(8, STATUS_BAR_H + 100); gfx.print(db);
   } else {
-    tft.setCursor(8, STATUS_BAR_H + 40); tft.setTextSize(2); 
-    tft.print("Clock not synced");
+    gfx.setCursor(8, STATUS_BAR_H + 40); gfx.setTextSize(2); 
+    gfx.print("Clock not synced");
   }
 }
 
+// Only the digits change once a second; the date line only at midnight.
+void updateClock() {
+  static time_t lastShown = 0;
+  if (!ntpSynced) return;
+  time_t nowt = clockNow();
+  if (nowt == lastShown) return;
+  if (lastShown == 0) markDirty(0, STATUS_BAR_H, DISP_W, DISP_H - STATUS_BAR_H);
+  lastShown = nowt;
+  markDirty(8, STATUS_BAR_H + 40, 8*18, 24);
+  const struct tm *tm_info = clockLocal();
+  if (tm_info->tm_hour == 0 && tm_info->tm_min == 0 && tm_info->tm_sec == 0)
+    markDirty(8, STATUS_BAR_H + 100, 10*6, 8);
+}
+
 void drawGames() {
-  tft.fillRect(0,STATUS_BAR_H,DISP_W,DISP_H-STATUS_BAR_H,C_BG);
-  tft.setTextSize(1); tft.setTextColor(C_ACCENT);
-  tft.setCursor(10, STATUS_BAR_H + 10); tft.print("Select Game:");
+  gfx.fillRect(0,STATUS_BAR_H,DISP_W,DISP_H-STATUS_BAR_H,C_BG);
+  gfx.setTextSize(1); gfx.setTextColor(C_ACCENT);
+  gfx.setCursor(10, STATUS_BAR_H + 10); gfx.print("Select Game:");
   
   int btnW = DISP_W - 20, btnH = 24, gap = 8, startY = STATUS_BAR_H + 28;
   const char* games[] = {"Tic-Tac-Toe", "Pong", "Space Shooter"};
   
   for (int i = 0; i < 3; i++) {
     int y = startY + i * (btnH + gap);
-    tft.fillRoundRect(10, y, btnW, btnH, 4, C_PANEL);
-    tft.drawRoundRect(10, y, btnW, btnH, 4, C_ACCENT);
-    tft.setTextColor(C_FG);
+    gfx.fillRoundRect(10, y, btnW, btnH, 4, C_PANEL);
+    gfx.drawRoundRect(10, y, btnW, btnH, 4, C_ACCENT);
+    gfx.setTextColor(C_FG);
     int tx = 10 + (btnW - strlen(games[i])*6)/2;
-    tft.setCursor(tx, y + 8); tft.print(games[i]);
+    gfx.setCursor(tx, y + 8); gfx.print(games[i]);
   }
   
-  tft.setTextColor(C_FG); tft.setCursor(8, DISP_H-10); 
-  tft.print("Long press = Home");
+  gfx.setTextColor(C_FG); gfx.setCursor(8, DISP_H-10); 
+  gfx.print("Long press = Home");
 }
 
 bool checkWin(int p) {
@@ -885,186 +2732,266 @@ int findBestTTTMove(int ai,int human) {
 }
 
 void drawTicTacToe() {
-  tft.fillRect(0,STATUS_BAR_H,DISP_W,DISP_H-STATUS_BAR_H,C_BG);
+  gfx.fillRect(0,STATUS_BAR_H,DISP_W,DISP_H-STATUS_BAR_H,C_BG);
   int s = 34, ox = (DISP_W - s*3)/2, oy = STATUS_BAR_H + 14;
   
   for (int i=0;i<9;i++) {
     int x = ox + (i%3)*s, y = oy + (i/3)*s;
-    tft.drawRect(x,y,s,s,C_FG);
+    gfx.drawRect(x,y,s,s,C_FG);
     if (tttBoard[i]==1) { 
-      tft.drawLine(x+6,y+6,x+s-6,y+s-6,C_ACCENT); 
-      tft.drawLine(x+s-6,y+6,x+6,y+s-6,C_ACCENT); 
+      gfx.drawLine(x+6,y+6,x+s-6,y+s-6,C_ACCENT); 
+      gfx.drawLine(x+s-6,y+6,x+6,y+s-6,C_ACCENT); 
     }
     else if (tttBoard[i]==2) 
-      tft.drawCircle(x+s/2,y+s/2,s/2-8,C_WARN);
+      gfx.drawCircle(x+s/2,y+s/2,s/2-8,C_WARN);
   }
   
   if (tttGameOver) { 
-    tft.fillRect(DISP_W/2-40, DISP_H/2+36, 80, 20, C_PANEL); 
-    tft.drawRect(DISP_W/2-40, DISP_H/2+36, 80, 20, C_ACCENT); 
-    tft.setCursor(DISP_W/2-28, DISP_H/2+40); tft.setTextColor(C_FG); 
-    tft.print("Press to reset"); 
+    gfx.fillRect(DISP_W/2-40, DISP_H/2+36, 80, 20, C_PANEL); 
+    gfx.drawRect(DISP_W/2-40, DISP_H/2+36, 80, 20, C_ACCENT); 
+    gfx.setCursor(DISP_W/2-28, DISP_H/2+40); gfx.setTextColor(C_FG); 
+    gfx.print("Press to reset"); 
   }
 }
 
+// ---------------- GAME CORE ----------------
+void gameReset(uint16_t seed) {
+  gameClock.lastUs = micros();
+  gameClock.accUs = 0;
+  gameClock.tick = 0;
+  gameClock.lfsr = seed ? seed : 0xACE1;
+  gameInput.fire = false;
+}
+
+uint16_t gameRand() {
+  uint16_t l = gameClock.lfsr;
+  l = (l >> 1) ^ (-(l & 1u) & 0xB400u);
+  return gameClock.lfsr = l;
+}
+
+// Run whole ticks owed since the last frame; returns the Q8 blend factor.
+// A press (fire) is held until a tick has seen it, so a frame that owes no
+// tick does not drop it.
+uint8_t gameAdvance(GameTickFn tick) {
+  uint32_t now = micros();
+  gameClock.accUs += now - gameClock.lastUs;
+  gameClock.lastUs = now;
+  if (gameClock.accUs > GAME_MAX_CATCHUP * GAME_TICK_US) gameClock.accUs = GAME_MAX_CATCHUP * GAME_TICK_US;
+  while (gameClock.accUs >= GAME_TICK_US) {
+    tick(gameInput);
+    gameInput.fire = false;
+    gameClock.tick++;
+    gameClock.accUs -= GAME_TICK_US;
+  }
+  return gameClock.accUs * 256 / GAME_TICK_US;
+}
+
+static inline int gameLerp(int32_t prev, int32_t cur, uint8_t alpha) {
+  return (prev + (((cur - prev) * alpha) >> 8)) >> 8;
+}
+
+// ---------------- GAMES ----------------
+void pongServe(int dir) {
+  pongBallX = pongPrevBallX = (DISP_W/2) << 8;
+  pongBallY = pongPrevBallY = (DISP_H/2) << 8;
+  pongBallVX = dir * PONG_BALL_VX; pongBallVY = dir * PONG_BALL_VY;
+}
+
+void pongReset() {
+  pongScore1 = 0; pongScore2 = 0;
+  pongServe(1);
+  pongPaddle1Y = 40 << 8; pongPaddle2Y = 40 << 8;
+  lastBallX = 80; lastBallY = 64;
+  pongGameActive = true;
+  gameReset((uint16_t)micros());
+}
+
 void drawPong() {
-  tft.fillRect(0, STATUS_BAR_H, DISP_W, DISP_H - STATUS_BAR_H, C_BG);
+  gfx.fillRect(0, STATUS_BAR_H, DISP_W, DISP_H - STATUS_BAR_H, C_BG);
   
   // Center line
   for (int y = STATUS_BAR_H; y < DISP_H; y += 6) {
-    tft.drawLine(DISP_W/2, y, DISP_W/2, y+3, C_PANEL);
+    gfx.drawLine(DISP_W/2, y, DISP_W/2, y+3, C_PANEL);
   }
   
   // Paddles
-  tft.fillRect(5, pongPaddle1Y, PADDLE_W, PADDLE_H, C_ACCENT);
-  tft.fillRect(DISP_W - 5 - PADDLE_W, pongPaddle2Y, PADDLE_W, PADDLE_H, C_WARN);
+  gfx.fillRect(5, pongPaddle1Y >> 8, PADDLE_W, PADDLE_H, C_ACCENT);
+  gfx.fillRect(DISP_W - 5 - PADDLE_W, pongPaddle2Y >> 8, PADDLE_W, PADDLE_H, C_WARN);
   
   // Ball
-  tft.fillCircle((int)pongBallX, (int)pongBallY, 2, C_FG);
+  lastBallX = pongBallX >> 8; lastBallY = pongBallY >> 8;
+  gfx.fillCircle(lastBallX, lastBallY, 2, C_FG);
   
   // Scores
-  tft.setTextSize(2); tft.setTextColor(C_FG);
-  tft.setCursor(DISP_W/2 - 30, STATUS_BAR_H + 5); tft.print(pongScore1);
-  tft.setCursor(DISP_W/2 + 20, STATUS_BAR_H + 5); tft.print(pongScore2);
+  gfx.setTextSize(2); gfx.setTextColor(C_FG);
+  gfx.setCursor(DISP_W/2 - 30, STATUS_BAR_H + 5); gfx.print(pongScore1);
+  gfx.setCursor(DISP_W/2 + 20, STATUS_BAR_H + 5); gfx.print(pongScore2);
   
   if (!pongGameActive) {
-    tft.fillRect(DISP_W/2-40, DISP_H/2, 80, 20, C_PANEL);
-    tft.drawRect(DISP_W/2-40, DISP_H/2, 80, 20, C_ACCENT);
-    tft.setTextSize(1);
-    tft.setCursor(DISP_W/2-28, DISP_H/2+6); tft.print("Press to play");
+    gfx.fillRect(DISP_W/2-40, DISP_H/2, 80, 20, C_PANEL);
+    gfx.drawRect(DISP_W/2-40, DISP_H/2, 80, 20, C_ACCENT);
+    gfx.setTextSize(1);
+    gfx.setCursor(DISP_W/2-28, DISP_H/2+6); gfx.print("Press to play");
   }
 }
 
-void updatePong() {
+void pongTick(const GameInput &in) {
   if (!pongGameActive) return;
-  
-  // Erase old ball
-  tft.fillCircle(lastBallX, lastBallY, 3, C_BG);
-  
-  // Update ball
+  pongPrevBallX = pongBallX; pongPrevBallY = pongBallY;
+
+  pongPaddle1Y = constrain(pongPaddle1Y + in.vy * PONG_PADDLE_SPEED / 256, STATUS_BAR_H << 8, (DISP_H - PADDLE_H) << 8);
+
   pongBallX += pongBallVX;
   pongBallY += pongBallVY;
   
   // Ball collisions
-  if (pongBallY <= STATUS_BAR_H + 3 || pongBallY >= DISP_H - 3) {
+  if (pongBallY <= (STATUS_BAR_H + 3) << 8 && pongBallVY < 0) {
     pongBallVY = -pongBallVY;
-    
+    sfxPlay(SFX_WALL);
+  } else if (pongBallY >= (DISP_H - 3) << 8 && pongBallVY > 0) {
+    pongBallVY = -pongBallVY;
+    sfxPlay(SFX_WALL);
   }
   
   // Paddle collisions
-  if (pongBallX <= 8 + PADDLE_W && pongBallY >= pongPaddle1Y && pongBallY <= pongPaddle1Y + PADDLE_H) {
-    pongBallVX = abs(pongBallVX);
-    pongBallVY += (pongBallY - (pongPaddle1Y + PADDLE_H/2)) * 0.15f;
-    
-  }
-  if (pongBallX >= DISP_W - 8 - PADDLE_W && pongBallY >= pongPaddle2Y && pongBallY <= pongPaddle2Y + PADDLE_H) {
-    pongBallVX = -abs(pongBallVX);
-    pongBallVY += (pongBallY - (pongPaddle2Y + PADDLE_H/2)) * 0.15f;
-    
+  if (pongBallVX < 0 && pongBallX <= (8 + PADDLE_W) << 8 &&
+      pongBallY >= pongPaddle1Y && pongBallY <= pongPaddle1Y + (PADDLE_H << 8)) {
+    pongBallVX = -pongBallVX;
+    pongBallVY += ((pongBallY - pongPaddle1Y) / 256 - PADDLE_H/2) * PONG_SPIN;
+    sfxPlay(SFX_PADDLE);
+  }
+  if (pongBallVX > 0 && pongBallX >= (DISP_W - 8 - PADDLE_W) << 8 &&
+      pongBallY >= pongPaddle2Y && pongBallY <= pongPaddle2Y + (PADDLE_H << 8)) {
+    pongBallVX = -pongBallVX;
+    pongBallVY += ((pongBallY - pongPaddle2Y) / 256 - PADDLE_H/2) * PONG_SPIN;
+    sfxPlay(SFX_PADDLE);
   }
   
   // Scoring
-  if (pongBallX < 0) {
-    pongScore2++;
-    pongBallX = DISP_W/2; pongBallY = DISP_H/2;
-    pongBallVX = 2.2f; pongBallVY = 1.8f;
-    
-    if (pongScore2 >= 5) pongGameActive = false;
-    needsFullRedraw = true;
-    return;
-  }
-  if (pongBallX > DISP_W) {
-    pongScore1++;
-    pongBallX = DISP_W/2; pongBallY = DISP_H/2;
-    pongBallVX = -2.2f; pongBallVY = -1.8f;
-    
-    if (pongScore1 >= 5) pongGameActive = false;
-    needsFullRedraw = true;
+  if (pongBallX < 0 || pongBallX > DISP_W << 8) {
+    bool left = pongBallX < 0;
+    int &score = left ? pongScore2 : pongScore1;
+    score++;
+    pongServe(left ? 1 : -1);
+    if (score >= 5) pongGameActive = false;
+    sfxPlay(pongGameActive ? SFX_SCORE : SFX_GAMEOVER);
+    if (pongGameActive) markDirty(DISP_W/2 - 30, STATUS_BAR_H + 5, 62, 16);
+    else needsFullRedraw = true;
     return;
   }
   
-  // AI paddle (smarter)
-  int target = (int)pongBallY;
-  if (pongPaddle2Y + PADDLE_H/2 < target - 2) pongPaddle2Y += 3;
-  else if (pongPaddle2Y + PADDLE_H/2 > target + 2) pongPaddle2Y -= 3;
-  pongPaddle2Y = constrain(pongPaddle2Y, STATUS_BAR_H, DISP_H - PADDLE_H);
+  // AI paddle
+  int32_t mid = pongPaddle2Y + ((PADDLE_H/2) << 8);
+  if (mid < pongBallY - (2 << 8)) pongPaddle2Y += PONG_AI_SPEED;
+  else if (mid > pongBallY + (2 << 8)) pongPaddle2Y -= PONG_AI_SPEED;
+  pongPaddle2Y = constrain(pongPaddle2Y, STATUS_BAR_H << 8, (DISP_H - PADDLE_H) << 8);
+}
+
+void updatePong() {
+  uint8_t alpha = gameAdvance(pongTick);
+  if (!pongGameActive) return;   // ended this frame, full redraw pending
   
-  // Draw ball
-  tft.fillCircle((int)pongBallX, (int)pongBallY, 2, C_FG);
-  lastBallX = (int)pongBallX;
-  lastBallY = (int)pongBallY;
+  // Erase old ball, draw it between the last two ticks
+  gfx.fillCircle(lastBallX, lastBallY, 3, C_BG);
+  lastBallX = gameLerp(pongPrevBallX, pongBallX, alpha);
+  lastBallY = gameLerp(pongPrevBallY, pongBallY, alpha);
+  gfx.fillCircle(lastBallX, lastBallY, 2, C_FG);
   
   // Redraw paddles
-  tft.fillRect(5, STATUS_BAR_H, PADDLE_W, DISP_H - STATUS_BAR_H, C_BG);
-  tft.fillRect(5, pongPaddle1Y, PADDLE_W, PADDLE_H, C_ACCENT);
-  tft.fillRect(DISP_W - 5 - PADDLE_W, STATUS_BAR_H, PADDLE_W, DISP_H - STATUS_BAR_H, C_BG);
-  tft.fillRect(DISP_W - 5 - PADDLE_W, pongPaddle2Y, PADDLE_W, PADDLE_H, C_WARN);
+  gfx.fillRect(5, STATUS_BAR_H, PADDLE_W, DISP_H - STATUS_BAR_H, C_BG);
+  gfx.fillRect(5, pongPaddle1Y >> 8, PADDLE_W, PADDLE_H, C_ACCENT);
+  gfx.fillRect(DISP_W - 5 - PADDLE_W, STATUS_BAR_H, PADDLE_W, DISP_H - STATUS_BAR_H, C_BG);
+  gfx.fillRect(DISP_W - 5 - PADDLE_W, pongPaddle2Y >> 8, PADDLE_W, PADDLE_H, C_WARN);
+}
+
+void shooterReset() {
+  shooterScore = 0;
+  shipX = shipPrevX = 80 << 8; shipY = 100;
+  lastShipX = 80;
+  for (int i = 0; i < 8; i++) bullets[i].active = false;
+  for (int i = 0; i < 10; i++) enemies[i].active = false;
+  shooterNextSpawn = SHOOTER_SPAWN_TICKS;
+  shooterFireReady = 0;
+  shooterGameActive = true;
+  gameReset((uint16_t)micros());
 }
 
 void drawSpaceShooter() {
-  tft.fillRect(0, STATUS_BAR_H, DISP_W, DISP_H - STATUS_BAR_H, C_BG);
+  gfx.fillRect(0, STATUS_BAR_H, DISP_W, DISP_H - STATUS_BAR_H, C_BG);
   
   // Ship
-  tft.fillTriangle(shipX, shipY-5, shipX-4, shipY+5, shipX+4, shipY+5, C_ACCENT);
+  lastShipX = shipX >> 8;
+  gfx.fillTriangle(lastShipX, shipY-5, lastShipX-4, shipY+5, lastShipX+4, shipY+5, C_ACCENT);
   
   // Bullets
   for (int i = 0; i < 8; i++) {
+    bullets[i].drawnY = -1;
     if (bullets[i].active) {
-      tft.fillRect((int)bullets[i].x, (int)bullets[i].y, 2, 4, C_WARN);
+      bullets[i].drawnY = bullets[i].y >> 8;
+      gfx.fillRect(bullets[i].x >> 8, bullets[i].drawnY, 2, 4, C_WARN);
     }
   }
   
   // Enemies
   for (int i = 0; i < 10; i++) {
+    enemies[i].drawnY = -1;
     if (enemies[i].active) {
-      tft.fillRect((int)enemies[i].x-3, (int)enemies[i].y-3, 6, 6, C_ERROR);
+      enemies[i].drawnY = enemies[i].y >> 8;
+      gfx.fillRect((enemies[i].x >> 8)-3, enemies[i].drawnY-3, 6, 6, C_ERROR);
     }
   }
   
   // Score
-  tft.setTextSize(1); tft.setTextColor(C_FG);
-  tft.setCursor(8, STATUS_BAR_H + 4); tft.print("Score: " + String(shooterScore));
+  gfx.setTextSize(1); gfx.setTextColor(C_FG);
+  gfx.setCursor(8, STATUS_BAR_H + 4); gfx.print("Score: " + String(shooterScore));
   
   if (!shooterGameActive) {
-    tft.fillRect(DISP_W/2-40, DISP_H/2, 80, 20, C_PANEL);
-    tft.drawRect(DISP_W/2-40, DISP_H/2, 80, 20, C_ACCENT);
-    tft.setCursor(DISP_W/2-32, DISP_H/2+6); tft.print("Game Over!");
-    tft.setCursor(DISP_W/2-28, DISP_H-15); tft.print("Press to play");
+    gfx.fillRect(DISP_W/2-40, DISP_H/2, 80, 20, C_PANEL);
+    gfx.drawRect(DISP_W/2-40, DISP_H/2, 80, 20, C_ACCENT);
+    gfx.setCursor(DISP_W/2-32, DISP_H/2+6); gfx.print("Game Over!");
+    gfx.setCursor(DISP_W/2-28, DISP_H-15); gfx.print("Press to play");
   }
 }
 
-void updateSpaceShooter() {
+void shooterTick(const GameInput &in) {
   if (!shooterGameActive) return;
-  
-  // Erase old ship
-  tft.fillTriangle(lastShipX, shipY-5, lastShipX-4, shipY+5, lastShipX+4, shipY+5, C_BG);
-  
-  // Draw new ship
-  tft.fillTriangle(shipX, shipY-5, shipX-4, shipY+5, shipX+4, shipY+5, C_ACCENT);
-  lastShipX = shipX;
+  shipPrevX = shipX;
+  shipX = constrain(shipX + in.vx * SHOOTER_SHIP_SPEED / 256, 10 << 8, (DISP_W - 10) << 8);
+
+  if (in.fire && gameClock.tick >= shooterFireReady) {
+    for (int i = 0; i < 8; i++) {
+      if (!bullets[i].active) {
+        bullets[i].x = shipX;
+        bullets[i].y = bullets[i].py = (shipY - 6) << 8;
+        bullets[i].active = true;
+        shooterFireReady = gameClock.tick + SHOOTER_FIRE_TICKS;
+        sfxPlay(SFX_SHOOT);
+        break;
+      }
+    }
+  }
   
   // Update bullets
   for (int i = 0; i < 8; i++) {
     if (bullets[i].active) {
-      tft.fillRect((int)bullets[i].x, (int)bullets[i].y, 2, 4, C_BG);
-      bullets[i].y -= 4.5f;
-      if (bullets[i].y < STATUS_BAR_H) bullets[i].active = false;
-      else tft.fillRect((int)bullets[i].x, (int)bullets[i].y, 2, 4, C_WARN);
+      bullets[i].py = bullets[i].y;
+      bullets[i].y -= SHOOTER_BULLET_SPEED;
+      if (bullets[i].y < STATUS_BAR_H << 8) bullets[i].active = false;
     }
   }
   
   // Update enemies
   for (int i = 0; i < 10; i++) {
     if (enemies[i].active) {
-      tft.fillRect((int)enemies[i].x-3, (int)enemies[i].y-3, 6, 6, C_BG);
-      enemies[i].y += 1.5f;
-      if (enemies[i].y > DISP_H) {
+      enemies[i].py = enemies[i].y;
+      enemies[i].y += SHOOTER_ENEMY_SPEED;
+      if (enemies[i].y > DISP_H << 8) {
         enemies[i].active = false;
         shooterGameActive = false;
         needsFullRedraw = true;
+        sfxPlay(SFX_GAMEOVER);
         return;
       }
-      tft.fillRect((int)enemies[i].x-3, (int)enemies[i].y-3, 6, 6, C_ERROR);
     }
   }
   
@@ -1073,13 +3000,12 @@ void updateSpaceShooter() {
     if (bullets[i].active) {
       for (int j = 0; j < 10; j++) {
         if (enemies[j].active) {
-          if (abs((int)bullets[i].x - (int)enemies[j].x) < 20 && 
-              abs((int)bullets[i].y - (int)enemies[j].y) < 20) {
+          if (abs(bullets[i].x - enemies[j].x) < 20 << 8 && 
+              abs(bullets[i].y - enemies[j].y) < 20 << 8) {
             bullets[i].active = false;
             enemies[j].active = false;
             shooterScore += 10;
-            
-            tft.fillRect((int)enemies[j].x-3, (int)enemies[j].y-3, 6, 6, C_BG);
+            sfxPlay(SFX_EXPLODE);
           }
         }
       }
@@ -1087,172 +3013,328 @@ void updateSpaceShooter() {
   }
   
   // Spawn enemies
-  if (millis() - lastEnemySpawn > 1500) {
+  if (gameClock.tick >= shooterNextSpawn) {
     for (int i = 0; i < 10; i++) {
       if (!enemies[i].active) {
-        enemies[i].x = random(15, DISP_W - 15);
-        enemies[i].y = STATUS_BAR_H + 15;
+        enemies[i].x = (15 + gameRand() % (DISP_W - 30)) << 8;
+        enemies[i].y = enemies[i].py = (STATUS_BAR_H + 15) << 8;
         enemies[i].active = true;
-        lastEnemySpawn = millis();
+        shooterNextSpawn = gameClock.tick + SHOOTER_SPAWN_TICKS;
         break;
       }
     }
   }
 }
 
+void updateSpaceShooter() {
+  uint8_t alpha = gameAdvance(shooterTick);
+  if (!shooterGameActive) return;
+  
+  // Ship
+  gfx.fillTriangle(lastShipX, shipY-5, lastShipX-4, shipY+5, lastShipX+4, shipY+5, C_BG);
+  lastShipX = gameLerp(shipPrevX, shipX, alpha);
+  gfx.fillTriangle(lastShipX, shipY-5, lastShipX-4, shipY+5, lastShipX+4, shipY+5, C_ACCENT);
+  
+  // Bullets and enemies: erase where last drawn, redraw if still alive
+  for (int i = 0; i < 8; i++) {
+    Bullet &b = bullets[i];
+    if (b.drawnY >= 0) gfx.fillRect(b.x >> 8, b.drawnY, 2, 4, C_BG);
+    b.drawnY = b.active ? gameLerp(b.py, b.y, alpha) : -1;
+    if (b.active) gfx.fillRect(b.x >> 8, b.drawnY, 2, 4, C_WARN);
+  }
+  for (int i = 0; i < 10; i++) {
+    Enemy &e = enemies[i];
+    if (e.drawnY >= 0) gfx.fillRect((e.x >> 8)-3, e.drawnY-3, 6, 6, C_BG);
+    e.drawnY = e.active ? gameLerp(e.py, e.y, alpha) : -1;
+    if (e.active) gfx.fillRect((e.x >> 8)-3, e.drawnY-3, 6, 6, C_ERROR);
+  }
+}
+
 // ---------------- WIFI UTILS ----------------
 
 // Helper: find known password for SSID. Returns nullptr if not known.
-const char* findKnownPassword(const String &ssid) {
+const char* findKnownPassword(const char *ssid) {
   for (int i = 0; i < KNOWN_NET_COUNT; i++) {
-    if (ssid.equals(String(knownNets[i].ssid))) return knownNets[i].pass;
+    if (!strcmp(ssid, knownNets[i].ssid)) return knownNets[i].pass;
   }
   return nullptr;
 }
 
-// Sort scanned networks by RSSI (descending) and populate wifiNets[]
+static uint8_t wifiCacheCheck(const WifiCache &c) {
+  const uint8_t *p = (const uint8_t *)&c;
+  uint8_t x = 0;
+  for (size_t i = 0; i < offsetof(WifiCache, check); i++) x ^= p[i];
+  return x;
+}
+
+bool loadWifiCache(WifiCache &c) {
+  EEPROM.get(WIFI_CACHE_ADDR, c);
+  return c.magic == WIFI_CACHE_MAGIC && c.version == WIFI_CACHE_VERSION &&
+         c.check == wifiCacheCheck(c) && c.ssid[0] && c.channel;
+}
+
+// Records the current association; EEPROM is only written when it changed
+void saveWifiCache() {
+  WifiCache c;
+  memset(&c, 0, sizeof(c));
+  c.magic = WIFI_CACHE_MAGIC;
+  c.version = WIFI_CACHE_VERSION;
+  c.channel = WiFi.channel();
+  memcpy(c.bssid, WiFi.BSSID(), 6);
+  strncpy(c.ssid, WiFi.SSID().c_str(), sizeof(c.ssid) - 1);
+#if WIFI_CACHE_STATIC_IP
+  c.hasLease = 1;
+  c.ip = WiFi.localIP(); c.gateway = WiFi.gatewayIP(); c.mask = WiFi.subnetMask(); c.dns = WiFi.dnsIP();
+#endif
+  c.check = wifiCacheCheck(c);
+
+  WifiCache old;
+  EEPROM.get(WIFI_CACHE_ADDR, old);
+  if (!memcmp(&old, &c, sizeof(c))) return;
+  EEPROM.put(WIFI_CACHE_ADDR, c);
+  EEPROM.commit();
+}
+
+// Directed join to the cached BSSID/channel: no scan, no probing other channels
+bool fastJoinFromCache() {
+  WifiCache c;
+  if (!loadWifiCache(c)) return false;
+  const char *pass = findKnownPassword(c.ssid);
+  Serial.printf("Fast join: %s ch%u\n", c.ssid, c.channel);
+  if (c.hasLease && WIFI_CACHE_STATIC_IP)
+    WiFi.config(IPAddress(c.ip), IPAddress(c.gateway), IPAddress(c.mask), IPAddress(c.dns));
+  WiFi.begin(c.ssid, pass, c.channel, c.bssid);
+  uint32_t t0 = millis();
+  while (WiFi.status() != WL_CONNECTED && millis() - t0 < WIFI_FAST_JOIN_MS) { delay(20); yield(); }
+  if (WiFi.status() == WL_CONNECTED) { wifiRecordAssoc(millis() - t0); return true; }
+  if (c.hasLease) WiFi.config(IPAddress(0u), IPAddress(0u), IPAddress(0u));   // back to DHCP
+  WiFi.disconnect();
+  return false;
+}
+
+// Merge one scan result into wifiNets[], which stays sorted by RSSI. A
+// repeated SSID keeps only its strongest BSSID. When the list is full, a
+// weaker newcomer is dropped and a stronger one evicts the tail.
+static void wifiListInsert(const bss_info *bss) {
+  if (!bss || !bss->ssid_len) return;   // hidden or out of range
+  WiFiNet n;
+  uint8_t len = iMin(bss->ssid_len, 32);
+  memcpy(n.ssid, bss->ssid, len); n.ssid[len] = 0;
+  memcpy(n.bssid, bss->bssid, 6);
+  n.rssi = bss->rssi;
+  n.channel = bss->channel;
+  n.open = bss->authmode == AUTH_OPEN;
+
+  int pos = wifiNetCount;
+  for (int i = 0; i < wifiNetCount; i++) {
+    if (strcmp(wifiNets[i].ssid, n.ssid)) continue;
+    if (wifiNets[i].rssi >= n.rssi) return;
+    pos = i;   // stronger duplicate: reuse its slot and bubble up
+    break;
+  }
+  if (pos == wifiNetCount) {
+    if (wifiNetCount < WIFI_NET_MAX) wifiNetCount++;
+    else if (n.rssi <= wifiNets[WIFI_NET_MAX - 1].rssi) return;
+    else pos = WIFI_NET_MAX - 1;
+  }
+  while (pos > 0 && wifiNets[pos - 1].rssi < n.rssi) { wifiNets[pos] = wifiNets[pos - 1]; pos--; }
+  wifiNets[pos] = n;
+}
+
+// Replace wifiNets[] with the results of a finished (blocking) scan
 void sortAndStoreScanResults(int n) {
-  // temporary arrays
-  String ssids[32];
-  int rssis[32];
-  int enc[32];
-  int useCount = min(n, 16);
-  for (int i = 0; i < n && i < 32; i++) {
-    ssids[i] = WiFi.SSID(i);
-    rssis[i] = WiFi.RSSI(i);
-    enc[i] = WiFi.encryptionType(i);
-  }
-  // simple selection sort to pick top networks by RSSI
-  bool used[32] = {0};
   wifiNetCount = 0;
-  for (int k = 0; k < useCount; k++) {
-    int bestIdx = -1; int bestRssi = -9999;
-    for (int i = 0; i < n && i < 32; i++) {
-      if (used[i]) continue;
-      if (ssids[i].length() == 0) { used[i] = true; continue; }
-      if (rssis[i] > bestRssi) { bestRssi = rssis[i]; bestIdx = i; }
-    }
-    if (bestIdx < 0) break;
-    used[bestIdx] = true;
-    wifiNets[wifiNetCount].ssid = ssids[bestIdx];
-    wifiNets[wifiNetCount].rssi = rssis[bestIdx];
-    wifiNets[wifiNetCount].open = (enc[bestIdx] == ENC_TYPE_NONE);
-    wifiNetCount++;
-    if (wifiNetCount >= 16) break;
-  }
+  for (int i = 0; i < n; i++) wifiListInsert((const bss_info *)WiFi.getScanInfoByIndex(i));
+}
+
+static void markWifiListDirty() {
+  if (currentApp == APP_SETTINGS) markDirty(0, STATUS_BAR_H + 24, DISP_W, 18 + 6 * 16);
 }
 
-// Scan and store networks (UI-friendly)
+// Kicks off an async scan; wifiScanStep() polls it from the network task
 void scanWiFi() {
-  wifiScanDone = 0; needsFullRedraw = true;
-  tft.setCursor(8, 106); tft.setTextColor(C_FG); tft.print("Scanning WiFi...");
-  int n = WiFi.scanNetworks(true, true); // try async first (if supported)
-  if (n == -1) {
-    // fallback blocking scan
-    n = WiFi.scanNetworks();
+  if (wifiScanning) return;
+  WiFi.scanDelete();
+  if (WiFi.scanNetworks(true, false) != WIFI_SCAN_RUNNING) {
+    wifiScanDone = 1;
+    return;
   }
-  sortAndStoreScanResults(n);
-  wifiScanDone = 1; needsFullRedraw = true;
+  wifiScanning = true;
+  wifiScanNext = 0;
+  wifiScanDone = 0;
+  markWifiListDirty();
 }
 
-// Attempt to auto-connect: prefer known networks (matching SSID), otherwise try open networks.
-// Scans environment, sorts by signal, and tries connect in order. Updates TFT with status and highlights connected.
-void autoConnectToBest() {
-  tft.fillRect(0, STATUS_BAR_H, DISP_W, DISP_H-STATUS_BAR_H, C_BG);
-  tft.setTextSize(1); tft.setTextColor(C_FG);
-  tft.setCursor(8, STATUS_BAR_H + 20); tft.print("Auto-connecting to best network...");
-  tft.setCursor(8, STATUS_BAR_H + 36); tft.print("Scanning...");
-  needsFullRedraw = true;
-
-  int n = WiFi.scanNetworks();
-  if (n <= 0) {
-    tft.setCursor(8, STATUS_BAR_H + 52); tft.setTextColor(C_ERROR); tft.print("No networks found");
-    delay(1200);
-    scanWiFi();
+void wifiScanStep() {
+  if (!wifiScanning) return;
+  int n = WiFi.scanComplete();
+  if (n == WIFI_SCAN_RUNNING) return;
+  if (n < 0) {
+    wifiScanning = false; wifiScanDone = 1;
+    markWifiListDirty();
     return;
   }
+  if (wifiScanNext == 0) wifiNetCount = 0;
+  int end = iMin(n, wifiScanNext + WIFI_SCAN_BATCH);
+  for (; wifiScanNext < end; wifiScanNext++) wifiListInsert((const bss_info *)WiFi.getScanInfoByIndex(wifiScanNext));
+  if (wifiScanNext >= n) {
+    WiFi.scanDelete();
+    wifiScanning = false;
+    wifiScanDone = 1;
+  }
+  markWifiListDirty();
+}
 
-  // Prepare sorted list and attempt in order:
-  sortAndStoreScanResults(n);
+static WifiHistory *wifiHistoryFor(const char *ssid, bool create) {
+  WifiHistory *slot = nullptr;
+  for (auto &h : wifiHistory) {
+    if (!strcmp(h.ssid, ssid)) return &h;
+    if (!slot || h.ok + h.fail < slot->ok + slot->fail) slot = &h;
+  }
+  if (!create) return nullptr;
+  memset(slot, 0, sizeof(*slot));
+  strncpy(slot->ssid, ssid, sizeof(slot->ssid) - 1);
+  return slot;
+}
 
-  // First try known networks that are present
-  bool connected = false;
-  String connectedSSID = "";
+void wifiRecordAssoc(uint32_t ms) {
+  wifiAssocEmaMs = (uint16_t)iMin((3 * wifiAssocEmaMs + ms) / 4, 60000);
+}
 
-  for (int i = 0; i < wifiNetCount; i++) {
-    String s = wifiNets[i].ssid;
-    const char* pw = findKnownPassword(s);
-    if (pw != nullptr && strlen(pw) > 0) {
-      tft.setCursor(8, STATUS_BAR_H + 52 + (i*10)); tft.setTextColor(C_FG);
-      tft.printf("Trying known: %s", s.c_str());
-      WiFi.mode(WIFI_STA);
-      WiFi.begin(s.c_str(), pw);
-      uint32_t t0 = millis();
-      while (WiFi.status() != WL_CONNECTED && millis() - t0 < 8000) { delay(50); yield(); }
-      if (WiFi.status() == WL_CONNECTED) {
-        connected = true; connectedSSID = s; break;
-      }
-    }
+// Higher is better: signal first, then known over open, then track record
+static int autoConnScore(const WiFiNet &n) {
+  int s = n.rssi;
+  if (findKnownPassword(n.ssid)) s += 20;
+  WifiCache c;
+  if (loadWifiCache(c) && !strcmp(c.ssid, n.ssid)) s += 10;
+  if (const WifiHistory *h = wifiHistoryFor(n.ssid, false)) s += 8 * h->ok - 15 * h->fail;
+  return s;
+}
+
+static void autoConnSetProgress(const char *label, const char *ssid = "") {
+  snprintf(autoConn.progress, sizeof(autoConn.progress), "%s%s", label, ssid);
+  markWifiListDirty();
+}
+
+// Settings "Auto-connect": scans, ranks known/open networks and tries them
+// in the background; autoConnectStep() is driven by the network task.
+void autoConnectToBest() {
+  if (autoConn.state == AC_SCANNING || autoConn.state == AC_TRYING) return;
+  autoConn.state = AC_SCANNING;
+  autoConnSetProgress("Scanning...");
+  scanWiFi();
+}
+
+static void autoConnTryNext() {
+  while (autoConn.next < autoConn.count) {
+    const WiFiNet &n = autoConn.cand[autoConn.next++];
+    const char *pw = findKnownPassword(n.ssid);
+    if (!n.open && !pw) continue;
+    autoConn.tryStartMs = millis();
+    autoConn.timeoutMs = constrain(2 * wifiAssocEmaMs + 1000, AC_TIMEOUT_MIN_MS, AC_TIMEOUT_MAX_MS);
+    autoConn.state = AC_TRYING;
+    strcpy(autoConn.trying, n.ssid);
+    autoConnSetProgress("Trying ", n.ssid);
+    Serial.printf("Auto-connect: trying %s (timeout %lu ms)\n", n.ssid, (unsigned long)autoConn.timeoutMs);
+    WiFi.mode(WIFI_STA);
+    WiFi.begin(n.ssid, n.open ? nullptr : pw, n.channel, n.bssid);
+    return;
   }
+  autoConn.state = AC_FAILED;
+  autoConn.doneMs = millis();
+  autoConnSetProgress("Auto-connect failed");
+  Serial.println("Auto-connect: failed to find/connect");
+}
 
-  // If not connected, try open networks (strongest first)
-  if (!connected) {
-    for (int i = 0; i < wifiNetCount; i++) {
-      if (wifiNets[i].open) {
-        String s = wifiNets[i].ssid;
-        tft.setCursor(8, STATUS_BAR_H + 52 + (i*10)); tft.setTextColor(C_FG);
-        tft.printf("Trying open: %s", s.c_str());
-        WiFi.mode(WIFI_STA);
-        WiFi.begin(s.c_str());
-        uint32_t t0 = millis();
-        while (WiFi.status() != WL_CONNECTED && millis() - t0 < 6000) { delay(50); yield(); }
-        if (WiFi.status() == WL_CONNECTED) {
-          connected = true; connectedSSID = s; break;
-        }
+void autoConnectStep() {
+  switch (autoConn.state) {
+    case AC_SCANNING: {
+      if (wifiScanning) return;
+      // Rank usable networks: insertion sort of at most AC_MAX_CANDIDATES
+      int score[AC_MAX_CANDIDATES];
+      autoConn.count = autoConn.next = 0;
+      for (int i = 0; i < wifiNetCount; i++) {
+        if (!wifiNets[i].open && !findKnownPassword(wifiNets[i].ssid)) continue;
+        int s = autoConnScore(wifiNets[i]);
+        int pos = autoConn.count;
+        if (pos == AC_MAX_CANDIDATES) {
+          if (s <= score[pos - 1]) continue;
+          pos--;
+        } else autoConn.count++;
+        while (pos > 0 && score[pos - 1] < s) { score[pos] = score[pos - 1]; autoConn.cand[pos] = autoConn.cand[pos - 1]; pos--; }
+        score[pos] = s; autoConn.cand[pos] = wifiNets[i];
       }
+      autoConnTryNext();
+      return;
     }
-  }
-
-  if (connected) {
-    tft.fillRect(8, STATUS_BAR_H + 52, DISP_W-16, 30, C_BG);
-    tft.setCursor(8, STATUS_BAR_H + 52); tft.setTextColor(C_SUCCESS);
-    tft.printf("Connected: %s", connectedSSID.c_str());
-    Serial.printf("Auto-connected to: %s\n", connectedSSID.c_str());
-    // update MDNS & server if needed
-    if (MDNS.begin(DEVICE_NAME)) MDNS.addService("http","tcp",80);
-    if (!webServerRunning) {
-      server.on("/", handleRoot);
-      server.on("/api", handleAPI);
-      server.on("/beep", handleBeep);
-      server.on("/message", handleMessage);
-      server.begin();
-      webServerRunning = true;
+    case AC_TRYING: {
+      const char *ssid = autoConn.trying;
+      wl_status_t st = WiFi.status();
+      uint32_t elapsed = millis() - autoConn.tryStartMs;
+      if (st == WL_CONNECTED) {
+        wifiRecordAssoc(elapsed);
+        wifiHistoryFor(ssid, true)->ok++;
+        autoConn.state = AC_DONE;
+        autoConn.doneMs = millis();
+        autoConnSetProgress("Connected: ", ssid);
+        Serial.printf("Auto-connected to: %s in %lu ms\n", ssid, (unsigned long)elapsed);
+        saveWifiCache();
+        startNetworkServices();
+        weatherRequest();
+      } else if (st == WL_CONNECT_FAILED || st == WL_WRONG_PASSWORD || elapsed > autoConn.timeoutMs) {
+        wifiHistoryFor(ssid, true)->fail++;
+        WiFi.disconnect();
+        autoConnTryNext();
+      }
+      return;
     }
-  } else {
-    tft.fillRect(8, STATUS_BAR_H + 52, DISP_W-16, 30, C_BG);
-    tft.setCursor(8, STATUS_BAR_H + 52); tft.setTextColor(C_ERROR); tft.print("Auto-connect failed");
-    Serial.println("Auto-connect: failed to find/connect");
+    case AC_DONE:
+    case AC_FAILED:
+      // The result stays on screen for a few seconds
+      if (millis() - autoConn.doneMs > 5000) { autoConn.state = AC_IDLE; markWifiListDirty(); }
+      return;
+    default:
+      return;
   }
+}
 
-  // Refresh scan results (so UI shows networks and highlights connected)
-  scanWiFi();
-  needsFullRedraw = true;
-  delay(800);
+// Web server and mDNS come up once, whichever path connects first
+void startNetworkServices() {
+  if (!MDNS.isRunning() && MDNS.begin(DEVICE_NAME)) MDNS.addService("http","tcp",80);
+  if (webServerRunning) return;
+  server.on("/", handleRoot);
+  server.on("/api", handleAPI);
+  server.on("/beep", handleBeep);
+  server.on("/message", handleMessage);
+  server.on("/metrics", handleMetrics);
+  server.on("/events", handleEvents);
+  server.on("/history", handleHistory);
+  server.collectHeaders(webHeaderKeys, 1);
+  server.begin();
+  webServerRunning = true; // mark server as running
+  Serial.println("Web server at miniconsole.local");
 }
 
-// Existing connectToWiFi: attempt known networks first, then open networks
-void connectToWiFi() {
-  tft.setCursor(8,106); tft.setTextColor(C_FG); tft.print("Connecting WiFi...");
+// Existing connectToWiFi: cached BSSID/channel first, then known networks,
+// then open networks. Returns how it got connected (for the boot log).
+const char *connectToWiFi() {
+  gfx.setCursor(8,106); gfx.setTextColor(C_FG); gfx.print("Connecting WiFi...");
+  WiFi.persistent(false);   // we keep our own record; don't rewrite SDK flash per begin()
   WiFi.mode(WIFI_STA);
 
+  if (fastJoinFromCache()) {
+    gfx.setCursor(8, 106); gfx.print("WiFi OK (cached) ");
+    Serial.printf("WiFi connected (cached): %s\n", WiFi.SSID().c_str());
+    return "cached";
+  }
+
   // Try known networks (from knownNets array) first
-  bool connected = false;
   for (int i = 0; i < KNOWN_NET_COUNT; i++) {
     const char* ssid = knownNets[i].ssid;
     const char* pass = knownNets[i].pass;
     if (ssid == nullptr || strlen(ssid) == 0) continue;
     Serial.printf("Trying known network: %s\n", ssid);
-    tft.setCursor(8, 106); tft.print("Trying: "); tft.print(ssid);
+    gfx.setCursor(8, 106); gfx.print("Trying: "); gfx.print(ssid);
     WiFi.begin(ssid, pass);
     uint32_t st = millis();
     while (WiFi.status() != WL_CONNECTED && millis() - st < 7000) {
@@ -1260,68 +3342,66 @@ void connectToWiFi() {
       yield();
     }
     if (WiFi.status() == WL_CONNECTED) {
-      connected = true;
-      tft.setCursor(8, 106); tft.print("WiFi OK (known)  ");
+      gfx.setCursor(8, 106); gfx.print("WiFi OK (known)  ");
       Serial.printf("WiFi connected (known): %s\n", WiFi.SSID().c_str());
-      break;
+      saveWifiCache();
+      return "known";
     }
   }
 
   // If still not connected, try open networks from a scan
-  if (!connected) {
-    Serial.println("Primary known networks failed. Scanning for open networks...");
-    tft.setCursor(8,106); tft.print("Scanning for open...");
-    int n = WiFi.scanNetworks();
-    sortAndStoreScanResults(n);
-    for (int i=0;i<wifiNetCount;i++) {
-      if (wifiNets[i].open) {
-        tft.setCursor(8, 106); tft.print("Trying open: "); tft.print(wifiNets[i].ssid);
-        WiFi.begin(wifiNets[i].ssid.c_str());
-        uint32_t t0 = millis();
-        while (WiFi.status() != WL_CONNECTED && millis() - t0 < 8000) { 
-          delay(50); yield(); 
-        }
-        if (WiFi.status() == WL_CONNECTED) {
-          connected = true;
-          tft.setCursor(8, 106); tft.print("WiFi OK (Open)  ");
-          Serial.printf("WiFi connected (open): %s\n", WiFi.SSID().c_str());
-          break;
-        }
+  Serial.println("Primary known networks failed. Scanning for open networks...");
+  gfx.setCursor(8,106); gfx.print("Scanning for open...");
+  int n = WiFi.scanNetworks();
+  sortAndStoreScanResults(n);
+  for (int i=0;i<wifiNetCount;i++) {
+    if (wifiNets[i].open) {
+      gfx.setCursor(8, 106); gfx.print("Trying open: "); gfx.print(wifiNets[i].ssid);
+      WiFi.begin(wifiNets[i].ssid);
+      uint32_t t0 = millis();
+      while (WiFi.status() != WL_CONNECTED && millis() - t0 < 8000) { 
+        delay(50); yield(); 
+      }
+      if (WiFi.status() == WL_CONNECTED) {
+        gfx.setCursor(8, 106); gfx.print("WiFi OK (Open)  ");
+        Serial.printf("WiFi connected (open): %s\n", WiFi.SSID().c_str());
+        saveWifiCache();
+        return "open";
       }
-    }
-    if (!connected) {
-      tft.setCursor(8, 106); tft.setTextColor(C_ERROR); tft.print("WiFi Failed     ");
     }
   }
+  gfx.setCursor(8, 106); gfx.setTextColor(C_ERROR); gfx.print("WiFi Failed     ");
+  return "failed";
 }
 
 // ---------------- WEB UI ----------------
 void drawWebMessage() {
-  int boxW = 140, boxH = 50;
-  int boxX = (DISP_W - boxW) / 2;
-  int boxY = (DISP_H - boxH) / 2;
+  int boxW = WEB_MSG_W, boxH = WEB_MSG_H;
+  int boxX = WEB_MSG_X;
+  int boxY = WEB_MSG_Y;
   
-  tft.fillRoundRect(boxX, boxY, boxW, boxH, 8, C_PANEL);
-  tft.drawRoundRect(boxX, boxY, boxW, boxH, 8, C_ACCENT);
+  gfx.fillRoundRect(boxX, boxY, boxW, boxH, 8, C_PANEL);
+  gfx.drawRoundRect(boxX, boxY, boxW, boxH, 8, C_ACCENT);
   
-  tft.setTextSize(1); tft.setTextColor(C_ACCENT);
-  tft.setCursor(boxX + 10, boxY + 8);
-  tft.print("Web Message:");
+  gfx.setTextSize(1); gfx.setTextColor(C_ACCENT);
+  gfx.setCursor(boxX + 10, boxY + 8);
+  gfx.print("Web Message:");
   
-  tft.setTextColor(C_FG);
+  gfx.setTextColor(C_FG);
   // Word wrap for long messages
   int lineY = boxY + 22;
   int charPerLine = 20;
   for (int i = 0; i < webMessage.length(); i += charPerLine) {
     String line = webMessage.substring(i, min((int)webMessage.length(), i + charPerLine));
-    tft.setCursor(boxX + 10, lineY);
-    tft.print(line);
+    gfx.setCursor(boxX + 10, lineY);
+    gfx.print(line);
     lineY += 10;
     if (lineY > boxY + boxH - 10) break;
   }
 }
 
-void redrawScreen() {
+void drawApp() {
+  if (calib.state != CALIB_IDLE) { drawCalibration(); return; }
   switch (currentApp) {
     case APP_HOME: drawHome(); break;
     case APP_LAUNCHER: drawLauncher(); break;
@@ -1336,7 +3416,24 @@ void redrawScreen() {
     case APP_SETTINGS: drawSettings(); break;
     default: drawHome(); break;
   }
-  drawStatusBar();
+}
+
+// Fast updates for dynamic content
+void updateApp() {
+  if (calib.state != CALIB_IDLE) return; // calibration screen owns the body
+  if (currentApp == APP_HOME) updateHomeClockHands();
+  else if (currentApp == APP_COMPASS) updateCompass();
+  else if (currentApp == APP_ACCEL) updateAccel();
+  else if (currentApp == APP_CLOCK) updateClock();
+  else if (currentApp == APP_PONG && pongGameActive) updatePong();
+  else if (currentApp == APP_SPACESHOOTER && shooterGameActive) updateSpaceShooter();
+}
+
+void redrawScreen() {
+  dirtyCount = 0;
+  markDirty(0, 0, DISP_W, DISP_H);
+  flushDamage();
+  drawCursor(cursorX, cursorY);
   needsFullRedraw = false;
 }
 
@@ -1383,51 +3480,58 @@ void drawCursor(int x, int y) {
       x >= DISP_W - CURSOR_SIZE/2 || y >= DISP_H - CURSOR_SIZE/2) return;
 
   // Draw small crosshair cursor
-  tft.drawLine(x - CURSOR_SIZE, y, x + CURSOR_SIZE, y, C_CURSOR);
-  tft.drawLine(x, y - CURSOR_SIZE, x, y + CURSOR_SIZE, C_CURSOR);
-  tft.drawPixel(x, y, C_FG); // Center dot
+  gfx.drawLine(x - CURSOR_SIZE, y, x + CURSOR_SIZE, y, C_CURSOR);
+  gfx.drawLine(x, y - CURSOR_SIZE, x, y + CURSOR_SIZE, C_CURSOR);
+  gfx.drawPixel(x, y, C_FG); // Center dot
 }
 
 void showBootScreen() {
-  tft.fillScreen(C_BG);
-  tft.setTextSize(2); tft.setTextColor(C_ACCENT); 
-  tft.setCursor(8,12); tft.print("MiniConsole");
-  tft.setTextSize(1); tft.setTextColor(C_FG); 
-  tft.setCursor(8,40); tft.print("Enhanced v58");
+  gfx.fillScreen(C_BG);
+  gfx.setTextSize(2); gfx.setTextColor(C_ACCENT); 
+  gfx.setCursor(8,12); gfx.print("MiniConsole");
+  gfx.setTextSize(1); gfx.setTextColor(C_FG); 
+  gfx.setCursor(8,40); gfx.print("Enhanced v58");
   int bw = DISP_W - 40; int bx = 20, by = 70;
-  tft.drawRect(bx, by, bw, 12, C_FG);
+  gfx.drawRect(bx, by, bw, 12, C_FG);
   for (int p=0;p<=bw;p+=4) {
-    tft.fillRect(bx+1, by+1, p, 10, C_ACCENT);
+    gfx.fillRect(bx+1, by+1, p, 10, C_ACCENT);
     delay(10);
   }
-  tft.setCursor(8,100); tft.print("Ready");
+  gfx.setCursor(8,100); gfx.print("Ready");
 }
 
 // ---------------- UI: Settings with Auto-connect button ----------------
 void drawSettings() {
-  tft.fillRect(0,STATUS_BAR_H,DISP_W,DISP_H-STATUS_BAR_H,C_BG);
-  tft.setTextSize(1); tft.setTextColor(C_FG); 
-  tft.setCursor(10, STATUS_BAR_H+10); tft.print("Settings");
-  tft.setCursor(10, STATUS_BAR_H+26); tft.print("WiFi Networks:");
-  if (wifiScanDone == 0) { 
-    tft.setCursor(10, STATUS_BAR_H+44); tft.print("Scanning..."); 
+  gfx.fillRect(0,STATUS_BAR_H,DISP_W,DISP_H-STATUS_BAR_H,C_BG);
+  gfx.setTextSize(1); gfx.setTextColor(C_FG); 
+  gfx.setCursor(10, STATUS_BAR_H+10); gfx.print("Settings");
+  gfx.setCursor(DISP_W-70, STATUS_BAR_H+10); gfx.print(profOverlay ? "Stats: on" : "Stats: off");
+  gfx.setCursor(10, STATUS_BAR_H+26); gfx.print("WiFi Networks:");
+  if (autoConn.state != AC_IDLE) {
+    gfx.fillRect(10, STATUS_BAR_H+26, DISP_W-10, 8, C_BG);
+    gfx.setCursor(10, STATUS_BAR_H+26);
+    gfx.setTextColor(autoConn.state == AC_FAILED ? C_ERROR : autoConn.state == AC_DONE ? C_SUCCESS : C_ACCENT);
+    gfx.print(autoConn.progress); gfx.setTextColor(C_FG);
+  } else if (wifiScanning) { gfx.setTextColor(C_ACCENT); gfx.print(" scanning"); gfx.setTextColor(C_FG); }
+  if (wifiScanDone == 0 && wifiNetCount == 0) { 
+    gfx.setCursor(10, STATUS_BAR_H+44); gfx.print("Scanning..."); 
   } else {
     String currentSSID = WiFi.SSID();
     int displayCount = min(wifiNetCount,6);
     for (int i=0;i<displayCount;i++) {
       int y = STATUS_BAR_H + 44 + i*16;
-      bool connected = (wifiNets[i].ssid == currentSSID && WiFi.status() == WL_CONNECTED);
+      bool connected = (currentSSID == wifiNets[i].ssid && WiFi.status() == WL_CONNECTED);
       if (connected) {
-        tft.fillRoundRect(8, y, DISP_W-16, 14, 3, C_SELECTED);
+        gfx.fillRoundRect(8, y, DISP_W-16, 14, 3, C_SELECTED);
       } else {
-        tft.fillRoundRect(8, y, DISP_W-16, 14, 3, C_PANEL);
+        gfx.fillRoundRect(8, y, DISP_W-16, 14, 3, C_PANEL);
       }
-      tft.setTextColor(connected?C_BG:C_FG); 
-      tft.setCursor(12, y+3); tft.print(wifiNets[i].ssid);
-      tft.setCursor(DISP_W-44, y+3); 
-      tft.setTextColor(connected?C_BG:C_FG);
-      tft.print(wifiNets[i].rssi);
-      if (wifiNets[i].open) { tft.setCursor(DISP_W-28, y+3); tft.print("O"); }
+      gfx.setTextColor(connected?C_BG:C_FG); 
+      gfx.setCursor(12, y+3); gfx.print(wifiNets[i].ssid);
+      gfx.setCursor(DISP_W-44, y+3); 
+      gfx.setTextColor(connected?C_BG:C_FG);
+      gfx.print(wifiNets[i].rssi);
+      if (wifiNets[i].open) { gfx.setCursor(DISP_W-28, y+3); gfx.print("O"); }
     }
   }
 
@@ -1436,20 +3540,21 @@ void drawSettings() {
   int by = DISP_H - 22;
   int bw = 88;
   int bh = 16;
-  tft.fillRoundRect(bx, by, bw, bh, 3, C_PANEL);
-  tft.drawRoundRect(bx, by, bw, bh, 3, C_ACCENT);
-  tft.setCursor(bx + 10, by + 4); tft.setTextColor(C_FG); tft.print("Auto-connect");
+  gfx.fillRoundRect(bx, by, bw, bh, 3, C_PANEL);
+  gfx.drawRoundRect(bx, by, bw, bh, 3, C_ACCENT);
+  gfx.setCursor(bx + 10, by + 4); gfx.setTextColor(C_FG); gfx.print("Auto-connect");
 
   // Rescan hint (bottom-left)
-  tft.setTextColor(C_FG); tft.setCursor(10, DISP_H-10); 
-  tft.print("Press to rescan");
+  gfx.setTextColor(C_FG); gfx.setCursor(10, DISP_H-10); 
+  gfx.print("Press to rescan");
 }
 
 // ---------------- REDRAW & UI ----------------
 void drawWebMessage(); // declared above
 
 // ---------------- INPUT HANDLERS ----------------
-void handleCalcPress(int px,int py) {
+void handleCalcPress(const InputEvent &ev) {
+  int px = ev.x, py = ev.y;
   int btnW = 32, btnH = 16, gap = 3, startX = 10, startY = STATUS_BAR_H + 32;
   const char* labels[] = {"7","8","9","/","4","5","6","*","1","2","3","-","0",".","=","+"};
   for (int i=0;i<16;i++) {
@@ -1473,30 +3578,36 @@ void handleCalcPress(int px,int py) {
         if (strcmp(calcDisplay,"0")==0) calcDisplay[0]=0; 
         if (strlen(calcDisplay) < 18) strcat(calcDisplay, lab); 
       }
-      needsFullRedraw = true; return;
+      markDirty(8, STATUS_BAR_H+6, DISP_W-16, 18); return;
     }
   }
 }
 
-void handleTTTPress(int px,int py) {
+void markTTTCell(int i) {
+  int s = 34, ox = (DISP_W - s*3)/2, oy = STATUS_BAR_H + 14;
+  markDirty(ox + (i%3)*s, oy + (i/3)*s, s, s);
+}
+
+void handleTTTPress(const InputEvent &ev) {
+  int px = ev.x, py = ev.y;
+  int s = 34, ox = (DISP_W - s*3)/2, oy = STATUS_BAR_H + 14;
   if (tttGameOver) { 
     for (int i=0;i<9;i++) tttBoard[i]=0; 
     tttTurn=1; tttGameOver=false; 
-    needsFullRedraw=true; playClick(); return; 
+    markDirty(0, oy, DISP_W, DISP_H - oy); playClick(); return; 
   }
-  int s = 34, ox = (DISP_W - s*3)/2, oy = STATUS_BAR_H + 14;
   for (int i=0;i<9;i++) {
     int x = ox + (i%3)*s, y = oy + (i/3)*s;
     if (px >= x && px < x+s && py >= y && py < y+s && tttBoard[i]==0) {
-      tttBoard[i]=tttTurn; playClick();
+      tttBoard[i]=tttTurn; playClick(); markTTTCell(i);
       if (checkWin(tttTurn)) { 
-        tttGameOver=true; needsFullRedraw=true; return; 
+        tttGameOver=true; markDirty(DISP_W/2-40, DISP_H/2+36, 80, 20); return; 
       }
       tttTurn = (tttTurn==1)?2:1;
       if (tttTurn==2) { 
         int ai = findBestTTTMove(2,1); 
         if (ai>=0) { 
-          tttBoard[ai]=2; 
+          tttBoard[ai]=2; markTTTCell(ai);
           if (checkWin(2)) tttGameOver=true;
         } 
         tttTurn=1; 
@@ -1504,12 +3615,14 @@ void handleTTTPress(int px,int py) {
       int empty=0; 
       for (int j=0;j<9;j++) if (tttBoard[j]==0) empty++;
       if (empty==0 && !tttGameOver) tttGameOver=true;
-      needsFullRedraw=true; break;
+      if (tttGameOver) markDirty(DISP_W/2-40, DISP_H/2+36, 80, 20);
+      break;
     }
   }
 }
 
-void handleGamesPress(int px, int py) {
+void handleGamesPress(const InputEvent &ev) {
+  int px = ev.x, py = ev.y;
   int btnW = DISP_W - 20, btnH = 24, gap = 8, startY = STATUS_BAR_H + 28;
   for (int i = 0; i < 3; i++) {
     int y = startY + i * (btnH + gap);
@@ -1521,20 +3634,10 @@ void handleGamesPress(int px, int py) {
         tttTurn = 1; tttGameOver = false;
       } else if (i == 1) {
         currentApp = APP_PONG;
-        pongScore1 = 0; pongScore2 = 0;
-        pongBallX = 80; pongBallY = 64;
-        pongBallVX = 2.2f; pongBallVY = 1.8f;
-        pongPaddle1Y = 40; pongPaddle2Y = 40;
-        pongGameActive = true;
-        lastBallX = 80; lastBallY = 64;
+        pongReset();
       } else if (i == 2) {
         currentApp = APP_SPACESHOOTER;
-        shooterScore = 0; shipX = 80; shipY = 100;
-        lastShipX = 80;
-        for (int j = 0; j < 8; j++) bullets[j].active = false;
-        for (int j = 0; j < 10; j++) enemies[j].active = false;
-        shooterGameActive = true;
-        lastEnemySpawn = millis();
+        shooterReset();
       }
       needsFullRedraw = true; playNavigate();
       break;
@@ -1542,28 +3645,79 @@ void handleGamesPress(int px, int py) {
   }
 }
 
-void mapJoystickToMovement(int rawXv,int rawYv,int &moveX,int &moveY) {
-  int dx = rawXv - centerX, dy = rawYv - centerY;
-  int thr = 80;
-  int mvx = 0, mvy = 0;
-  if (abs(dx) > thr) mvx = (dx > 0)?1:-1;
-  if (abs(dy) > thr) mvy = (dy > 0)?1:-1;
-  switch (joystick_rotation) {
-    case 0: moveX = mvx; moveY = mvy; break;
-    case 90: moveX = mvy; moveY = -mvx; break;
-    case 180: moveX = -mvx; moveY = -mvy; break;
-    case 270: default: moveX = -mvy; moveY = mvx; break;
+// Short press: route to whatever is under the cursor in the current app
+void handleClick(const InputEvent &ev) {
+  playClick();
+  if (currentApp == APP_HOME) {
+    currentApp = APP_LAUNCHER; needsFullRedraw = true; playNavigate();
+  }
+  else if (currentApp == APP_LAUNCHER) {
+    for (int i=0;i<6;i++) {
+      Icon &ic = launcherIcons[i];
+      if (ev.x >= ic.x && ev.x < ic.x+ic.w && 
+          ev.y >= ic.y && ev.y < ic.y+ic.h) {
+        currentApp = ic.app; needsFullRedraw = true; playNavigate();
+        if (currentApp == APP_SETTINGS) scanWiFi();
+        break;
+      }
+    }
+  } 
+  else if (currentApp == APP_CALCULATOR) handleCalcPress(ev);
+  else if (currentApp == APP_TICTACTOE) handleTTTPress(ev);
+  else if (currentApp == APP_GAMES) handleGamesPress(ev);
+  else if (currentApp == APP_PONG && !pongGameActive) {
+    pongReset();
+    needsFullRedraw = true;
+  }
+  else if (currentApp == APP_SPACESHOOTER) {
+    if (!shooterGameActive) {
+      shooterReset();
+      needsFullRedraw = true;
+    } else {
+      gameInput.fire = true;   // taken by the next tick, subject to cooldown
+    }
+  }
+  else if (currentApp == APP_COMPASS || currentApp == APP_ACCEL) {
+    if (ev.x >= 8 && ev.x < 80 && ev.y >= DISP_H - 22) {
+      startCalibration();
+    }
+  } 
+  else if (currentApp == APP_SETTINGS) {
+    // Determine if Auto-connect button pressed (bottom-right)
+    int bx = DISP_W - 96;
+    int by = DISP_H - 22;
+    int bw = 88;
+    int bh = 16;
+    if (ev.x >= bx && ev.x < bx + bw && ev.y >= by && ev.y < by + bh) {
+      // Auto-connect pressed
+      playNavigate();
+      autoConnectToBest();
+    } else if (ev.y < STATUS_BAR_H + 22) {
+      // Title row toggles the profiler overlay
+      profOverlay = !profOverlay;
+      markDirty(0, 0, DISP_W, STATUS_BAR_H);
+      markDirty(DISP_W-70, STATUS_BAR_H+10, 66, 8);
+    } else {
+      // Default: rescan networks
+      scanWiFi();
+    }
   }
 }
 
 void setup() {
+#if SPEAKER_PIN == 3
+  Serial.begin(115200, SERIAL_8N1, SERIAL_TX_ONLY);   // RX (GPIO3) is the speaker
+#else
   Serial.begin(115200);
+#endif
   Serial.println("\n=== MiniConsole Enhanced v58 ===");
+  uint32_t bootMs[5];   // stage end times for the boot breakdown
 
   pinMode(MUX_S0, OUTPUT);
   pinMode(JOY_SW, INPUT_PULLUP);
   pinMode(SPEAKER_PIN, OUTPUT);
   digitalWrite(SPEAKER_PIN, LOW);
+  audioBegin();
 
   // Initialize SPI at 8mhz for display
   SPI.begin();
@@ -1573,43 +3727,40 @@ void setup() {
   tft.setRotation(1);
   showBootScreen();
   Serial.println("TFT initialized (8mhz SPI)");
+  bootMs[0] = millis();
 
   Wire.begin(MPU_SDA, MPU_SCL);
   Wire.setClock(400000); // Fast I2C
-  Wire.beginTransmission((uint8_t)MPU_ADDR);
-  Wire.write(0x6B);
-  Wire.write(0);
-  Wire.endTransmission();
+  mpuWriteReg(MPU_REG_PWR_MGMT_1, 0);
+#if MPU_USE_FIFO
+  mpuSetupFifo();
+#endif
   Serial.println("MPU initialized");
+  bootMs[1] = millis();
 
   EEPROM.begin(EEPROM_SIZE);
   if (loadCalibration()) {
     calibrated = true;
-    tft.setCursor(8,110); tft.setTextColor(C_FG); 
-    tft.print("Calibration loaded");
+    gfx.setCursor(8,110); gfx.setTextColor(C_FG); 
+    gfx.print("Calibration loaded");
   }
 
   long sumX=0, sumY=0;
   for (int i=0;i<50;i++) { sumX += readMux(0); sumY += readMux(1); delay(15); }
   centerX = (int)(sumX / 50); centerY = (int)(sumY / 50);
+  joyBegin();
+  inputBegin();
+  bootMs[2] = millis();
 
-  connectToWiFi();
+  const char *wifiHow = connectToWiFi();
+  bootMs[3] = millis();
 
   if (WiFi.status() == WL_CONNECTED) {
-    syncNTP();
-    delay(500);
-    fetchWeather();
-    weatherLastFetch = millis();
+    ntpStep();   // starts SNTP; completion is polled from the network task
     
-    if (MDNS.begin(DEVICE_NAME)) MDNS.addService("http","tcp",80);
-    server.on("/", handleRoot);
-    server.on("/api", handleAPI);
-    server.on("/beep", handleBeep);
-    server.on("/message", handleMessage);
-    server.begin();
-    webServerRunning = true; // mark server as running
-    Serial.println("Web server at miniconsole.local");
+    startNetworkServices();
   }
+  bootMs[4] = millis();
 
   playClick();
   delay(200);
@@ -1623,140 +3774,88 @@ void setup() {
 
   needsFullRedraw = true;
   timerMicros = micros();
+  schedulerBegin();
+  snprintf(bootBreakdown, sizeof(bootBreakdown), "boot tft %lu mpu %lu calib+joy %lu wifi(%s) %lu services %lu total %lu ms",
+           (unsigned long)bootMs[0], (unsigned long)(bootMs[1] - bootMs[0]), (unsigned long)(bootMs[2] - bootMs[1]),
+           wifiHow, (unsigned long)(bootMs[3] - bootMs[2]), (unsigned long)(bootMs[4] - bootMs[3]), millis());
+  Serial.println(bootBreakdown);
   Serial.println("Setup complete");
 }
 
-void handleCalcPressArea(int px,int py) { handleCalcPress(px,py); }
-void handleTTTPressArea(int px,int py) { handleTTTPress(px,py); }
+void handleCalcPressArea(int px,int py) { handleCalcPress({ EV_CLICK, (uint32_t)millis(), (int16_t)px, (int16_t)py }); }
+void handleTTTPressArea(int px,int py) { handleTTTPress({ EV_CLICK, (uint32_t)millis(), (int16_t)px, (int16_t)py }); }
 
-// ---------------- MAIN LOOP ----------------
-void loop() {
+// ---------------- TASKS ----------------
+void taskSensor() {
+  { ProfScope p(PROF_IMU); updateMPU6050(); }
+  { ProfScope p(PROF_CALIB); stepCalibration(); }
+}
+
+void taskNetwork() {
+  { ProfScope p(PROF_HTTP); server.handleClient(); }
+  if (MDNS.isRunning()) { ProfScope p(PROF_MDNS); MDNS.update(); }
+
+  // Periodic updates
+  { ProfScope p(PROF_WEATHER); weatherStep(); }
+  { ProfScope p(PROF_NTP); ntpStep(); }
+  wifiScanStep();
+  autoConnectStep();
+}
+
+void taskJoystick() {
+  joySample();
+  inputPoll();
+}
+
+void taskPush() {
+  ProfScope p(PROF_PUSH);
+  ssePush();
+}
+
+void taskAudio() {
+  ProfScope p(PROF_AUDIO);
+  updateSpeaker();
+}
+
+void taskUI() {
   static uint32_t frameCount = 0;
   static uint32_t lastFPSUpdate = 0;
-  uint32_t loopStart = millis();
+  uint32_t frameStart = millis();
 
-  if (loopStart - lastFPSUpdate >= 1000) {
-    fps = frameCount; frameCount = 0; lastFPSUpdate = loopStart;
-    freeHeap = ESP.getFreeHeap();
+  if (frameStart - lastFPSUpdate >= 1000) {
+    fps = frameCount; frameCount = 0; lastFPSUpdate = frameStart;
+    profSampleHeap();
+    if (profOverlay) markDirty(0, 0, DISP_W, STATUS_BAR_H);
   }
 
-  updateMPU6050();
-
-  rawX = readMux(0);
-  rawY = readMux(1);
-  btnPressed = (digitalRead(JOY_SW) == LOW);
+  uint32_t inputStart = ESP.getCycleCount();
 
+  // Proportional movement: full tilt = joystick_speed px per frame
   int mvx=0,mvy=0; 
   mapJoystickToMovement(rawX, rawY, mvx, mvy);
+  joyVecX = mvx; joyVecY = mvy;
   int step = constrain((int)joystick_speed,1,15);
-  int newCursorX = constrain(cursorX + mvx * step, CURSOR_SIZE, DISP_W - CURSOR_SIZE);
-  int newCursorY = constrain(cursorY + mvy * step, STATUS_BAR_H + CURSOR_SIZE, DISP_H - CURSOR_SIZE);
+  int newCursorX = constrain(cursorX + joyStep(cursorSubX, mvx, step), CURSOR_SIZE, DISP_W - CURSOR_SIZE);
+  int newCursorY = constrain(cursorY + joyStep(cursorSubY, mvy, step), STATUS_BAR_H + CURSOR_SIZE, DISP_H - CURSOR_SIZE);
 
-  // Game-specific controls
-  if (currentApp == APP_PONG && pongGameActive) {
-    if (mvy != 0) {
-      pongPaddle1Y = constrain(pongPaddle1Y + mvy * 4, STATUS_BAR_H, DISP_H - PADDLE_H);
-    }
-  }
-  if (currentApp == APP_SPACESHOOTER && shooterGameActive) {
-    shipX = constrain(shipX + mvx * 4, 10, DISP_W - 10);
-  }
+  // Games read the stick once per tick
+  gameInput.vx = mvx; gameInput.vy = mvy;
 
-  // Button handling
-  static uint32_t btnStart = 0;
-  if (btnPressed && !lastBtnPressed) btnStart = millis();
-  else if (!btnPressed && lastBtnPressed) {
-    uint32_t dur = millis() - btnStart;
-    if (dur < 1000) {
-      playClick();
-      if (currentApp == APP_HOME) {
-        currentApp = APP_LAUNCHER; needsFullRedraw = true; playNavigate();
-      }
-      else if (currentApp == APP_LAUNCHER) {
-        for (int i=0;i<6;i++) {
-          Icon &ic = launcherIcons[i];
-          if (newCursorX >= ic.x && newCursorX < ic.x+ic.w && 
-              newCursorY >= ic.y && newCursorY < ic.y+ic.h) {
-            currentApp = ic.app; needsFullRedraw = true; playNavigate();
-            if (currentApp == APP_SETTINGS) scanWiFi();
-            break;
-          }
-        }
-      } 
-      else if (currentApp == APP_CALCULATOR) handleCalcPress(newCursorX, newCursorY);
-      else if (currentApp == APP_TICTACTOE) handleTTTPress(newCursorX, newCursorY);
-      else if (currentApp == APP_GAMES) handleGamesPress(newCursorX, newCursorY);
-      else if (currentApp == APP_PONG && !pongGameActive) {
-        pongScore1 = 0; pongScore2 = 0;
-        pongBallX = 80; pongBallY = 64;
-        pongBallVX = 2.2f; pongBallVY = 1.8f;
-        pongGameActive = true;
-        needsFullRedraw = true;
-      }
-      else if (currentApp == APP_SPACESHOOTER) {
-        if (!shooterGameActive) {
-          shooterScore = 0; shipX = 80;
-          for (int i = 0; i < 8; i++) bullets[i].active = false;
-          for (int i = 0; i < 10; i++) enemies[i].active = false;
-          shooterGameActive = true;
-          lastEnemySpawn = millis();
-          needsFullRedraw = true;
-        } else if (millis() - lastBulletTime > 200) {
-          for (int i = 0; i < 8; i++) {
-            if (!bullets[i].active) {
-              bullets[i].x = shipX;
-              bullets[i].y = shipY - 6;
-              bullets[i].active = true;
-              lastBulletTime = millis();
-              
-              break;
-            }
-          }
-        }
-      }
-      else if (currentApp == APP_COMPASS || currentApp == APP_ACCEL) {
-        if (newCursorX >= 8 && newCursorX < 80 && newCursorY >= DISP_H - 22) {
-          calibrateSensors();
-        }
-      } 
-      else if (currentApp == APP_SETTINGS) {
-        // Determine if Auto-connect button pressed (bottom-right)
-        int bx = DISP_W - 96;
-        int by = DISP_H - 22;
-        int bw = 88;
-        int bh = 16;
-        if (newCursorX >= bx && newCursorX < bx + bw && newCursorY >= by && newCursorY < by + bh) {
-          // Auto-connect pressed
-          playNavigate();
-          autoConnectToBest();
-        } else {
-          // Default: rescan networks
-          scanWiFi();
-        }
-      }
-    } else {
+  // Button events, queued at sampler rate by inputPoll()
+  InputEvent ev;
+  while (inputPop(ev)) {
+    if (ev.type == EV_CLICK) handleClick(ev);
+    else if (ev.type == EV_LONG_PRESS) {
       playClick(); playNavigate();
       currentApp = APP_HOME; needsFullRedraw = true;
     }
   }
-  lastBtnPressed = btnPressed;
-
-  // Web server
-  server.handleClient();
-  if (MDNS.isRunning()) MDNS.update();
-
-  // Periodic updates
-  static uint32_t lastWeatherCheck = 0;
-  if (millis() - lastWeatherCheck > 60000) { 
-    fetchWeather(); lastWeatherCheck = millis(); 
-  }
-  if (!ntpSynced) syncNTP();
-  if (ntpSynced) currentTime = time(nullptr);
+  profRecord(PROF_INPUT, ESP.getCycleCount() - inputStart);
 
   // Check message timeout
   if (messageActive && millis() - messageTime > 4000) {
     messageActive = false;
-    needsFullRedraw = true;
+    markDirty(WEB_MSG_X, WEB_MSG_Y, WEB_MSG_W, WEB_MSG_H);
   }
 
   // App change
@@ -1764,42 +3863,111 @@ void loop() {
     needsFullRedraw = true; lastApp = currentApp; 
   }
 
-  // Redraw logic
-  if (needsFullRedraw) {
-    redrawScreen();
-  } else {
-    // Fast updates for dynamic content
-    if (currentApp == APP_HOME) updateHomeClockHands();
-    else if (currentApp == APP_COMPASS) updateCompass();
-    else if (currentApp == APP_ACCEL) updateAccel();
-    else if (currentApp == APP_CLOCK) drawClock();
-    else if (currentApp == APP_PONG && pongGameActive) updatePong();
-    else if (currentApp == APP_SPACESHOOTER && shooterGameActive) updateSpaceShooter();
-  }
-
-  // Web message overlay (always on top)
-  if (messageActive) {
-    drawWebMessage();
-  }
-
-  // Cursor - only redraw if moved8mhz
-  if (newCursorX != cursorX || newCursorY != cursorY) {
-    // Erase old cursor position
-    if (lastCursorX >= 0) {
-      int x = lastCursorX, y = lastCursorY;
-      tft.drawLine(x - CURSOR_SIZE, y, x + CURSOR_SIZE, y, C_BG);
-      tft.drawLine(x, y - CURSOR_SIZE, x, y + CURSOR_SIZE, C_BG);
+  {
+    ProfScope p(PROF_RENDER);
+    // Redraw logic
+    if (needsFullRedraw) {
+      redrawScreen();
+    } else {
+      updateApp();
+      flushDamage();
+    }
+
+    // Web message overlay (always on top)
+    if (messageActive) {
+      drawWebMessage();
+    }
+
+    // Cursor - only redraw if moved8mhz
+    if (newCursorX != cursorX || newCursorY != cursorY) {
+      // Erase old cursor position
+      if (lastCursorX >= 0) {
+        int x = lastCursorX, y = lastCursorY;
+        gfx.drawLine(x - CURSOR_SIZE, y, x + CURSOR_SIZE, y, C_BG);
+        gfx.drawLine(x, y - CURSOR_SIZE, x, y + CURSOR_SIZE, C_BG);
+      }
+      cursorX = newCursorX; cursorY = newCursorY;
+      drawCursor(cursorX, cursorY);
+      lastCursorX = cursorX; lastCursorY = cursorY;
     }
-    cursorX = newCursorX; cursorY = newCursorY;
-    drawCursor(cursorX, cursorY);
-    lastCursorX = cursorX; lastCursorY = cursorY;
   }
 
-  updateSpeaker();
   frameCount++;
-  
-  // FPS limiting
-  uint32_t frameTime = millis() - loopStart;
-  uint32_t targetFrame = 1000 / target_fps;
-  if (frameTime < targetFrame) delay(targetFrame - frameTime);
+}
+
+// ---------------- SCHEDULER ----------------
+// Deadline scheduler: each pass runs the most overdue task whose deadline has
+// passed. A task that falls a whole period behind skips ahead and counts the
+// dropped deadlines instead of bursting to catch up. Period 0 = run every pass.
+struct Task {
+  const char *name;
+  void (*fn)();
+  uint32_t periodUs;
+  uint32_t budgetUs;
+  uint32_t nextDueUs;
+  uint32_t runs;
+  uint32_t missed;       // deadlines skipped because the task was a period late
+  uint32_t overBudget;   // runs that took longer than budgetUs
+  uint32_t maxJitterUs;  // worst start lateness
+  uint32_t maxRunUs;
+};
+
+enum { TASK_SENSOR, TASK_JOY, TASK_UI, TASK_NET, TASK_PUSH, TASK_AUDIO, TASK_COUNT };
+
+Task tasks[TASK_COUNT] = {
+  { "sensor", taskSensor, 1000000UL / MPU_SAMPLE_RATE_HZ, 1500, 0 },
+  { "joy",    taskJoystick, 1000000UL / JOY_SAMPLE_HZ,    300,  0 },
+  { "ui",     taskUI,     1000000UL / 30,                 20000, 0 },
+  { "net",    taskNetwork, 50000,                         10000, 0 },
+  { "push",   taskPush,   1000000UL / SSE_MAX_HZ,         2000,  0 },
+  { "audio",  taskAudio,   0,                             200,   0 },
+};
+
+void runTask(Task &t, uint32_t now) {
+  uint32_t start = micros();
+  t.fn();
+  uint32_t ran = micros() - start;
+  t.runs++;
+  if (ran > t.maxRunUs) t.maxRunUs = ran;
+  if (ran > t.budgetUs) t.overBudget++;
+  if (!t.periodUs) return;
+
+  uint32_t late = now - t.nextDueUs;
+  if (late > t.maxJitterUs) t.maxJitterUs = late;
+  if (late >= t.periodUs) {
+    uint32_t skipped = late / t.periodUs;
+    t.missed += skipped;
+    t.nextDueUs += skipped * t.periodUs;
+  }
+  t.nextDueUs += t.periodUs;
+}
+
+void schedulerBegin() {
+  uint32_t now = micros();
+  for (int i = 0; i < TASK_COUNT; i++) tasks[i].nextDueUs = now;
+}
+
+void runScheduler() {
+  tasks[TASK_UI].periodUs = 1000000UL / (target_fps ? target_fps : 1);
+
+  uint32_t now = micros();
+  int pick = -1;
+  int32_t worst = -1;
+  for (int i = 0; i < TASK_COUNT; i++) {
+    if (!tasks[i].periodUs) continue;
+    int32_t late = (int32_t)(now - tasks[i].nextDueUs);
+    if (late > worst) { worst = late; pick = i; }
+  }
+  if (pick >= 0) runTask(tasks[pick], now);
+
+  // Background work fills the idle time between deadlines
+  for (int i = 0; i < TASK_COUNT; i++) {
+    if (!tasks[i].periodUs) runTask(tasks[i], now);
+  }
+  if (pick < 0) yield();
+}
+
+// ---------------- MAIN LOOP ----------------
+void loop() {
+  runScheduler();
 }
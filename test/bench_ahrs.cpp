@@ -0,0 +1,51 @@
+// Cost per fuseSample() and attitude drift over 10 minutes held still, for
+// the filter IMU_FILTER selects (the Makefile builds this once per filter).
+// The stationary trace has residual gyro bias after calibration plus sensor
+// noise. The host has an FPU; the ESP8266 does not, so the Mahony cost is a
+// lower bound for the device.
+//   make -C test bench
+#include "../main.cpp"
+#include <chrono>
+#include <random>
+#include <vector>
+
+struct Raw { int16_t ax, ay, az, gx, gy, gz; };
+
+static const uint32_t DT_US = 1000000UL / MPU_SAMPLE_RATE_HZ;
+static const int TRACE_S = 600;
+static volatile int32_t sink;
+
+int main() {
+  // Flat and still: 1 g on z, gyro bias of a few LSB (~0.02-0.03 deg/s)
+  std::mt19937 rng(7);
+  std::normal_distribution<float> accelNoise(0, 40), gyroNoise(0, 4);
+  std::vector<Raw> trace(TRACE_S * MPU_SAMPLE_RATE_HZ);
+  for (Raw &r : trace) {
+    r.ax = (int16_t)lroundf(accelNoise(rng));
+    r.ay = (int16_t)lroundf(accelNoise(rng));
+    r.az = (int16_t)lroundf(16384 + accelNoise(rng));
+    r.gx = (int16_t)lroundf(3 + gyroNoise(rng));
+    r.gy = (int16_t)lroundf(-2 + gyroNoise(rng));
+    r.gz = (int16_t)lroundf(4 + gyroNoise(rng));
+  }
+
+  double worstTilt = 0;
+  for (const Raw &r : trace) {
+    fuseSample(r.ax, r.ay, r.az, r.gx, r.gy, r.gz, DT_US);
+    worstTilt = fmax(worstTilt, fmax(fabs(pitch_q / 65536.0), fabs(roll_q / 65536.0)));
+  }
+  fusionPublish();
+  double p = pitch, r = roll, y = yaw;
+
+  const int passes = 20;
+  auto t0 = std::chrono::steady_clock::now();
+  for (int i = 0; i < passes; i++)
+    for (const Raw &s : trace) { fuseSample(s.ax, s.ay, s.az, s.gx, s.gy, s.gz, DT_US); sink = pitch_fq; }
+  auto t1 = std::chrono::steady_clock::now();
+  double us = std::chrono::duration<double, std::micro>(t1 - t0).count() / (passes * trace.size());
+
+  printf("%-14s %6.3f us/update   after %d s still: pitch %+6.2f roll %+6.2f yaw %+7.2f deg"
+         " (worst tilt %.2f)\n", IMU_FILTER == IMU_FILTER_MAHONY ? "mahony" : "complementary",
+         us, TRACE_S, p, r, y, worstTilt);
+  return 0;
+}
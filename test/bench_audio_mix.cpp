@@ -0,0 +1,51 @@
+// Mixer cost per output sample by voice count and waveform
+//   make -C test bench
+#include "../main.cpp"
+#include <chrono>
+
+// Mixes `samples` samples with the ISR side drained between passes, so
+// every updateSpeaker() call does a full AUDIO_MIX_CHUNK
+static double nsPerSample(int active, uint8_t wave, long samples) {
+  stopSpeaker();
+  speaker_volume = 100;
+  for (int i = 0; i < AUDIO_VOICES; i++) {
+    Voice &v = voices[i];
+    v = Voice();
+    v.lfsr = 0xACE1;
+    v.active = i < active;
+    v.wave = wave;
+    v.vol = 63;
+    v.inc = audioIncForHz(220 + 110 * i);
+    v.samplesLeft = UINT32_MAX;
+  }
+  speakerRunning = true;
+  long mixed = 0;
+  auto t0 = std::chrono::steady_clock::now();
+  while (mixed < samples) {
+    uint16_t h = audioHead;
+    updateSpeaker();
+    mixed += (audioHead - h) & AUDIO_RING_MASK;
+    audioTail = audioHead;
+  }
+  auto t1 = std::chrono::steady_clock::now();
+  stopSpeaker();
+  return std::chrono::duration<double, std::nano>(t1 - t0).count() / mixed;
+}
+
+int main() {
+  static const char *const waveNames[] = { "square", "triangle", "noise", "table" };
+  const long N = 4000000;
+  printf("%-10s %8s %8s %8s %8s   ns/sample\n", "wave", "1 voice", "2", "3", "4");
+  double worst = 0;
+  for (uint8_t w = WAVE_SQUARE; w <= WAVE_TABLE; w++) {
+    printf("%-10s", waveNames[w]);
+    for (int n = 1; n <= AUDIO_VOICES; n++) {
+      double ns = nsPerSample(n, w, N);
+      worst = fmax(worst, ns);
+      printf(" %8.2f", ns);
+    }
+    printf("\n");
+  }
+  printf("worst pass: %d samples, %.1f us on this host\n", AUDIO_MIX_CHUNK, worst * AUDIO_MIX_CHUNK / 1000);
+  return 0;
+}
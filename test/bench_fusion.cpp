@@ -0,0 +1,51 @@
+// Q16.16 complementary filter against the float filter it replaced, over
+// the recorded replay fixture. The host has an FPU; the ESP8266 does not,
+// so the float columns are a lower bound for the device.
+//   make -C test bench
+#include "../main.cpp"
+#include "imu_replay.h"
+#include <chrono>
+
+static volatile int32_t sinkI;
+static volatile float sinkF;
+
+template <typename F> static double nsPerCall(long n, F fn) {
+  auto t0 = std::chrono::steady_clock::now();
+  for (long i = 0; i < n; i++) fn(i);
+  auto t1 = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::nano>(t1 - t0).count() / n;
+}
+
+int main() {
+  std::vector<ImuSample> rec = loadReplay();
+  if (rec.empty()) { printf("bench_fusion: fixtures/imu_replay.csv not found\n"); return 1; }
+  const long N = 20000000;
+  const size_t n = rec.size();
+  replayCalibrate();
+
+  double q = nsPerCall(N, [&](long i) {
+    const ImuSample &s = rec[i % n];
+    sinkI = atan2Q16(s.ay * 256 - ay_off_q8, s.az * 256 - az_off_q8);
+  });
+  double f = nsPerCall(N, [&](long i) {
+    const ImuSample &s = rec[i % n];
+    sinkF = atan2((s.ay - ay_offset) / 16384.0f, (s.az - az_offset) / 16384.0f) * 180.0f / PI;
+  });
+  printf("%-22s %7.2f ns   %-22s %7.2f ns   %5.1fx\n", "atan2Q16", q, "atan2 (float)", f, f / q);
+
+  q = nsPerCall(N, [&](long i) {
+    const ImuSample &s = rec[i % n];
+    fuseSample(s.ax, s.ay, s.az, s.gx, s.gy, s.gz, REPLAY_DT_US);
+    sinkI = pitch_fq;
+  });
+  FloatFusion ref;
+  f = nsPerCall(N, [&](long i) {
+    const ImuSample &s = rec[i % n];
+    ref.step(s.ax, s.ay, s.az, s.gx, s.gy, s.gz, REPLAY_DT_US * 1e-6f);
+    sinkF = ref.pitch_filtered;
+  });
+  printf("%-22s %7.2f ns   %-22s %7.2f ns   %5.1fx\n", "fuseSample (Q16)", q, "float filter", f, f / q);
+  printf("saved at %d Hz: %.1f us of CPU per second on this host\n",
+         MPU_SAMPLE_RATE_HZ, (f - q) * MPU_SAMPLE_RATE_HZ / 1000.0);
+  return 0;
+}
@@ -0,0 +1,71 @@
+// SPI traffic for a repaint drawn straight to the panel (one address window
+// per primitive) against the banded path (one window per RAM band), counted
+// by the fake ST7735, plus host time for each
+//   make -C test bench
+#include "../main.cpp"
+#include <chrono>
+
+static const AppState APPS[] = { APP_HOME, APP_LAUNCHER, APP_CALCULATOR, APP_COMPASS, APP_ACCEL, APP_CLOCK,
+                                 APP_GAMES, APP_TICTACTOE, APP_PONG, APP_SPACESHOOTER, APP_SETTINGS };
+static const char *const APP_NAMES[] = { "home", "launcher", "calculator", "compass", "accel", "clock",
+                                         "games", "tictactoe", "pong", "spaceshooter", "settings" };
+
+struct Traffic { uint32_t cmds, bytes; double us; };
+
+template <typename F> static Traffic measure(F draw) {
+  uint32_t c = tft.spiCommands, b = tft.spiBytes;
+  auto t0 = std::chrono::steady_clock::now();
+  draw();
+  auto t1 = std::chrono::steady_clock::now();
+  return { tft.spiCommands - c, tft.spiBytes - b, std::chrono::duration<double, std::micro>(t1 - t0).count() };
+}
+
+// What the sketch did before banding: every primitive clipped to the
+// damaged rect and sent to the panel on its own
+static void drawDirect(const DirtyRect &r) {
+  gfx.setClip(r);
+  gfx.fillRect(r.x, r.y, r.w, r.h, C_BG);
+  drawApp();
+  drawStatusBar();
+  gfx.resetClip();
+}
+
+static void drawBanded(const DirtyRect &r) {
+  dirtyCount = 0;
+  markDirty(r.x, r.y, r.w, r.h);
+  flushDamage();
+}
+
+static void row(const char *name, const Traffic &d, const Traffic &b) {
+  printf("%-14s %7u %8u %8.0f | %7u %8u %8.0f | %5.1fx cmds %4.2fx bytes\n", name,
+         (unsigned)d.cmds, (unsigned)d.bytes, d.us, (unsigned)b.cmds, (unsigned)b.bytes, b.us,
+         (double)d.cmds / b.cmds, (double)d.bytes / b.bytes);
+}
+
+int main() {
+  tft.setRotation(1);
+  pongGameActive = shooterGameActive = true;
+  tttBoard[0] = 1; tttBoard[4] = 2; tttBoard[8] = 1;
+  const DirtyRect full = { 0, 0, DISP_W, DISP_H };
+  const int16_t side = compassDial.r * 2 + 1;
+  const DirtyRect dial = { (int16_t)(compassDial.cx - compassDial.r), (int16_t)(compassDial.cy - compassDial.r), side, side };
+  printf("%-14s %7s %8s %8s | %7s %8s %8s\n", "full screen", "cmds", "bytes", "host us", "cmds", "bytes", "host us");
+  printf("%-14s %25s | %25s\n", "", "direct", "banded");
+  Traffic td = {}, tb = {};
+  for (AppState app : APPS) {
+    currentApp = app;
+    Traffic d = measure([&] { drawDirect(full); });
+    Traffic b = measure([&] { drawBanded(full); });
+    row(APP_NAMES[app], d, b);
+    td.cmds += d.cmds; td.bytes += d.bytes; td.us += d.us;
+    tb.cmds += b.cmds; tb.bytes += b.bytes; tb.us += b.us;
+  }
+  row("all apps", td, tb);
+  printf("\npartial\n");
+  currentApp = APP_COMPASS;
+  row("compass dial", measure([&] { drawDirect(dial); }), measure([&] { drawBanded(dial); }));
+  currentApp = APP_LAUNCHER;
+  const DirtyRect icon = { 8, STATUS_BAR_H + 10, 70, 22 };
+  row("launcher icon", measure([&] { drawDirect(icon); }), measure([&] { drawBanded(icon); }));
+  return 0;
+}
@@ -0,0 +1,34 @@
+// Q15 sine table against libm sinf/cosf, and dialPoint against its float
+// equivalent. The host has an FPU; the ESP8266 does not, so the float
+// columns are a lower bound for the device.
+//   make -C test bench
+#include "../main.cpp"
+#include <chrono>
+
+static volatile int32_t sinkI;
+static volatile float sinkF;
+
+template <typename F> static double nsPerCall(long n, F fn) {
+  auto t0 = std::chrono::steady_clock::now();
+  for (long i = 0; i < n; i++) fn(i);
+  auto t1 = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::nano>(t1 - t0).count() / n;
+}
+
+int main() {
+  const long N = 20000000;
+  const float DEG = (float)M_PI / 180.0f;
+  double q = nsPerCall(N, [](long i) { sinkI = sinQ15((int)(i % 720) - 360); });
+  double f = nsPerCall(N, [&](long i) { sinkF = sinf(((int)(i % 720) - 360) * DEG); });
+  printf("%-22s %7.2f ns   %-22s %7.2f ns   %5.1fx\n", "sinQ15", q, "sinf", f, f / q);
+  q = nsPerCall(N, [](long i) { sinkI = cosQ15((int)(i % 720) - 360); });
+  f = nsPerCall(N, [&](long i) { sinkF = cosf(((int)(i % 720) - 360) * DEG); });
+  printf("%-22s %7.2f ns   %-22s %7.2f ns   %5.1fx\n", "cosQ15", q, "cosf", f, f / q);
+  q = nsPerCall(N, [](long i) { int x, y; dialPoint(80, 64, 28, (int)(i % 360), x, y); sinkI = x + y; });
+  f = nsPerCall(N, [&](long i) {
+    float a = (int)(i % 360) * DEG;
+    sinkI = (int)lroundf(80 + 28 * sinf(a)) + (int)lroundf(64 - 28 * cosf(a));
+  });
+  printf("%-22s %7.2f ns   %-22s %7.2f ns   %5.1fx\n", "dialPoint", q, "float sinf/cosf point", f, f / q);
+  return 0;
+}
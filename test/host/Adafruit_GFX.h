@@ -0,0 +1,219 @@
+// Host Adafruit_GFX: same primitive call graph as the library (everything
+// funnels into writePixel / writeFastVLine / writeFastHLine / writeFillRect),
+// so a subclass that overrides those sees what it would on the device.
+// Text uses a made-up but deterministic 5x7 glyph set.
+#pragma once
+#include <Arduino.h>
+
+class Adafruit_GFX : public Print {
+public:
+  Adafruit_GFX(int16_t w, int16_t h) : WIDTH(w), HEIGHT(h), _width(w), _height(h) {}
+  virtual ~Adafruit_GFX() {}
+
+  virtual void drawPixel(int16_t x, int16_t y, uint16_t color) = 0;
+  virtual void startWrite(void) {}
+  virtual void writePixel(int16_t x, int16_t y, uint16_t color) { drawPixel(x, y, color); }
+  virtual void writeFillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) { fillRect(x, y, w, h, color); }
+  virtual void writeFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) { drawFastVLine(x, y, h, color); }
+  virtual void writeFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) { drawFastHLine(x, y, w, color); }
+  virtual void writeLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color) {
+    bool steep = abs(y1 - y0) > abs(x1 - x0);
+    if (steep) { std::swap(x0, y0); std::swap(x1, y1); }
+    if (x0 > x1) { std::swap(x0, x1); std::swap(y0, y1); }
+    int16_t dx = x1 - x0, dy = abs(y1 - y0), err = dx / 2, ystep = (y0 < y1) ? 1 : -1;
+    for (; x0 <= x1; x0++) {
+      if (steep) writePixel(y0, x0, color); else writePixel(x0, y0, color);
+      err -= dy;
+      if (err < 0) { y0 += ystep; err += dx; }
+    }
+  }
+  virtual void endWrite(void) {}
+  virtual void setRotation(uint8_t r) {
+    rotation = r & 3;
+    _width = (rotation & 1) ? HEIGHT : WIDTH;
+    _height = (rotation & 1) ? WIDTH : HEIGHT;
+  }
+  virtual void invertDisplay(bool) {}
+  virtual void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) {
+    startWrite(); writeLine(x, y, x, y + h - 1, color); endWrite();
+  }
+  virtual void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) {
+    startWrite(); writeLine(x, y, x + w - 1, y, color); endWrite();
+  }
+  virtual void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+    startWrite();
+    for (int16_t i = x; i < x + w; i++) writeFastVLine(i, y, h, color);
+    endWrite();
+  }
+  virtual void fillScreen(uint16_t color) { fillRect(0, 0, _width, _height, color); }
+  virtual void drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color) {
+    if (x0 == x1) { if (y0 > y1) std::swap(y0, y1); drawFastVLine(x0, y0, y1 - y0 + 1, color); }
+    else if (y0 == y1) { if (x0 > x1) std::swap(x0, x1); drawFastHLine(x0, y0, x1 - x0 + 1, color); }
+    else { startWrite(); writeLine(x0, y0, x1, y1, color); endWrite(); }
+  }
+  virtual void drawRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+    startWrite();
+    writeFastHLine(x, y, w, color); writeFastHLine(x, y + h - 1, w, color);
+    writeFastVLine(x, y, h, color); writeFastVLine(x + w - 1, y, h, color);
+    endWrite();
+  }
+  void drawCircle(int16_t x0, int16_t y0, int16_t r, uint16_t color) {
+    int16_t f = 1 - r, ddF_x = 1, ddF_y = -2 * r, x = 0, y = r;
+    startWrite();
+    writePixel(x0, y0 + r, color); writePixel(x0, y0 - r, color);
+    writePixel(x0 + r, y0, color); writePixel(x0 - r, y0, color);
+    while (x < y) {
+      if (f >= 0) { y--; ddF_y += 2; f += ddF_y; }
+      x++; ddF_x += 2; f += ddF_x;
+      writePixel(x0 + x, y0 + y, color); writePixel(x0 - x, y0 + y, color);
+      writePixel(x0 + x, y0 - y, color); writePixel(x0 - x, y0 - y, color);
+      writePixel(x0 + y, y0 + x, color); writePixel(x0 - y, y0 + x, color);
+      writePixel(x0 + y, y0 - x, color); writePixel(x0 - y, y0 - x, color);
+    }
+    endWrite();
+  }
+  void fillCircle(int16_t x0, int16_t y0, int16_t r, uint16_t color) {
+    startWrite();
+    writeFastVLine(x0, y0 - r, 2 * r + 1, color);
+    fillCircleHelper(x0, y0, r, 3, 0, color);
+    endWrite();
+  }
+  void drawTriangle(int16_t x0, int16_t y0, int16_t x1, int16_t y1, int16_t x2, int16_t y2, uint16_t color) {
+    drawLine(x0, y0, x1, y1, color); drawLine(x1, y1, x2, y2, color); drawLine(x2, y2, x0, y0, color);
+  }
+  void fillTriangle(int16_t x0, int16_t y0, int16_t x1, int16_t y1, int16_t x2, int16_t y2, uint16_t color) {
+    int16_t a, b, y, last;
+    if (y0 > y1) { std::swap(y0, y1); std::swap(x0, x1); }
+    if (y1 > y2) { std::swap(y2, y1); std::swap(x2, x1); }
+    if (y0 > y1) { std::swap(y0, y1); std::swap(x0, x1); }
+    startWrite();
+    if (y0 == y2) {
+      a = b = x0;
+      if (x1 < a) a = x1; else if (x1 > b) b = x1;
+      if (x2 < a) a = x2; else if (x2 > b) b = x2;
+      writeFastHLine(a, y0, b - a + 1, color);
+      endWrite();
+      return;
+    }
+    int16_t dx01 = x1 - x0, dy01 = y1 - y0, dx02 = x2 - x0, dy02 = y2 - y0, dx12 = x2 - x1, dy12 = y2 - y1;
+    int32_t sa = 0, sb = 0;
+    last = (y1 == y2) ? y1 : y1 - 1;
+    for (y = y0; y <= last; y++) {
+      a = x0 + sa / dy01; b = x0 + sb / dy02;
+      sa += dx01; sb += dx02;
+      if (a > b) std::swap(a, b);
+      writeFastHLine(a, y, b - a + 1, color);
+    }
+    sa = (int32_t)dx12 * (y - y1);
+    sb = (int32_t)dx02 * (y - y0);
+    for (; y <= y2; y++) {
+      a = x1 + sa / dy12; b = x0 + sb / dy02;
+      sa += dx12; sb += dx02;
+      if (a > b) std::swap(a, b);
+      writeFastHLine(a, y, b - a + 1, color);
+    }
+    endWrite();
+  }
+  void drawRoundRect(int16_t x, int16_t y, int16_t w, int16_t h, int16_t r, uint16_t color) {
+    int16_t max_radius = ((w < h) ? w : h) / 2;
+    if (r > max_radius) r = max_radius;
+    startWrite();
+    writeFastHLine(x + r, y, w - 2 * r, color); writeFastHLine(x + r, y + h - 1, w - 2 * r, color);
+    writeFastVLine(x, y + r, h - 2 * r, color); writeFastVLine(x + w - 1, y + r, h - 2 * r, color);
+    drawCircleHelper(x + r, y + r, r, 1, color); drawCircleHelper(x + w - r - 1, y + r, r, 2, color);
+    drawCircleHelper(x + w - r - 1, y + h - r - 1, r, 4, color); drawCircleHelper(x + r, y + h - r - 1, r, 8, color);
+    endWrite();
+  }
+  void fillRoundRect(int16_t x, int16_t y, int16_t w, int16_t h, int16_t r, uint16_t color) {
+    int16_t max_radius = ((w < h) ? w : h) / 2;
+    if (r > max_radius) r = max_radius;
+    startWrite();
+    writeFillRect(x + r, y, w - 2 * r, h, color);
+    fillCircleHelper(x + w - r - 1, y + r, r, 1, h - 2 * r - 1, color);
+    fillCircleHelper(x + r, y + r, r, 2, h - 2 * r - 1, color);
+    endWrite();
+  }
+
+  void setCursor(int16_t x, int16_t y) { cursor_x = x; cursor_y = y; }
+  void setTextColor(uint16_t c) { textcolor = textbgcolor = c; }
+  void setTextColor(uint16_t c, uint16_t bg) { textcolor = c; textbgcolor = bg; }
+  void setTextSize(uint8_t s) { textsize_x = textsize_y = s ? s : 1; }
+  void setTextWrap(bool w) { wrap = w; }
+  int16_t width(void) const { return _width; }
+  int16_t height(void) const { return _height; }
+  int16_t getCursorX(void) const { return cursor_x; }
+  int16_t getCursorY(void) const { return cursor_y; }
+
+  static uint8_t glyphColumn(unsigned char c, uint8_t i) {
+    if (c == ' ') return 0;
+    return (uint8_t)((c * 37u + i * 11u + (c >> 2) * i) & 0x7F) | 1;
+  }
+  void drawChar(int16_t x, int16_t y, unsigned char c, uint16_t color, uint16_t bg, uint8_t sx, uint8_t sy) {
+    if ((x >= _width) || (y >= _height) || ((x + 6 * sx - 1) < 0) || ((y + 8 * sy - 1) < 0)) return;
+    startWrite();
+    for (int8_t i = 0; i < 5; i++) {
+      uint8_t line = glyphColumn(c, i);
+      for (int8_t j = 0; j < 8; j++, line >>= 1) {
+        if (line & 1) {
+          if (sx == 1 && sy == 1) writePixel(x + i, y + j, color);
+          else writeFillRect(x + i * sx, y + j * sy, sx, sy, color);
+        } else if (bg != color) {
+          if (sx == 1 && sy == 1) writePixel(x + i, y + j, bg);
+          else writeFillRect(x + i * sx, y + j * sy, sx, sy, bg);
+        }
+      }
+    }
+    if (bg != color) {
+      if (sx == 1 && sy == 1) writeFastVLine(x + 5, y, 8, bg);
+      else writeFillRect(x + 5 * sx, y, sx, 8 * sy, bg);
+    }
+    endWrite();
+  }
+  size_t write(uint8_t c) override {
+    if (c == '\n') { cursor_x = 0; cursor_y += textsize_y * 8; }
+    else if (c != '\r') {
+      if (wrap && ((cursor_x + textsize_x * 6) > _width)) { cursor_x = 0; cursor_y += textsize_y * 8; }
+      drawChar(cursor_x, cursor_y, c, textcolor, textbgcolor, textsize_x, textsize_y);
+      cursor_x += textsize_x * 6;
+    }
+    return 1;
+  }
+  using Print::write;
+
+protected:
+  void drawCircleHelper(int16_t x0, int16_t y0, int16_t r, uint8_t corner, uint16_t color) {
+    int16_t f = 1 - r, ddF_x = 1, ddF_y = -2 * r, x = 0, y = r;
+    while (x < y) {
+      if (f >= 0) { y--; ddF_y += 2; f += ddF_y; }
+      x++; ddF_x += 2; f += ddF_x;
+      if (corner & 0x4) { writePixel(x0 + x, y0 + y, color); writePixel(x0 + y, y0 + x, color); }
+      if (corner & 0x2) { writePixel(x0 + x, y0 - y, color); writePixel(x0 + y, y0 - x, color); }
+      if (corner & 0x8) { writePixel(x0 - y, y0 + x, color); writePixel(x0 - x, y0 + y, color); }
+      if (corner & 0x1) { writePixel(x0 - y, y0 - x, color); writePixel(x0 - x, y0 - y, color); }
+    }
+  }
+  void fillCircleHelper(int16_t x0, int16_t y0, int16_t r, uint8_t corners, int16_t delta, uint16_t color) {
+    int16_t f = 1 - r, ddF_x = 1, ddF_y = -2 * r, x = 0, y = r, px = x, py = y;
+    delta++;
+    while (x < y) {
+      if (f >= 0) { y--; ddF_y += 2; f += ddF_y; }
+      x++; ddF_x += 2; f += ddF_x;
+      if (x < (y + 1)) {
+        if (corners & 1) writeFastVLine(x0 + x, y0 - y, 2 * y + delta, color);
+        if (corners & 2) writeFastVLine(x0 - x, y0 - y, 2 * y + delta, color);
+      }
+      if (y != py) {
+        if (corners & 1) writeFastVLine(x0 + py, y0 - px, 2 * px + delta, color);
+        if (corners & 2) writeFastVLine(x0 - py, y0 - px, 2 * px + delta, color);
+        py = y;
+      }
+      px = x;
+    }
+  }
+
+  int16_t WIDTH, HEIGHT, _width, _height, cursor_x = 0, cursor_y = 0;
+  uint16_t textcolor = 0xFFFF, textbgcolor = 0xFFFF;
+  uint8_t textsize_x = 1, textsize_y = 1, rotation = 0;
+  bool wrap = true;
+  const void *gfxFont = nullptr;   // custom fonts are not used on the host
+};
@@ -0,0 +1,68 @@
+// Host ST7735: a RAM framebuffer plus counters for what reached the "panel".
+// spiCommands/spiBytes follow Adafruit_SPITFT's wire traffic: an address
+// window is CASET + RASET + RAMWR (3 commands, 8 argument bytes), and every
+// pixel is 2 bytes; drawPixel/writePixel open their own 1x1 window, fills
+// open one window for the whole rect.
+#pragma once
+#include <Adafruit_GFX.h>
+#include <algorithm>
+#include <vector>
+#define INITR_BLACKTAB 0x02
+
+class Adafruit_SPITFT : public Adafruit_GFX {
+public:
+  Adafruit_SPITFT(int16_t w, int16_t h) : Adafruit_GFX(w, h), fb(w * h, 0) {}
+  std::vector<uint16_t> fb;   // row-major in the rotated orientation
+  uint32_t pixelWrites = 0;
+  uint32_t spiCommands = 0, spiBytes = 0;
+
+  uint16_t at(int x, int y) const { return fb[y * _width + x]; }
+  void drawPixel(int16_t x, int16_t y, uint16_t c) override {
+    if (x < 0 || y < 0 || x >= _width || y >= _height) return;
+    setAddrWindow(x, y, 1, 1);
+    streamPixel(c);
+  }
+  void writePixel(int16_t x, int16_t y, uint16_t c) override { drawPixel(x, y, c); }
+  void writeFillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t c) override {
+    if (w < 0) { x += w + 1; w = -w; }
+    if (h < 0) { y += h + 1; h = -h; }
+    int16_t x2 = std::min<int16_t>(x + w, _width), y2 = std::min<int16_t>(y + h, _height);
+    x = std::max<int16_t>(x, 0); y = std::max<int16_t>(y, 0);
+    if (x2 <= x || y2 <= y) return;
+    setAddrWindow(x, y, x2 - x, y2 - y);
+    writeColor(c, (uint32_t)(x2 - x) * (y2 - y));
+  }
+  void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t c) override { writeFillRect(x, y, w, h, c); }
+  void writeFastHLine(int16_t x, int16_t y, int16_t w, uint16_t c) override { writeFillRect(x, y, w, 1, c); }
+  void writeFastVLine(int16_t x, int16_t y, int16_t h, uint16_t c) override { writeFillRect(x, y, 1, h, c); }
+  void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t c) override { writeFillRect(x, y, w, 1, c); }
+  void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t c) override { writeFillRect(x, y, 1, h, c); }
+  void setAddrWindow(uint16_t x, uint16_t y, uint16_t w, uint16_t h) {
+    wx = x; wy = y; ww = w; wh = h; wpos = 0;
+    spiCommands += 3; spiBytes += 3 + 8;
+  }
+  void writePixels(uint16_t *colors, uint32_t len, bool = true, bool = false) { while (len--) streamPixel(*colors++); }
+  void writeColor(uint16_t color, uint32_t len) { while (len--) streamPixel(color); }
+  void pushColor(uint16_t c) { streamPixel(c); }
+  void startWrite(void) override {}
+  void endWrite(void) override {}
+
+private:
+  uint16_t wx = 0, wy = 0, ww = 0, wh = 0;
+  uint32_t wpos = 0;
+  void streamPixel(uint16_t c) {
+    spiBytes += 2;
+    if (!ww || !wh) return;
+    int x = wx + wpos % ww, y = wy + (wpos / ww) % wh;
+    wpos++;
+    if (x < 0 || y < 0 || x >= _width || y >= _height) return;
+    fb[y * _width + x] = c; pixelWrites++;
+  }
+};
+
+class Adafruit_ST7735 : public Adafruit_SPITFT {
+public:
+  Adafruit_ST7735(int8_t, int8_t, int8_t) : Adafruit_SPITFT(128, 160) {}
+  void initR(uint8_t) {}
+  void setRotation(uint8_t m) override { Adafruit_GFX::setRotation(m); }
+};
@@ -0,0 +1,254 @@
+// Host stand-in for the ESP8266 Arduino core, enough to build main.cpp into
+// the host tests. Time, pins and interrupts are fakes the tests drive.
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <math.h>
+#include <algorithm>
+#include <functional>
+#include <string>
+
+typedef bool boolean;
+typedef uint8_t byte;
+#define PI 3.1415926535897932384626433832795
+#define HIGH 1
+#define LOW 0
+#define INPUT 0
+#define OUTPUT 1
+#define INPUT_PULLUP 2
+#define CHANGE 3
+#define FALLING 2
+#define RISING 1
+#define D0 16
+#define D1 5
+#define D2 4
+#define D3 0
+#define D4 2
+#define D5 14
+#define D6 12
+#define D7 13
+#define D8 15
+#define A0 17
+#define F_CPU 80000000L
+#define IRAM_ATTR
+#define ICACHE_RAM_ATTR
+#define PROGMEM
+#define PGM_P const char*
+#define PSTR(s) (s)
+#define pgm_read_byte(p) (*(const uint8_t*)(p))
+#define pgm_read_word(p) (*(const uint16_t*)(p))
+#define pgm_read_dword(p) (*(const uint32_t*)(p))
+#define memcpy_P memcpy
+#define strlen_P strlen
+#define constrain(amt,low,high) ((amt)<(low)?(low):((amt)>(high)?(high):(amt)))
+using std::min; using std::max;
+
+// ---- fake clock: tests move hostNowUs forward ----
+inline uint64_t hostNowUs = 0;
+inline void hostAdvanceUs(uint64_t us) { hostNowUs += us; }
+inline void hostAdvanceMs(uint64_t ms) { hostNowUs += ms * 1000; }
+inline unsigned long micros() { return (uint32_t)hostNowUs; }
+inline unsigned long millis() { return (uint32_t)(hostNowUs / 1000); }
+inline void delay(unsigned long ms) { hostNowUs += (uint64_t)ms * 1000; }
+inline void delayMicroseconds(unsigned int us) { hostNowUs += us; }
+inline void yield() {}
+
+// ---- pins: outputs land in hostPin, inputs are read from it ----
+inline int hostPin[32];
+inline std::function<int(uint8_t)> hostAnalogRead;   // default: mid-scale
+inline void (*hostIsr[32])(void);
+inline void pinMode(uint8_t, uint8_t) {}
+inline void digitalWrite(uint8_t p, uint8_t v) { hostPin[p & 31] = v; }
+inline int digitalRead(uint8_t p) { return hostPin[p & 31]; }
+inline int analogRead(uint8_t p) { return hostAnalogRead ? hostAnalogRead(p) : 512; }
+inline int digitalPinToInterrupt(int p) { return p; }
+inline void attachInterrupt(uint8_t p, void (*fn)(void), int) { hostIsr[p & 31] = fn; }
+inline void detachInterrupt(uint8_t p) { hostIsr[p & 31] = nullptr; }
+inline void noInterrupts() {}
+inline void interrupts() {}
+inline uint32_t xt_rsil(uint32_t) { return 0; }
+inline void xt_wsr_ps(uint32_t) {}
+inline volatile uint32_t GPOS, GPOC, GPI, GPSD;
+
+inline long random(long hi) { return hi > 0 ? rand() % hi : 0; }
+inline long random(long lo, long hi) { return hi > lo ? lo + rand() % (hi - lo) : lo; }
+inline void randomSeed(unsigned long s) { srand(s); }
+inline long map(long x, long in_min, long in_max, long out_min, long out_max) {
+  return (x - in_min) * (out_max - out_min) / (in_max - in_min) + out_min;
+}
+inline void configTime(int, int, const char*, const char* = nullptr, const char* = nullptr) {}
+
+// ---- timer1 / sigma-delta: record the configuration only ----
+#define TIM_DIV1 0
+#define TIM_DIV16 1
+#define TIM_DIV256 3
+#define TIM_EDGE 0
+#define TIM_LOOP 1
+#define TIM_SINGLE 0
+typedef void(*timercallback)(void);
+inline timercallback hostTimer1Isr;
+inline bool hostTimer1Enabled;
+inline uint32_t hostTimer1Ticks;
+inline void timer1_isr_init(void) {}
+inline void timer1_enable(uint8_t, uint8_t, uint8_t) { hostTimer1Enabled = true; }
+inline void timer1_disable(void) { hostTimer1Enabled = false; }
+inline void timer1_attachInterrupt(timercallback fn) { hostTimer1Isr = fn; }
+inline void timer1_detachInterrupt(void) { hostTimer1Isr = nullptr; }
+inline void timer1_write(uint32_t t) { hostTimer1Ticks = t; }
+inline int hostSigmaDeltaPin = -1;
+inline uint8_t sigmaDeltaSetup(uint8_t, uint32_t) { return 0; }
+inline void sigmaDeltaAttachPin(uint8_t pin, uint8_t = 0) { hostSigmaDeltaPin = pin; }
+inline void sigmaDeltaDetachPin(uint8_t) { hostSigmaDeltaPin = -1; }
+inline void sigmaDeltaWrite(uint8_t, uint8_t) {}
+
+// ESP8266 core dtostrf (core_esp8266_noniso.cpp): String(float, n) uses it
+inline char *dtostrf(double number, signed char width, unsigned char prec, char *s) {
+  bool negative = false;
+  if (isnan(number)) { strcpy(s, "nan"); return s; }
+  if (isinf(number)) { strcpy(s, "inf"); return s; }
+  char *out = s;
+  int fillme = width;
+  if (prec > 0) fillme -= (prec + 1);
+  if (number < 0.0) { negative = true; fillme--; number = -number; }
+  double rounding = 2.0;
+  for (uint8_t i = 0; i < prec; ++i) rounding *= 10.0;
+  rounding = 1.0 / rounding;
+  number += rounding;
+  double tenpow = 1.0;
+  int digitcount = 1;
+  while (number >= 10.0 * tenpow) { tenpow *= 10.0; digitcount++; }
+  number /= tenpow;
+  fillme -= digitcount;
+  while (fillme-- > 0) *out++ = ' ';
+  if (negative) *out++ = '-';
+  digitcount += prec;
+  int8_t digit = 0;
+  while (digitcount-- > 0) {
+    digit = (int8_t)number;
+    if (digit > 9) digit = 9;
+    *out++ = (char)('0' | digit);
+    if ((digitcount == prec) && (prec > 0)) *out++ = '.';
+    number -= digit;
+    number *= 10.0;
+  }
+  *out = 0;
+  return s;
+}
+
+class __FlashStringHelper;
+#define F(s) (reinterpret_cast<const __FlashStringHelper*>(s))
+#define FPSTR(s) (reinterpret_cast<const __FlashStringHelper*>(s))
+
+class String {
+public:
+  String(const char *s = "") : b(s ? s : "") {}
+  String(const String &o) = default;
+  String(char c) : b(1, c) {}
+  String(int v, unsigned char base = 10) : b(fmtInt(v, base)) {}
+  String(unsigned int v, unsigned char base = 10) : b(fmtInt(v, base)) {}
+  String(long v, unsigned char base = 10) : b(fmtInt(v, base)) {}
+  String(unsigned long v, unsigned char base = 10) : b(fmtInt(v, base)) {}
+  String(float v, unsigned char dec = 2) { char t[40]; b = dtostrf(v, dec + 2, dec, t); }
+  String(double v, unsigned char dec = 2) { char t[40]; b = dtostrf(v, dec + 2, dec, t); }
+  String &operator=(const String &o) = default;
+  String &operator=(const char *s) { b = s ? s : ""; return *this; }
+  String &operator+=(const String &o) { b += o.b; return *this; }
+  String &operator+=(const char *s) { b += s; return *this; }
+  String &operator+=(char c) { b += c; return *this; }
+  friend String operator+(const String &a, const String &o) { String r(a); r += o; return r; }
+  friend String operator+(const String &a, const char *s) { String r(a); r += s; return r; }
+  friend String operator+(const char *s, const String &a) { String r(s); r += a; return r; }
+  bool operator==(const String &o) const { return b == o.b; }
+  bool operator!=(const String &o) const { return b != o.b; }
+  bool equals(const String &o) const { return b == o.b; }
+  unsigned int length() const { return b.size(); }
+  const char *c_str() const { return b.c_str(); }
+  String substring(unsigned int from, unsigned int to) const { return String(b.substr(from, to > from ? to - from : 0).c_str()); }
+  String substring(unsigned int from) const { return String(b.substr(std::min<size_t>(from, b.size())).c_str()); }
+  int indexOf(const char *s, unsigned int from = 0) const { size_t p = b.find(s, from); return p == std::string::npos ? -1 : (int)p; }
+  int indexOf(char c, unsigned int from = 0) const { size_t p = b.find(c, from); return p == std::string::npos ? -1 : (int)p; }
+  float toFloat() const { return atof(b.c_str()); }
+  long toInt() const { return atol(b.c_str()); }
+  char operator[](unsigned int i) const { return i < b.size() ? b[i] : 0; }
+private:
+  std::string b;
+  template <typename T> static std::string fmtInt(T v, unsigned char base) {
+    char t[40];
+    if (base == 16) snprintf(t, sizeof(t), "%llx", (unsigned long long)v);
+    else if ((T)-1 < 0) snprintf(t, sizeof(t), "%lld", (long long)v);
+    else snprintf(t, sizeof(t), "%llu", (unsigned long long)v);
+    return t;
+  }
+};
+
+class Print {
+public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t) = 0;
+  virtual size_t write(const uint8_t *buffer, size_t size) { size_t n = 0; while (size--) n += write(*buffer++); return n; }
+  size_t write(const char *str) { return write((const uint8_t*)str, strlen(str)); }
+  size_t printf(const char *fmt, ...) __attribute__((format(printf, 2, 3))) {
+    char t[512]; va_list ap; va_start(ap, fmt); int n = vsnprintf(t, sizeof(t), fmt, ap); va_end(ap);
+    return write((const uint8_t*)t, std::min<size_t>(n, sizeof(t) - 1));
+  }
+  size_t print(const char *s) { return write(s); }
+  size_t print(const String &s) { return write(s.c_str()); }
+  size_t print(int v, int = 10) { return print(String(v)); }
+  size_t print(unsigned int v, int = 10) { return print(String(v)); }
+  size_t print(long v, int = 10) { return print(String(v)); }
+  size_t print(unsigned long v, int = 10) { return print(String(v)); }
+  size_t print(double v, int d = 2) { return print(String(v, (unsigned char)d)); }
+  size_t print(char c) { return write((uint8_t)c); }
+  size_t print(const __FlashStringHelper *s) { return write((const char*)s); }
+  size_t println(const char *s) { return print(s) + println(); }
+  size_t println(const String &s) { return print(s) + println(); }
+  size_t println(int v, int b = 10) { return print(v, b) + println(); }
+  size_t println(unsigned long v, int b = 10) { return print(v, b) + println(); }
+  size_t println() { return write("\r\n"); }
+  size_t println(const __FlashStringHelper *s) { return print(s) + println(); }
+};
+
+class Stream : public Print {
+public:
+  virtual int available() = 0;
+  virtual int read() = 0;
+  virtual int peek() = 0;
+  size_t readBytes(char *b, size_t n) { size_t i = 0; for (; i < n && available() > 0; i++) b[i] = read(); return i; }
+  size_t readBytes(uint8_t *b, size_t n) { return readBytes((char*)b, n); }
+  void setTimeout(unsigned long) {}
+};
+
+#define SERIAL_8N1 0x1c
+#define SERIAL_FULL 0
+#define SERIAL_RX_ONLY 1
+#define SERIAL_TX_ONLY 2
+
+// Serial output is dropped unless a test wants to look at it
+class HardwareSerial : public Stream {
+public:
+  std::string out;
+  bool capture = false;
+  void begin(unsigned long, int = SERIAL_8N1, int = SERIAL_FULL) {}
+  size_t write(uint8_t c) override { if (capture) out += (char)c; return 1; }
+  using Print::write;
+  int available() override { return 0; }
+  int read() override { return -1; }
+  int peek() override { return -1; }
+};
+inline HardwareSerial Serial;
+
+class EspClass {
+public:
+  uint32_t getFreeHeap() { return 40000; }
+  uint32_t getMaxFreeBlockSize() { return 30000; }
+  uint8_t getHeapFragmentation() { return 10; }
+  uint32_t getCycleCount() { return (uint32_t)(hostNowUs * 80); }
+  uint8_t getCpuFreqMHz() { return 80; }
+  void restart() {}
+  uint32_t getChipId() { return 0x123456; }
+};
+inline EspClass ESP;
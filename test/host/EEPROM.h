@@ -0,0 +1,13 @@
+#pragma once
+#include <Arduino.h>
+class EEPROMClass {
+public:
+  uint8_t data[4096];
+  void begin(size_t) {}
+  bool commit() { return true; }
+  template<typename T> T &get(int a, T &t) { memcpy(&t, data + a, sizeof(T)); return t; }
+  template<typename T> const T &put(int a, const T &t) { memcpy(data + a, &t, sizeof(T)); return t; }
+  uint8_t read(int a) { return data[a]; }
+  void write(int a, uint8_t v) { data[a] = v; }
+};
+inline EEPROMClass EEPROM;
@@ -0,0 +1,55 @@
+// Host web server: tests call hostRequest() to run a route and read back
+// the status, response headers and body. Request headers go in `headers`;
+// like the core, header() only sees the ones named in collectHeaders().
+#pragma once
+#include <ESP8266WiFi.h>
+#include <map>
+#include <vector>
+#define CONTENT_LENGTH_UNKNOWN ((size_t) -1)
+enum HTTPMethod { HTTP_ANY, HTTP_GET, HTTP_POST };
+
+class ESP8266WebServer {
+public:
+  ESP8266WebServer(int) {}
+  std::map<std::string, std::function<void(void)>> routes;
+  std::map<std::string, std::string> args, headers, sentHeaders;
+  std::vector<std::string> collected;
+  std::string body;
+  int code = 0;
+  WiFiClient hostClient;
+
+  bool hostRequest(const char *uri) {
+    auto it = routes.find(uri);
+    if (it == routes.end()) return false;
+    body.clear(); sentHeaders.clear(); code = 0;
+    it->second();
+    return true;
+  }
+
+  void on(const char *uri, std::function<void(void)> fn) { routes[uri] = fn; }
+  void begin() {}
+  void handleClient() {}
+  bool hasArg(const char *a) const { return args.count(a); }
+  String arg(const char *a) const { auto it = args.find(a); return it == args.end() ? String() : String(it->second.c_str()); }
+  String header(const char *h) const {
+    auto it = headers.find(h);
+    return it == headers.end() || !hasHeader(h) ? String() : String(it->second.c_str());
+  }
+  bool hasHeader(const char *h) const {
+    return headers.count(h) && std::find(collected.begin(), collected.end(), h) != collected.end();
+  }
+  void collectHeaders(const char *keys[], const size_t n) { collected.assign(keys, keys + n); }
+  void send(int c, const char * = NULL, const String &content = String("")) { code = c; body += content.c_str(); }
+  void send(int c, const char *, const char *content) { code = c; body += content; }
+  void send(int c, const char *, const char *content, size_t n) { code = c; body.append(content, n); }
+  void send_P(int c, PGM_P, PGM_P content) { code = c; body += content; }
+  void send_P(int c, PGM_P, PGM_P content, size_t n) { code = c; body.append(content, n); }
+  void sendHeader(const String &k, const String &v, bool = false) { sentHeaders[k.c_str()] = v.c_str(); }
+  void setContentLength(const size_t) {}
+  void sendContent(const String &content) { body += content.c_str(); }
+  void sendContent(const char *content, size_t n) { body.append(content, n); }
+  void sendContent_P(PGM_P content) { body += content; }
+  void sendContent_P(PGM_P content, size_t n) { body.append(content, n); }
+  WiFiClient &client() { return hostClient; }
+  String uri() { return String(); }
+};
@@ -0,0 +1,45 @@
+#pragma once
+#include <Arduino.h>
+#include <user_interface.h>
+#include <WiFiClient.h>
+#include <vector>
+#define ENC_TYPE_NONE 7
+#define WIFI_SCAN_RUNNING (-1)
+#define WIFI_SCAN_FAILED (-2)
+typedef enum { WL_IDLE_STATUS=0, WL_NO_SSID_AVAIL=1, WL_SCAN_COMPLETED=2, WL_CONNECTED=3, WL_CONNECT_FAILED=4, WL_CONNECTION_LOST=5, WL_WRONG_PASSWORD=6, WL_DISCONNECTED=7 } wl_status_t;
+typedef enum { WIFI_OFF=0, WIFI_STA=1, WIFI_AP=2, WIFI_AP_STA=3 } WiFiMode_t;
+
+// Host Wi-Fi: link state and scan results are whatever the test sets
+class ESP8266WiFiClass {
+public:
+  wl_status_t hostStatus = WL_DISCONNECTED;
+  std::vector<bss_info> hostScan;
+  uint32_t hostIP = 0x0100A8C0;   // 192.168.0.1
+
+  wl_status_t status() { return hostStatus; }
+  String SSID() const { return String((const char *)hostStationConfig.ssid); }
+  String SSID(uint8_t i) { return i < hostScan.size() ? String(std::string((const char *)hostScan[i].ssid, hostScan[i].ssid_len).c_str()) : String(); }
+  int32_t RSSI() { return -60; }
+  int32_t RSSI(uint8_t i) { return i < hostScan.size() ? hostScan[i].rssi : 0; }
+  uint8_t encryptionType(uint8_t) { return 4; }
+  uint8_t *BSSID() { static uint8_t b[6]; return b; }
+  uint8_t *BSSID(uint8_t i) { return i < hostScan.size() ? hostScan[i].bssid : nullptr; }
+  int32_t channel() { return 6; }
+  int32_t channel(uint8_t i) { return i < hostScan.size() ? hostScan[i].channel : 0; }
+  IPAddress localIP() { return IPAddress(hostIP); }
+  IPAddress gatewayIP() { return IPAddress(192, 168, 0, 254); }
+  IPAddress subnetMask() { return IPAddress(255, 255, 255, 0); }
+  IPAddress dnsIP(uint8_t = 0) { return IPAddress(192, 168, 0, 254); }
+  int8_t scanNetworks(bool async = false, bool = false, uint8_t = 0, uint8_t * = NULL) { return async ? WIFI_SCAN_RUNNING : hostScan.size(); }
+  int8_t scanComplete() { return hostScan.size(); }
+  void scanDelete() {}
+  void *getScanInfoByIndex(int i) { return i < (int)hostScan.size() ? &hostScan[i] : nullptr; }
+  wl_status_t begin(const char *, const char * = NULL, int32_t = 0, const uint8_t * = NULL, bool = true) { return hostStatus; }
+  bool config(IPAddress, IPAddress, IPAddress, IPAddress = (uint32_t)0, IPAddress = (uint32_t)0) { return true; }
+  bool mode(WiFiMode_t) { return true; }
+  bool disconnect(bool = false) { return true; }
+  void persistent(bool) {}
+  bool setAutoReconnect(bool) { return true; }
+  int hostByName(const char *, IPAddress &r, uint32_t) { r = IPAddress(10, 0, 0, 1); return 1; }
+};
+inline ESP8266WiFiClass WiFi;
@@ -0,0 +1,13 @@
+#pragma once
+#include <ESP8266WiFi.h>
+class MDNSResponder {
+public:
+  bool running = false;
+  bool begin(const char *) { running = true; return true; }
+  bool addService(const char *, const char *, uint16_t) { return true; }
+  bool isRunning() { return running; }
+  bool update() { return true; }
+  bool notifyAPChange() { return true; }
+  void end() { running = false; }
+};
+inline MDNSResponder MDNS;
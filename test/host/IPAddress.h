@@ -0,0 +1,15 @@
+#pragma once
+#include <Arduino.h>
+class IPAddress {
+public:
+  IPAddress() : v(0) {}
+  IPAddress(uint32_t a) : v(a) {}
+  IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d) : v(a | b << 8 | c << 16 | (uint32_t)d << 24) {}
+  operator uint32_t() const { return v; }
+  uint8_t operator[](int i) const { return v >> (8 * i); }
+  uint8_t &operator[](int i) { return ((uint8_t *)&v)[i]; }
+  String toString() const { char t[16]; snprintf(t, sizeof(t), "%u.%u.%u.%u", (*this)[0], (*this)[1], (*this)[2], (*this)[3]); return String(t); }
+  bool isSet() const { return v != 0; }
+private:
+  uint32_t v;
+};
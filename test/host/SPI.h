@@ -0,0 +1,4 @@
+#pragma once
+#include <Arduino.h>
+class SPIClass { public: void begin() {} void setFrequency(uint32_t) {} };
+inline SPIClass SPI;
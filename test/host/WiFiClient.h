@@ -0,0 +1,38 @@
+// Host WiFiClient: copies share one fake socket, like ClientContext on the device
+#pragma once
+#include <Arduino.h>
+#include <IPAddress.h>
+#include <memory>
+
+struct HostSocket {
+  std::string out;          // bytes the sketch wrote
+  std::string in;           // bytes waiting for the sketch to read
+  bool connected = true;
+  size_t writeRoom = 1460;  // what availableForWrite() reports
+};
+
+class WiFiClient : public Stream {
+public:
+  WiFiClient() {}
+  explicit WiFiClient(std::shared_ptr<HostSocket> s) : sock(std::move(s)) {}
+  std::shared_ptr<HostSocket> sock;
+
+  int connect(IPAddress, uint16_t) { sock = std::make_shared<HostSocket>(); return 1; }
+  int connect(const char *, uint16_t) { sock = std::make_shared<HostSocket>(); return 1; }
+  size_t write(uint8_t c) override { return write(&c, 1); }
+  size_t write(const uint8_t *b, size_t n) override { if (!connected()) return 0; sock->out.append((const char *)b, n); return n; }
+  using Print::write;
+  int available() override { return sock ? (int)sock->in.size() : 0; }
+  int read() override { if (!available()) return -1; int c = (uint8_t)sock->in[0]; sock->in.erase(0, 1); return c; }
+  int read(uint8_t *buf, size_t size) { size_t n = std::min(size, (size_t)available()); memcpy(buf, sock->in.data(), n); sock->in.erase(0, n); return n; }
+  int peek() override { return available() ? (uint8_t)sock->in[0] : -1; }
+  uint8_t connected() { return sock && (sock->connected || !sock->in.empty()); }
+  uint8_t status() { return connected() ? 4 : 0; }
+  void stop() { if (sock) sock->connected = false; }
+  operator bool() { return connected(); }
+  void setNoDelay(bool) {}
+  void setSync(bool) {}
+  size_t availableForWrite() { return sock && sock->connected ? sock->writeRoom : 0; }
+  IPAddress remoteIP() { return IPAddress(127, 0, 0, 1); }
+  void flush() {}
+};
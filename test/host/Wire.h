@@ -0,0 +1,82 @@
+// Host I2C with a register-level MPU6050 at 0x68; other addresses NACK.
+// Tests queue FIFO bytes and raise the overflow flag through hostMpu, and
+// see every burst length read back from FIFO_R_W.
+#pragma once
+#include <Arduino.h>
+#include <deque>
+#include <vector>
+#define BUFFER_LENGTH 128
+
+class HostMpu6050 {
+public:
+  static const uint8_t ADDR = 0x68;
+  static const size_t FIFO_SIZE = 1024;
+  uint8_t regs[128] = {};
+  std::deque<uint8_t> fifo;
+  bool overflow = false;             // INT_STATUS bit 4, cleared on read
+  uint32_t fifoResets = 0;
+  std::vector<size_t> fifoBursts;    // length of every FIFO_R_W read
+
+  // Queue one accel+gyro frame as the chip does with FIFO_EN = 0x78
+  void pushSample(int16_t ax, int16_t ay, int16_t az, int16_t gx, int16_t gy, int16_t gz) {
+    const int16_t v[6] = { ax, ay, az, gx, gy, gz };
+    for (int16_t w : v) { pushByte((uint8_t)(w >> 8)); pushByte((uint8_t)w); }
+  }
+  void pushByte(uint8_t b) {
+    if (fifo.size() >= FIFO_SIZE) { fifo.pop_front(); overflow = true; }
+    fifo.push_back(b);
+  }
+  void reset() { *this = HostMpu6050(); }
+
+  void write(uint8_t reg, uint8_t v) {
+    regs[reg & 127] = v;
+    if (reg == 0x6A && (v & 0x04)) { fifo.clear(); overflow = false; fifoResets++; }
+  }
+  uint8_t read(uint8_t &reg) {
+    switch (reg) {
+      case 0x3A: { uint8_t s = overflow ? 0x10 : 0; overflow = false; reg++; return s; }
+      case 0x72: reg++; return (uint8_t)(fifo.size() >> 8);
+      case 0x73: reg++; return (uint8_t)fifo.size();
+      case 0x74: {                   // FIFO_R_W does not auto-increment
+        if (fifo.empty()) return 0xFF;
+        uint8_t b = fifo.front(); fifo.pop_front(); return b;
+      }
+      default: return regs[reg++ & 127];
+    }
+  }
+};
+inline HostMpu6050 hostMpu;
+
+class TwoWire : public Stream {
+public:
+  void begin(int, int) {}
+  void begin() {}
+  void setClock(uint32_t) {}
+  void beginTransmission(uint8_t addr) { txAddr = addr; txLen = 0; }
+  uint8_t endTransmission(bool = true) {
+    if (txAddr != HostMpu6050::ADDR) return 2;
+    if (txLen > 0) ptr = tx[0];
+    for (size_t i = 1; i < txLen; i++) hostMpu.write(ptr++, tx[i]);
+    return 0;
+  }
+  size_t requestFrom(uint8_t addr, size_t n, bool) {
+    rxLen = rxPos = 0;
+    if (addr != HostMpu6050::ADDR) return 0;
+    if (n > BUFFER_LENGTH) n = BUFFER_LENGTH;
+    if (ptr == 0x74) hostMpu.fifoBursts.push_back(n);
+    while (rxLen < n) rx[rxLen++] = hostMpu.read(ptr);
+    return n;
+  }
+  uint8_t requestFrom(uint8_t addr, uint8_t n) { return (uint8_t)requestFrom(addr, (size_t)n, true); }
+  size_t write(uint8_t b) override { if (txLen < BUFFER_LENGTH) tx[txLen++] = b; return 1; }
+  size_t write(const uint8_t *b, size_t n) override { for (size_t i = 0; i < n; i++) write(b[i]); return n; }
+  int available() override { return (int)(rxLen - rxPos); }
+  int read() override { return rxPos < rxLen ? rx[rxPos++] : -1; }
+  int peek() override { return rxPos < rxLen ? rx[rxPos] : -1; }
+
+private:
+  uint8_t txAddr = 0, ptr = 0;
+  uint8_t tx[BUFFER_LENGTH], rx[BUFFER_LENGTH];
+  size_t txLen = 0, rxLen = 0, rxPos = 0;
+};
+inline TwoWire Wire;
@@ -0,0 +1,23 @@
+// Host DNS: dns_gethostbyname() answers with hostDnsResult; for
+// ERR_INPROGRESS the test completes the lookup with hostDnsAnswer()
+#pragma once
+#include <lwip/err.h>
+
+typedef void (*dns_found_callback)(const char *name, const ip_addr_t *ipaddr, void *callback_arg);
+inline err_t hostDnsResult = ERR_INPROGRESS;
+inline ip_addr_t hostDnsCached = { 0 };
+inline dns_found_callback hostDnsCb = nullptr;
+inline void *hostDnsArg = nullptr;
+inline int hostDnsQueries = 0;
+
+inline err_t dns_gethostbyname(const char *, ip_addr_t *addr, dns_found_callback found, void *arg) {
+  hostDnsQueries++;
+  if (hostDnsResult == ERR_OK) *addr = hostDnsCached;
+  else if (hostDnsResult == ERR_INPROGRESS) { hostDnsCb = found; hostDnsArg = arg; }
+  return hostDnsResult;
+}
+inline void hostDnsAnswer(const ip_addr_t *ip) {
+  dns_found_callback cb = hostDnsCb;
+  hostDnsCb = nullptr;
+  if (cb) cb("host", ip, hostDnsArg);
+}
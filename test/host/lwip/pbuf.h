@@ -0,0 +1,59 @@
+// Host pbufs: heap chains with lwIP's copy/free semantics. hostPbufLive
+// counts allocations so tests can check nothing leaks.
+#pragma once
+#include <lwip/err.h>
+#include <stdlib.h>
+#include <string.h>
+
+struct pbuf {
+  pbuf *next;
+  void *payload;
+  uint16_t tot_len, len;
+  char *hostMem;
+};
+inline int hostPbufLive = 0;
+
+inline pbuf *hostPbufNew(const char *data, uint16_t n) {
+  pbuf *p = (pbuf *)calloc(1, sizeof(pbuf));
+  p->hostMem = (char *)malloc(n ? n : 1);
+  memcpy(p->hostMem, data, n);
+  p->payload = p->hostMem; p->len = p->tot_len = n;
+  hostPbufLive++;
+  return p;
+}
+inline uint8_t pbuf_free(pbuf *p) {
+  uint8_t n = 0;
+  while (p) { pbuf *next = p->next; free(p->hostMem); free(p); hostPbufLive--; n++; p = next; }
+  return n;
+}
+inline void pbuf_cat(pbuf *h, pbuf *t) {
+  for (; h->next; h = h->next) h->tot_len += t->tot_len;
+  h->tot_len += t->tot_len;
+  h->next = t;
+}
+inline uint16_t pbuf_copy_partial(const pbuf *p, void *dataptr, uint16_t len, uint16_t offset) {
+  uint16_t copied = 0;
+  for (; p && copied < len; p = p->next) {
+    if (offset >= p->len) { offset -= p->len; continue; }
+    uint16_t n = p->len - offset < len - copied ? p->len - offset : len - copied;
+    memcpy((char *)dataptr + copied, (char *)p->payload + offset, n);
+    copied += n; offset = 0;
+  }
+  return copied;
+}
+// Drops `size` bytes from the front, freeing pbufs that become empty
+inline pbuf *pbuf_free_header(pbuf *q, uint16_t size) {
+  while (q && size >= q->len) {
+    size -= q->len;
+    pbuf *next = q->next;
+    q->next = nullptr;
+    pbuf_free(q);
+    q = next;
+  }
+  if (q && size) {
+    q->payload = (char *)q->payload + size;
+    q->len -= size;
+    for (pbuf *p = q; p; p = p->next) p->tot_len -= size;
+  }
+  return q;
+}
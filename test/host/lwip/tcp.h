@@ -0,0 +1,63 @@
+// Host raw TCP: the calls the sketch makes, recorded on a fake pcb. Tests
+// play the remote side with the hostTcp*() helpers, which invoke the
+// callbacks the sketch registered the way lwIP would.
+#pragma once
+#include <lwip/pbuf.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+struct tcp_pcb;
+typedef err_t (*tcp_recv_fn)(void *arg, tcp_pcb *tpcb, pbuf *p, err_t err);
+typedef err_t (*tcp_connected_fn)(void *arg, tcp_pcb *tpcb, err_t err);
+typedef void (*tcp_err_fn)(void *arg, err_t err);
+#define TCP_WRITE_FLAG_COPY 0x01
+
+struct tcp_pcb {
+  void *arg = nullptr;
+  tcp_recv_fn recv = nullptr;
+  tcp_err_fn errf = nullptr;
+  tcp_connected_fn connected = nullptr;
+  ip_addr_t ip = { 0 };
+  uint16_t port = 0;
+  std::string sent;
+  uint32_t recved = 0;
+  bool nagleOff = false, closed = false, dead = false;
+};
+// pcbs stay allocated for the whole test so helpers can inspect them
+inline std::vector<std::unique_ptr<tcp_pcb>> hostPcbs;
+inline bool hostTcpNewFails = false;
+inline err_t hostConnectResult = ERR_OK;
+inline tcp_pcb *hostPcb() { return hostPcbs.empty() ? nullptr : hostPcbs.back().get(); }
+inline int hostPcbsOpen() { int n = 0; for (auto &p : hostPcbs) n += !p->closed && !p->dead; return n; }
+
+inline tcp_pcb *tcp_new() {
+  if (hostTcpNewFails) return nullptr;
+  hostPcbs.emplace_back(new tcp_pcb());
+  return hostPcb();
+}
+inline void tcp_arg(tcp_pcb *p, void *arg) { p->arg = arg; }
+inline void tcp_recv(tcp_pcb *p, tcp_recv_fn f) { p->recv = f; }
+inline void tcp_err(tcp_pcb *p, tcp_err_fn f) { p->errf = f; }
+inline void tcp_nagle_disable(tcp_pcb *p) { p->nagleOff = true; }
+inline uint16_t tcp_sndbuf(tcp_pcb *) { return 2920; }
+inline err_t tcp_connect(tcp_pcb *p, const ip_addr_t *ip, uint16_t port, tcp_connected_fn f) {
+  p->ip = *ip; p->port = port; p->connected = f;
+  return hostConnectResult;
+}
+inline err_t tcp_write(tcp_pcb *p, const void *data, uint16_t len, uint8_t) { p->sent.append((const char *)data, len); return ERR_OK; }
+inline err_t tcp_output(tcp_pcb *) { return ERR_OK; }
+inline void tcp_recved(tcp_pcb *p, uint16_t len) { p->recved += len; }
+inline err_t tcp_close(tcp_pcb *p) { p->closed = true; return ERR_OK; }
+inline void tcp_abort(tcp_pcb *p) { p->closed = true; }
+
+inline void hostTcpAccept(tcp_pcb *p) { if (p->connected && !p->closed) p->connected(p->arg, p, ERR_OK); }
+inline void hostTcpDeliver(tcp_pcb *p, const std::string &data) {
+  if (p->recv && !p->closed) p->recv(p->arg, p, hostPbufNew(data.data(), data.size()), ERR_OK);
+}
+inline void hostTcpRemoteClose(tcp_pcb *p) { if (p->recv && !p->closed) p->recv(p->arg, p, nullptr, ERR_OK); }
+// Connection reset: lwIP frees the pcb, then reports the error
+inline void hostTcpReset(tcp_pcb *p) {
+  p->dead = true;
+  if (p->errf) p->errf(p->arg, ERR_RST);
+}
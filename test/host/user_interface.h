@@ -0,0 +1,8 @@
+#pragma once
+#include <stdint.h>
+#include <string.h>
+typedef enum { AUTH_OPEN = 0, AUTH_WEP, AUTH_WPA_PSK, AUTH_WPA2_PSK, AUTH_WPA_WPA2_PSK, AUTH_MAX } AUTH_MODE;
+struct bss_info { struct { struct bss_info *stqe_next; } next; uint8_t bssid[6]; uint8_t ssid[32]; uint8_t ssid_len; uint8_t channel; int8_t rssi; AUTH_MODE authmode; uint8_t is_hidden; int16_t freq_offset; int16_t freqcal_val; uint8_t *esp_mesh_ie; uint8_t simple_pair; };
+struct station_config { uint8_t ssid[32]; uint8_t password[64]; uint8_t bssid_set; uint8_t bssid[6]; };
+inline struct station_config hostStationConfig;
+inline bool wifi_station_get_config(struct station_config *config) { *config = hostStationConfig; return true; }
@@ -0,0 +1,60 @@
+// IMU replay fixture loader and the float filter fuseSample() replaced,
+// shared by test_fusion and bench_fusion. Include after ../main.cpp.
+#pragma once
+#include <vector>
+
+struct ImuSample { int16_t ax, ay, az, gx, gy, gz; float pitch, roll; };
+
+static const uint32_t REPLAY_DT_US = 5000;   // fixture is 200 Hz
+
+// Offsets the fixture was synthesized with, as calibration would find them
+static void replayCalibrate() {
+  gx_offset = 14; gy_offset = -9; gz_offset = 6;
+  ax_offset = 120; ay_offset = -80; az_offset = 300;
+  fusionSetOffsets();
+}
+
+static std::vector<ImuSample> loadReplay(const char *path = "fixtures/imu_replay.csv") {
+  std::vector<ImuSample> v;
+  FILE *f = fopen(path, "r");
+  if (!f) return v;
+  char line[128];
+  while (fgets(line, sizeof(line), f)) {
+    int a[6]; ImuSample s;
+    if (line[0] == '#') continue;
+    if (sscanf(line, "%d,%d,%d,%d,%d,%d,%f,%f", &a[0], &a[1], &a[2], &a[3], &a[4], &a[5], &s.pitch, &s.roll) != 8)
+      continue;
+    s.ax = a[0]; s.ay = a[1]; s.az = a[2]; s.gx = a[3]; s.gy = a[4]; s.gz = a[5];
+    v.push_back(s);
+  }
+  fclose(f);
+  return v;
+}
+
+// The float complementary filter as updateMPU6050() ran it before the
+// Q16.16 port, line for line
+struct FloatFusion {
+  float pitch = 0, roll = 0, yaw = 0;
+  float pitch_filtered = 0, roll_filtered = 0, yaw_filtered = 0;
+  void step(int16_t axr, int16_t ayr, int16_t azr, int16_t gxr, int16_t gyr, int16_t gzr, float dt) {
+    float ax_g = (axr - ax_offset) / 16384.0f;
+    float ay_g = (ayr - ay_offset) / 16384.0f;
+    float az_g = (azr - az_offset) / 16384.0f;
+
+    float gx_dps = (gxr - gx_offset) / 131.0f;
+    float gy_dps = (gyr - gy_offset) / 131.0f;
+    float gz_dps = (gzr - gz_offset) / 131.0f;
+
+    float pitch_acc = atan2(ay_g, az_g) * 180.0f / PI;
+    float roll_acc = atan2(-ax_g, az_g) * 180.0f / PI;
+
+    float alpha = 0.98f;
+    pitch = alpha * (pitch + gx_dps * dt) + (1.0f - alpha) * pitch_acc;
+    roll = alpha * (roll + gy_dps * dt) + (1.0f - alpha) * roll_acc;
+    yaw += gz_dps * dt;
+
+    pitch_filtered = FILTER_ALPHA * pitch_filtered + (1.0f - FILTER_ALPHA) * pitch;
+    roll_filtered = FILTER_ALPHA * roll_filtered + (1.0f - FILTER_ALPHA) * roll;
+    yaw_filtered = FILTER_ALPHA * yaw_filtered + (1.0f - FILTER_ALPHA) * yaw;
+  }
+};
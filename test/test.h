@@ -0,0 +1,35 @@
+// Minimal host test runner. Each test_*.cpp includes the sketch and this
+// header, defines TEST()s, and the Makefile builds and runs it.
+#pragma once
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+struct TestCase { const char *name; void (*fn)(); };
+inline std::vector<TestCase> &testCases() { static std::vector<TestCase> v; return v; }
+inline int testFailures = 0;
+
+struct TestReg { TestReg(const char *n, void (*f)()) { testCases().push_back({ n, f }); } };
+#define TEST(name) \
+  static void test_##name(); \
+  static TestReg reg_##name(#name, test_##name); \
+  static void test_##name()
+
+#define CHECK(cond) do { if (!(cond)) { \
+  fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); testFailures++; } } while (0)
+#define CHECK_EQ(a, b) do { long long va_ = (long long)(a), vb_ = (long long)(b); if (va_ != vb_) { \
+  fprintf(stderr, "%s:%d: %s == %s failed (%lld vs %lld)\n", __FILE__, __LINE__, #a, #b, va_, vb_); testFailures++; } } while (0)
+#define CHECK_STR(a, b) do { const char *sa_ = (a), *sb_ = (b); if (strcmp(sa_, sb_)) { \
+  fprintf(stderr, "%s:%d: \"%s\" != \"%s\"\n", __FILE__, __LINE__, sa_, sb_); testFailures++; } } while (0)
+#define CHECK_NEAR(a, b, tol) do { double va_ = (a), vb_ = (b); if (fabs(va_ - vb_) > (tol)) { \
+  fprintf(stderr, "%s:%d: |%s - %s| <= %g failed (%g vs %g)\n", __FILE__, __LINE__, #a, #b, (double)(tol), va_, vb_); testFailures++; } } while (0)
+
+int main() {
+  tft.setRotation(1);   // landscape, as setup() leaves it
+  for (auto &t : testCases()) {
+    int before = testFailures;
+    t.fn();
+    printf("%-40s %s\n", t.name, testFailures == before ? "ok" : "FAIL");
+  }
+  return testFailures ? 1 : 0;
+}
@@ -0,0 +1,112 @@
+// Mahony ahrsUpdate against a double-precision reference and against the
+// true attitude of synthetic motion (built with IMU_FILTER_MAHONY, see Makefile)
+#include "../main.cpp"
+#include "test.h"
+
+// Same update in double precision
+struct RefMahony {
+  double q0 = 1, q1 = 0, q2 = 0, q3 = 0, ix = 0, iy = 0, iz = 0;
+  void update(double gx, double gy, double gz, double ax, double ay, double az, double dt) {
+    double n = ax*ax + ay*ay + az*az;
+    if (n > 0) {
+      double r = 1 / sqrt(n);
+      ax *= r; ay *= r; az *= r;
+      double vx = 2*(q1*q3 - q0*q2), vy = 2*(q0*q1 + q2*q3), vz = q0*q0 - q1*q1 - q2*q2 + q3*q3;
+      double ex = ay*vz - az*vy, ey = az*vx - ax*vz, ez = ax*vy - ay*vx;
+      ix += AHRS_KI * ex * dt; iy += AHRS_KI * ey * dt; iz += AHRS_KI * ez * dt;
+      gx += AHRS_KP * ex + ix; gy += AHRS_KP * ey + iy; gz += AHRS_KP * ez + iz;
+    }
+    gx *= 0.5 * dt; gy *= 0.5 * dt; gz *= 0.5 * dt;
+    double a = q0, b = q1, c = q2, d = q3;
+    q0 = a + (-b*gx - c*gy - d*gz);
+    q1 = b + ( a*gx + c*gz - d*gy);
+    q2 = c + ( a*gy - b*gz + d*gx);
+    q3 = d + ( a*gz + b*gy - c*gx);
+    double r = 1 / sqrt(q0*q0 + q1*q1 + q2*q2 + q3*q3);
+    q0 *= r; q1 *= r; q2 *= r; q3 *= r;
+  }
+};
+
+static void resetAhrs() {
+  ahrs_q0 = 1; ahrs_q1 = ahrs_q2 = ahrs_q3 = 0;
+  ahrs_ix = ahrs_iy = ahrs_iz = 0;
+  ahrsSeeded = false; ahrsLastYaw = 0;
+  pitch_q = roll_q = yaw_q = 0;
+  pitch_fq = roll_fq = yaw_fq = 0;
+  gx_off_q8 = gy_off_q8 = gz_off_q8 = ax_off_q8 = ay_off_q8 = az_off_q8 = 0;
+}
+
+// Angle between the gravity directions two attitudes predict, in degrees
+// (yaw is unobservable from the accelerometer, so only tilt is compared)
+static double tiltAngle(double a0, double a1, double a2, double a3, double b0, double b1, double b2, double b3) {
+  double ax = 2*(a1*a3 - a0*a2), ay = 2*(a0*a1 + a2*a3), az = a0*a0 - a1*a1 - a2*a2 + a3*a3;
+  double bx = 2*(b1*b3 - b0*b2), by = 2*(b0*b1 + b2*b3), bz = b0*b0 - b1*b1 - b2*b2 + b3*b3;
+  double c = (ax*bx + ay*by + az*bz) / sqrt((ax*ax + ay*ay + az*az) * (bx*bx + by*by + bz*bz));
+  return acos(fmin(1.0, c)) * 180 / M_PI;
+}
+
+TEST(float_update_matches_double_reference) {
+  resetAhrs();
+  RefMahony ref;
+  double worst = 0;
+  // Tumbling motion on all three axes; the accel is deliberately not
+  // consistent with the gyro so the PI feedback is exercised
+  for (int i = 0; i < 20000; i++) {
+    double t = i * 0.005;
+    double gx = 1.2 * sin(1.3 * t), gy = 0.8 * cos(0.9 * t), gz = 0.5 * sin(0.4 * t + 1);
+    double ax = 0.3 * sin(0.5 * t), ay = 0.2 * cos(0.7 * t), az = 1.0;
+    ahrsUpdate(gx, gy, gz, ax, ay, az, 0.005f);
+    ref.update(gx, gy, gz, ax, ay, az, 0.005);
+    worst = fmax(worst, tiltAngle(ahrs_q0, ahrs_q1, ahrs_q2, ahrs_q3, ref.q0, ref.q1, ref.q2, ref.q3));
+  }
+  CHECK(worst < 0.01);
+  CHECK_NEAR(ahrs_q0*ahrs_q0 + ahrs_q1*ahrs_q1 + ahrs_q2*ahrs_q2 + ahrs_q3*ahrs_q3, 1.0, 1e-5);
+}
+
+// Raw sensor sample for a pitch (about x) / roll (about y) attitude
+static void feed(double pitchDeg, double rollDeg, double gxDps, double gyDps, double gzDps) {
+  double p = pitchDeg * M_PI / 180, r = rollDeg * M_PI / 180;
+  int ax = (int)lround(-16384 * sin(r)), ay = (int)lround(16384 * sin(p) * cos(r)),
+      az = (int)lround(16384 * cos(p) * cos(r));
+  fuseSample(ax, ay, az, (int)lround(gxDps * 131), (int)lround(gyDps * 131), (int)lround(gzDps * 131), 5000);
+}
+
+// The feedback compares the previous estimate with the current accel
+// sample, so on a moving trace the estimate runs slightly ahead of the
+// truth (about 0.25 deg here at 125 dps peak rate).
+TEST(tracks_true_pitch) {
+  resetAhrs();
+  const double w = 2 * M_PI * 0.4;
+  feed(0, 0, 0, 0, 0);
+  double worst = 0;
+  for (int i = 1; i < 4000; i++) {
+    double t = i * 0.005;
+    feed(50 * sin(w * t), 0, 50 * w * cos(w * (t - 0.0025)), 0, 0);
+    worst = fmax(worst, fabs(pitch_q / 65536.0 - 50 * sin(w * t)));
+  }
+  CHECK(worst < 0.4);
+}
+
+TEST(yaw_is_unwrapped) {
+  resetAhrs();
+  for (int i = 0; i < 4000; i++) feed(0, 0, 0, 0, 10);   // 10 dps for 20 s
+  CHECK_NEAR(yaw_q / 65536.0, 200.0, 0.5);
+}
+
+TEST(seeded_from_accel_and_steady_near_vertical) {
+  resetAhrs();
+  for (int i = 0; i < 200; i++) feed(0, 85, 0, 0, 0);
+  CHECK_NEAR(roll_q / 65536.0, 85.0, 0.2);
+  CHECK_NEAR(pitch_q / 65536.0, 0.0, 0.2);
+  resetAhrs();
+  for (int i = 0; i < 200; i++) feed(-120, 0, 0, 0, 0);   // past vertical: no gimbal lock in pitch
+  CHECK_NEAR(pitch_q / 65536.0, -120.0, 0.2);
+}
+
+TEST(integral_term_cancels_gyro_bias) {
+  resetAhrs();
+  const double biasDps = 2.0;
+  for (int i = 0; i < 200 * 120; i++) feed(10, 0, biasDps, 0, 0);
+  CHECK_NEAR(pitch_q / 65536.0, 10.0, 0.2);
+  CHECK_NEAR(ahrs_ix, -biasDps * M_PI / 180, 0.005);
+}
@@ -0,0 +1,82 @@
+// /api: the body matches what the String-concatenating handler sent, and
+// building it allocates nothing (operator new is replaced here and malloc
+// is wrapped at link time, see Makefile)
+#include "../main.cpp"
+#include "test.h"
+#include <new>
+
+static long allocations = 0;
+
+extern "C" void *__real_malloc(size_t);
+extern "C" void *__real_calloc(size_t, size_t);
+extern "C" void *__real_realloc(void *, size_t);
+extern "C" void *__wrap_malloc(size_t n) { allocations++; return __real_malloc(n); }
+extern "C" void *__wrap_calloc(size_t n, size_t k) { allocations++; return __real_calloc(n, k); }
+extern "C" void *__wrap_realloc(void *p, size_t n) { allocations++; return __real_realloc(p, n); }
+
+void *operator new(size_t n) {
+  allocations++;
+  if (void *p = __real_malloc(n ? n : 1)) return p;
+  throw std::bad_alloc();
+}
+void *operator new[](size_t n) { return operator new(n); }   // the library's delete frees them
+
+// handleAPI() as it was before the JsonWriter
+static std::string baselineApi() {
+  String json = "{";
+  json += "\"pitch\":" + String(pitch_filtered, 1) + ",";
+  json += "\"roll\":" + String(roll_filtered, 1) + ",";
+  json += "\"yaw\":" + String(yaw_filtered, 1) + ",";
+  json += "\"ssid\":\"" + WiFi.SSID() + "\",";
+  json += "\"ip\":\"" + WiFi.localIP().toString() + "\",";
+  json += "\"rssi\":" + String(WiFi.RSSI());
+  json += "}";
+  return json.c_str();
+}
+
+static void setState(double p, double r, double y, const char *ssid, uint32_t ip) {
+  pitch_fq = (q16_t)lround(p * 65536); roll_fq = (q16_t)lround(r * 65536); yaw_fq = (q16_t)lround(y * 65536);
+  fusionPublish();
+  memset(hostStationConfig.ssid, 0, sizeof(hostStationConfig.ssid));
+  memcpy(hostStationConfig.ssid, ssid, std::min(strlen(ssid), sizeof(hostStationConfig.ssid)));
+  WiFi.hostIP = ip;
+}
+
+TEST(api_body_matches_the_string_handler) {
+  weatherLastFetch = 0;                // the old handler had no weather block
+  struct { double p, r, y; const char *ssid; uint32_t ip; } states[] = {
+    { 0, 0, 0, "", 0 },
+    { 12.34, -5.05, 359.96, "HomeNet", 0x0100A8C0 },
+    { -89.96, 0.04, -1234.5, "cafe guest 5G", 0x6401000A },
+    { 0.049, -0.049, 100000.25, "ssid-exactly-thirty-two-chars-ok", 0xFFFFFFFF },
+  };
+  for (auto &s : states) {
+    setState(s.p, s.r, s.y, s.ssid, s.ip);
+    server.body.clear();
+    handleAPI();
+    CHECK_EQ(server.code, 200);
+    std::string want = baselineApi();
+    if (server.body != want) fprintf(stderr, "got  %s\nwant %s\n", server.body.c_str(), want.c_str());
+    CHECK(server.body == want);
+  }
+}
+
+TEST(api_does_not_allocate) {
+  setState(-12.3, 45.6, 789.0, "HomeNet", 0x0100A8C0);
+  for (long fetched : { 0L, 1L }) {
+    weatherLastFetch = fetched;
+    weatherHumidity = 55; weatherWindTenths = 31; weatherTempTenths = -42;
+    server.body.reserve(1024);         // the fake server's own buffer is not the handler's
+    server.body.clear();
+    allocations = 0;
+    for (int i = 0; i < 100; i++) { server.body.clear(); handleAPI(); }
+    long got = allocations;
+    CHECK_EQ(got, 0);
+    CHECK_EQ(server.code, 200);
+  }
+  weatherLastFetch = 0;
+  // the hooks do see the String version
+  allocations = 0;
+  baselineApi();
+  CHECK(allocations > 0);
+}
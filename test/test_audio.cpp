@@ -0,0 +1,114 @@
+// Tone edges and the sample ring, driving the timer1 ISR from the fake core
+#include "../main.cpp"
+#include "test.h"
+
+static const uint32_t SAMPLE_US = 1000000UL / AUDIO_SAMPLE_RATE;
+
+struct Playback { std::vector<uint64_t> edges; int samples = 0; uint8_t peak = 0; };
+
+// Runs the speaker for up to maxUs, refilling the ring the way taskAudio
+// does, and records the timestamps of rising edges on the output level
+static Playback play(uint64_t maxUs) {
+  Playback p;
+  uint8_t last = 128;
+  for (uint64_t t = 0; t < maxUs && speakerRunning; t += SAMPLE_US) {
+    updateSpeaker();
+    if (!hostTimer1Enabled || !hostTimer1Isr) break;
+    auto before = audioTail;
+    hostTimer1Isr();
+    if (audioTail != before) p.samples++;
+    uint8_t level = GPSD & 0xFF;
+    if (level > 128 && last <= 128) p.edges.push_back(t);
+    p.peak = max(p.peak, level);
+    last = level;
+    hostAdvanceUs(SAMPLE_US);
+  }
+  return p;
+}
+
+static void resetAudio() {
+  stopSpeaker();
+  GPSD = 128;
+  speaker_volume = 100;
+}
+
+TEST(timer_runs_at_the_sample_rate) {
+  resetAudio();
+  startTone(1000, 10, 100);
+  CHECK(hostTimer1Enabled);
+  CHECK(hostTimer1Isr == audioISR);
+  CHECK_EQ(hostTimer1Ticks, AUDIO_TICK_HZ / AUDIO_SAMPLE_RATE);
+  stopSpeaker();
+  CHECK(!hostTimer1Enabled);
+}
+
+TEST(edges_follow_requested_frequency) {
+  for (uint16_t freq : { 220, 440, 1000, 1234, 2000, 3100 }) {
+    resetAudio();
+    startTone(freq, 500, 100);
+    std::vector<uint64_t> e = play(600000).edges;
+    // Each period is the exact one rounded to a whole sample
+    double period = 1e6 / freq;
+    for (size_t i = 1; i < e.size(); i++)
+      CHECK(fabs((double)(e[i] - e[i - 1]) - period) < SAMPLE_US);
+    // and the error does not accumulate: the n-th edge stays within a
+    // sample of n exact periods after the first
+    CHECK(e.size() > 2);
+    size_t n = e.size() - 1;
+    CHECK_NEAR((double)(e[n] - e[0]), n * period, SAMPLE_US);
+    CHECK_NEAR((double)e.size(), freq * 0.5, 1.0);
+  }
+}
+
+TEST(duration_is_exact_in_samples) {
+  resetAudio();
+  startTone(880, 150, 100);
+  CHECK_EQ(play(1000000).samples, 150 * AUDIO_SAMPLE_RATE / 1000);
+  CHECK(!speakerRunning);
+  CHECK(!hostTimer1Enabled);
+}
+
+TEST(volume_sets_amplitude_not_pitch) {
+  resetAudio();
+  startTone(1000, 100, 100);
+  Playback loud = play(200000);
+  resetAudio();
+  startTone(1000, 100, 20);
+  Playback quiet = play(200000);
+  CHECK_EQ(loud.edges.size(), quiet.edges.size());
+  CHECK(loud.peak > quiet.peak && quiet.peak > 128);
+}
+
+TEST(underrun_holds_last_level) {
+  resetAudio();
+  startTone(1000, 50, 100);
+  updateSpeaker();
+  while (audioTail != audioHead) hostTimer1Isr();
+  uint32_t held = GPSD;
+  hostTimer1Isr();
+  CHECK_EQ(GPSD, held);
+  stopSpeaker();
+}
+
+TEST(ring_outlasts_a_full_redraw) {
+  // A full-screen repaint at 8 MHz SPI keeps taskAudio off the CPU this long
+  const uint32_t redrawUs = (uint32_t)((uint64_t)DISP_W * DISP_H * 16 * 1000000 / 8000000);
+  resetAudio();
+  startTone(440, 1000, 100);
+  for (int i = 0; i < AUDIO_RING_LEN / AUDIO_MIX_CHUNK + 1; i++) updateSpeaker();
+  CHECK_EQ((audioHead - audioTail) & AUDIO_RING_MASK, AUDIO_RING_LEN - 1);
+  for (uint32_t t = 0; t < redrawUs + 10000; t += SAMPLE_US) {
+    CHECK(audioTail != audioHead);
+    hostTimer1Isr();
+  }
+  // and the next few passes top it up again
+  for (int i = 0; i < 4; i++) updateSpeaker();
+  CHECK_EQ((audioHead - audioTail) & AUDIO_RING_MASK, AUDIO_RING_LEN - 1);
+  stopSpeaker();
+}
+
+TEST(sigma_delta_drives_the_speaker_pin) {
+  audioBegin();
+  CHECK_EQ(hostSigmaDeltaPin, SPEAKER_PIN);
+  CHECK_EQ(SPEAKER_PIN, 1);             // default build: amplifier wired to TX
+}
@@ -0,0 +1,14 @@
+// setup() on the host core, and the boot breakdown it leaves in /metrics
+#include "../main.cpp"
+#include "test.h"
+
+TEST(setup_reports_boot_stages_in_metrics) {
+  WiFi.hostStatus = WL_CONNECTED;
+  setup();
+  CHECK(strncmp(bootBreakdown, "boot tft ", 9) == 0);
+  CHECK(strstr(bootBreakdown, " total ") != nullptr);
+  CHECK(server.hostRequest("/metrics"));
+  CHECK_EQ(server.code, 200);
+  CHECK(server.body.find(std::string(bootBreakdown) + "\n") != std::string::npos);
+  CHECK(server.body.find("stage n min avg max p99 (us)\n") != std::string::npos);
+}
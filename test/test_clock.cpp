@@ -0,0 +1,108 @@
+// Wall clock derived from millis(): sub-second anchoring and two-way slew,
+// with the system clock faked through gettimeofday (linked with --wrap)
+#include "../main.cpp"
+#include "test.h"
+#include <sys/time.h>
+
+// System (SNTP) time in us, and how fast it runs against millis()
+static int64_t sysUs;
+static uint64_t sysAtHostUs;
+static double sysRate = 1.0;
+extern "C" int __wrap_gettimeofday(struct timeval *tv, void *) {
+  int64_t t = sysUs + (int64_t)((hostNowUs - sysAtHostUs) * sysRate);
+  tv->tv_sec = t / 1000000; tv->tv_usec = t % 1000000;
+  return 0;
+}
+static void setSystemTime(int64_t us) { sysUs = us; sysAtHostUs = hostNowUs; }
+static int64_t systemMs() { timeval tv; __wrap_gettimeofday(&tv, nullptr); return (int64_t)tv.tv_sec * 1000 + tv.tv_usec / 1000; }
+
+static const int64_t T0 = 1700000000LL * 1000000 + 999000;   // 999 ms into a second
+
+static void sync() {
+  ntpSynced = false; ntpState = NTP_IDLE; ntpStateMs = 0; ntpRetryMs = 0;
+  WiFi.hostStatus = WL_CONNECTED;
+  ntpStep();
+  CHECK_EQ(ntpState, NTP_WAITING);
+  ntpStep();
+  CHECK(ntpSynced);
+}
+
+TEST(anchor_keeps_the_sub_second_phase) {
+  hostNowUs = 123456789;
+  sysRate = 1.0;
+  setSystemTime(T0);
+  sync();
+  CHECK_EQ(clockNow(), 1700000000);
+  hostAdvanceMs(1);                      // the system clock ticks over now
+  CHECK_EQ(clockNow(), 1700000001);
+  for (int i = 0; i < 5000; i++) {
+    hostAdvanceUs(997);
+    CHECK(std::abs(clockWallMs() - systemMs()) <= 1);    // millis() resolution
+  }
+}
+
+// Drives an hour at a time through the NTP re-anchor with millis() running
+// `rate` times the true rate; returns the worst |shown - true| in ms seen
+// afterwards, checking that the shown second never goes backwards
+static int64_t runHours(double rate, int hours) {
+  int64_t worst = 0;
+  time_t last = clockNow();
+  for (int h = 0; h < hours; h++) {
+    for (int s = 0; s < 3600 * 4; s++) {
+      hostAdvanceUs(250000);
+      ntpStep();
+      time_t t = clockNow();
+      CHECK(t >= last);
+      CHECK(t - last <= 1);
+      last = t;
+      int64_t err = clockWallMs() - systemMs();
+      if (h == hours - 1 && s > 4 * 60) worst = std::max(worst, err < 0 ? -err : err);
+    }
+  }
+  return worst;
+}
+
+TEST(slews_out_drift_in_both_directions) {
+  for (double rate : { 1.0 / 1.0002, 1.0 / 0.9998 }) {      // millis() 200 ppm fast, then slow
+    hostNowUs = 5000000;
+    sysRate = rate;
+    setSystemTime(T0);
+    sync();
+    // Without correction the error would grow by 720 ms per hour; with it
+    // it stays within one hour's drift and is slewed back out
+    int64_t worst = runHours(rate, 12);
+    CHECK(worst <= 720 + 5);
+    CHECK(std::abs(clockWallMs() - systemMs()) <= 720 + 5);
+  }
+}
+
+TEST(large_error_is_stepped) {
+  hostNowUs = 9000000;
+  sysRate = 1.0;
+  setSystemTime(T0);
+  sync();
+  hostAdvanceMs(NTP_REANCHOR_MS);
+  setSystemTime(T0 + (int64_t)NTP_REANCHOR_MS * 1000 + 30 * 1000000LL);   // 30 s jump
+  ntpStep();
+  CHECK_EQ(clockSlewMs, 0);
+  CHECK(std::abs(clockWallMs() - systemMs()) <= 1);
+}
+
+TEST(slew_rate_is_bounded) {
+  hostNowUs = 7000000;
+  sysRate = 1.0;
+  setSystemTime(T0);
+  sync();
+  hostAdvanceMs(NTP_REANCHOR_MS);
+  setSystemTime(T0 + (int64_t)NTP_REANCHOR_MS * 1000 - 1500000);          // 1.5 s behind
+  ntpStep();
+  CHECK_EQ(clockSlewMs, -1500);
+  int64_t before = clockWallMs();
+  hostAdvanceMs(1000);
+  CHECK_EQ(clockWallMs() - before, 1000 - 100);          // runs at 90% while slewing
+  hostAdvanceMs(20000);
+  CHECK(std::abs(clockWallMs() - systemMs()) <= 1);      // then tracks exactly
+  before = clockWallMs();
+  hostAdvanceMs(1000);
+  CHECK_EQ(clockWallMs() - before, 1000);
+}
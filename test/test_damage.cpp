@@ -0,0 +1,162 @@
+// Dirty-rectangle bookkeeping and DamageGFX clipping
+#include "../main.cpp"
+#include "test.h"
+
+static bool hasRect(int x, int y, int w, int h) {
+  for (int i = 0; i < dirtyCount; i++) {
+    const DirtyRect &r = dirtyRects[i];
+    if (r.x == x && r.y == y && r.w == w && r.h == h) return true;
+  }
+  return false;
+}
+
+static long dirtyArea() {
+  long a = 0;
+  for (int i = 0; i < dirtyCount; i++) a += (long)dirtyRects[i].w * dirtyRects[i].h;
+  return a;
+}
+
+TEST(mark_clamps_to_screen) {
+  dirtyCount = 0;
+  markDirty(-5, -3, 20, 10);
+  CHECK(hasRect(0, 0, 15, 7));
+  markDirty(DISP_W - 4, DISP_H - 2, 50, 50);
+  CHECK(hasRect(DISP_W - 4, DISP_H - 2, 4, 2));
+  CHECK_EQ(dirtyCount, 2);
+  markDirty(DISP_W, 0, 10, 10);   // fully off screen
+  markDirty(10, 10, 0, 5);        // empty
+  markDirty(-20, 10, 10, 5);
+  CHECK_EQ(dirtyCount, 2);
+}
+
+TEST(touching_rects_merge) {
+  dirtyCount = 0;
+  markDirty(10, 10, 10, 10);
+  markDirty(20, 10, 10, 10);      // shares an edge
+  CHECK_EQ(dirtyCount, 1);
+  CHECK(hasRect(10, 10, 20, 10));
+  markDirty(50, 50, 5, 5);        // disjoint
+  CHECK_EQ(dirtyCount, 2);
+  markDirty(25, 15, 30, 40);      // bridges both: merges transitively
+  CHECK_EQ(dirtyCount, 1);
+  CHECK(hasRect(10, 10, 45, 45));
+}
+
+TEST(contained_rect_is_absorbed) {
+  dirtyCount = 0;
+  markDirty(0, 0, 100, 100);
+  markDirty(10, 10, 5, 5);
+  CHECK_EQ(dirtyCount, 1);
+  CHECK(hasRect(0, 0, 100, 100));
+}
+
+TEST(full_list_folds_into_least_growth) {
+  dirtyCount = 0;
+  for (int i = 0; i < MAX_DIRTY_RECTS; i++) markDirty(i * 20, 0, 4, 4);
+  CHECK_EQ(dirtyCount, MAX_DIRTY_RECTS);
+  // Closest to the rect at x=140, so that one grows
+  markDirty(146, 20, 4, 4);
+  CHECK_EQ(dirtyCount, MAX_DIRTY_RECTS);
+  CHECK(hasRect(140, 0, 10, 24));
+  // Every marked pixel is still covered
+  long covered = dirtyArea();
+  CHECK(covered >= MAX_DIRTY_RECTS * 16 + 16);
+}
+
+TEST(union_covers_both) {
+  DirtyRect a = { 5, 7, 10, 3 }, b = { -2, 20, 4, 4 };
+  DirtyRect u = rectUnion(a, b);
+  CHECK_EQ(u.x, -2); CHECK_EQ(u.y, 7); CHECK_EQ(u.w, 17); CHECK_EQ(u.h, 17);
+  CHECK(rectsTouch(a, u));
+  DirtyRect c = { 15, 10, 1, 1 };   // touches a's corner
+  CHECK(rectsTouch(a, c));
+  DirtyRect d = { 16, 11, 1, 1 };
+  CHECK(!rectsTouch(a, d));
+}
+
+TEST(clip_limits_every_primitive) {
+  std::fill(tft.fb.begin(), tft.fb.end(), 0x1234);
+  DirtyRect clip = { 20, 30, 40, 25 };
+  gfx.setClip(clip);
+  gfx.fillRect(0, 0, DISP_W, DISP_H, 0x0001);
+  gfx.fillRect(70, 60, -60, -50, 0x0002);      // negative extents
+  gfx.drawLine(0, 0, DISP_W - 1, DISP_H - 1, 0x0003);
+  gfx.fillCircle(25, 35, 12, 0x0004);
+  gfx.setCursor(0, 40); gfx.setTextSize(2); gfx.setTextColor(0x0005);
+  gfx.print("clipped text");
+  gfx.drawPixel(19, 30, 0x0006);
+  gfx.drawPixel(60, 54, 0x0006);
+  gfx.resetClip();
+
+  int inside = 0;
+  for (int y = 0; y < DISP_H; y++)
+    for (int x = 0; x < DISP_W; x++) {
+      bool in = x >= 20 && x < 60 && y >= 30 && y < 55;
+      if (!in) { if (tft.at(x, y) != 0x1234) { CHECK(!"pixel outside clip was drawn"); return; } }
+      else if (tft.at(x, y) != 0x1234) inside++;
+    }
+  CHECK_EQ(inside, 40 * 25);
+}
+
+TEST(clipped_fill_counts_only_visible_pixels) {
+  DirtyRect clip = { 10, 10, 10, 10 };
+  gfx.setClip(clip);
+  uint32_t px = gfx.pixelsPushed, win = gfx.windowsOpened;
+  gfx.fillRect(0, 0, 15, 15, C_FG);
+  CHECK_EQ(gfx.pixelsPushed - px, 25);
+  CHECK_EQ(gfx.windowsOpened - win, 1);
+  gfx.fillRect(30, 30, 5, 5, C_FG);            // rejected without touching the panel
+  CHECK_EQ(gfx.pixelsPushed - px, 25);
+  CHECK_EQ(gfx.windowsOpened - win, 1);
+  gfx.resetClip();
+}
+
+// Steady-state frames (updateApp + flushDamage) against a full repaint.
+// Static screens push nothing; live ones push their changing parts only.
+static const char *const APP_NAMES[] = { "home", "launcher", "calculator", "compass", "accel", "clock",
+                                         "games", "tictactoe", "pong", "spaceshooter", "settings" };
+
+static void advanceScene(int frame) {
+  hostAdvanceUs(1000000 / 30);
+  pitch_filtered = 20 * sinf(frame * 0.2f);
+  roll_filtered = -15 * sinf(frame * 0.15f);
+  yaw_filtered = frame * 3.0f;
+}
+
+TEST(pixels_per_frame_by_app) {
+  const AppState apps[] = { APP_HOME, APP_LAUNCHER, APP_CALCULATOR, APP_COMPASS, APP_ACCEL, APP_CLOCK,
+                            APP_GAMES, APP_TICTACTOE, APP_PONG, APP_SPACESHOOTER, APP_SETTINGS };
+  const uint32_t full = (uint32_t)DISP_W * DISP_H;
+  const int FRAMES = 60;
+  timeval tv = { 1700000000, 0 };
+  clockAnchor(tv);
+  ntpSynced = true;
+  speaker_volume = 0;
+  cursorX = 150; cursorY = 120;
+  for (AppState app : apps) {
+    currentApp = app;
+    messageActive = false;
+    if (app == APP_PONG) pongReset();
+    if (app == APP_SPACESHOOTER) shooterReset();
+    uint32_t px = gfx.pixelsPushed;
+    redrawScreen();
+    uint32_t redraw = gfx.pixelsPushed - px;
+    px = gfx.pixelsPushed;
+    for (int f = 0; f < FRAMES; f++) {
+      advanceScene(f);
+      updateApp();
+      flushDamage();
+    }
+    uint32_t perFrame = (gfx.pixelsPushed - px) / FRAMES;
+    printf("  %-16s redraw %6u px, steady %5u px/frame (%4.1f%%)\n", APP_NAMES[app],
+           (unsigned)redraw, (unsigned)perFrame, 100.0 * perFrame / full);
+    CHECK(redraw >= full);            // the cursor is drawn on top
+    // updateAccel repaints its three bars whole every frame; the rest only
+    // touch what moved
+    CHECK(perFrame < (app == APP_ACCEL ? full / 3 : full / 16));
+    bool live = app == APP_HOME || app == APP_COMPASS || app == APP_ACCEL || app == APP_CLOCK ||
+                app == APP_PONG || app == APP_SPACESHOOTER;
+    if (!live) CHECK_EQ(perFrame, 0);
+  }
+  pongGameActive = shooterGameActive = false;
+}
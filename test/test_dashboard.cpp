@@ -0,0 +1,69 @@
+// GET / serves the pre-gzipped dashboard with an ETag, and answers a
+// matching If-None-Match with an empty 304
+#include "../main.cpp"
+#include "test.h"
+
+static std::string readFile(const char *path) {
+  std::string s;
+  FILE *f = fopen(path, "rb");
+  if (!f) return s;
+  char buf[4096];
+  size_t n;
+  while ((n = fread(buf, 1, sizeof(buf), f)) > 0) s.append(buf, n);
+  fclose(f);
+  return s;
+}
+
+static std::string gunzip(const std::string &gz) {
+  const char *path = "build/dashboard.gz";
+  FILE *f = fopen(path, "wb");
+  if (!f) return std::string();
+  fwrite(gz.data(), 1, gz.size(), f);
+  fclose(f);
+  FILE *p = popen("gzip -dc build/dashboard.gz", "r");
+  if (!p) return std::string();
+  std::string out;
+  char buf[4096];
+  size_t n;
+  while ((n = fread(buf, 1, sizeof(buf), p)) > 0) out.append(buf, n);
+  return pclose(p) == 0 ? out : std::string();
+}
+
+static void get(const char *ifNoneMatch) {
+  server.headers.clear();
+  if (ifNoneMatch) server.headers["If-None-Match"] = ifNoneMatch;
+  CHECK(server.hostRequest("/"));
+}
+
+TEST(root_is_gzipped_dashboard) {
+  startNetworkServices();
+  get(nullptr);
+  CHECK_EQ(server.code, 200);
+  CHECK_STR(server.sentHeaders["Content-Encoding"].c_str(), "gzip");
+  CHECK_STR(server.sentHeaders["ETag"].c_str(), DASHBOARD_ETAG);
+  CHECK_EQ(server.body.size(), DASHBOARD_HTML_GZ_LEN);
+  std::string html = readFile("../dashboard.html");
+  CHECK(html.size() > 1000);
+  CHECK(gunzip(server.body) == html);
+}
+
+TEST(matching_etag_is_not_modified) {
+  startNetworkServices();
+  get(DASHBOARD_ETAG);
+  CHECK_EQ(server.code, 304);
+  CHECK(server.body.empty());
+  CHECK(!server.sentHeaders.count("Content-Encoding"));
+  CHECK_STR(server.sentHeaders["ETag"].c_str(), DASHBOARD_ETAG);
+  // a list of tags that includes ours counts too
+  get("\"0000000000000000\", " DASHBOARD_ETAG);
+  CHECK_EQ(server.code, 304);
+  CHECK(server.body.empty());
+}
+
+TEST(stale_etag_gets_the_page) {
+  startNetworkServices();
+  get("\"0000000000000000\"");
+  CHECK_EQ(server.code, 200);
+  CHECK_EQ(server.body.size(), DASHBOARD_HTML_GZ_LEN);
+  CHECK_STR(server.sentHeaders["Content-Encoding"].c_str(), "gzip");
+}
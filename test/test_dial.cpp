@@ -0,0 +1,116 @@
+// Retained dial state must match what is actually on the panel, including
+// after repaints that only cover part of the dial
+#include "../main.cpp"
+#include "test.h"
+
+static std::vector<uint16_t> renderDirect() {
+  gfx.resetClip();
+  gfx.fillRect(0, 0, DISP_W, DISP_H, C_BG);
+  drawApp();
+  drawStatusBar();
+  drawCursor(cursorX, cursorY);
+  return tft.fb;
+}
+
+static void fullRedraw() {
+  dirtyCount = 0;
+  markDirty(0, 0, DISP_W, DISP_H);
+  flushDamage();
+}
+
+static void setHeading(float deg) { yaw_ref = deg; yaw_filtered = 0; }
+
+TEST(incremental_update_matches_full_draw) {
+  currentApp = APP_COMPASS; cursorX = 150; cursorY = 120;
+  setHeading(10);
+  fullRedraw();
+  for (int deg = 10; deg < 400; deg += 37) {
+    setHeading(deg % 360);
+    gfx.resetClip();
+    updateCompass();
+    std::vector<uint16_t> shown = tft.fb;
+    CHECK(shown == renderDirect());
+  }
+}
+
+TEST(partial_repaint_does_not_record_the_new_needle) {
+  currentApp = APP_COMPASS; cursorX = 150; cursorY = 120;
+  setHeading(0);
+  fullRedraw();
+  CHECK_EQ(compassDial.hands[0].drawnDeg, 0);
+
+  // The heading moves and only the hub area is repainted (e.g. the cursor
+  // passed over it) before the incremental update runs
+  setHeading(90);
+  dirtyCount = 0;
+  markDirty(compassDial.cx - 4, compassDial.cy - 4, 9, 9);
+  flushDamage();
+  CHECK_EQ(compassDial.hands[0].drawnDeg, 0);
+  CHECK(dirtyCount > 0);              // whole dial queued for the next frame
+
+  flushDamage();
+  CHECK_EQ(compassDial.hands[0].drawnDeg, 90);
+  std::vector<uint16_t> shown = tft.fb;
+  CHECK(shown == renderDirect());
+
+  // The incremental path picks up from the recorded position
+  setHeading(200);
+  dirtyCount = 0;
+  markDirty(compassDial.cx - 4, compassDial.cy - 4, 9, 9);
+  flushDamage();
+  gfx.resetClip();
+  updateCompass();
+  flushDamage();
+  shown = tft.fb;
+  CHECK(shown == renderDirect());
+}
+
+TEST(partial_repaint_without_motion_queues_nothing) {
+  currentApp = APP_COMPASS; cursorX = 150; cursorY = 120;
+  setHeading(45);
+  fullRedraw();
+  dirtyCount = 0;
+  markDirty(compassDial.cx - 4, compassDial.cy - 4, 9, 9);
+  flushDamage();
+  CHECK_EQ(dirtyCount, 0);
+}
+
+// A one-step change repaints the old and new needle (erase + draw, with the
+// hub), not the dial: a few hundred pixels against the dial's bounding box
+TEST(one_step_needle_update_is_cheap) {
+  currentApp = APP_COMPASS; cursorX = 150; cursorY = 120;
+  setHeading(100);
+  fullRedraw();
+  const uint32_t dialBox = (uint32_t)(compassDial.r * 2 + 1) * (compassDial.r * 2 + 1);
+  uint32_t worst = 0;
+  for (int deg = 101; deg < 101 + 360; deg++) {
+    dialSetHand(compassDial, 0, deg % 360);
+    gfx.resetClip();
+    uint32_t px = gfx.pixelsPushed;
+    dialUpdate(compassDial);
+    flushDamage();
+    worst = max(worst, gfx.pixelsPushed - px);
+  }
+  printf("  compass needle step: worst %u px, dial box %u px\n", (unsigned)worst, (unsigned)dialBox);
+  CHECK(worst > 0);
+  CHECK(worst <= 200);
+  CHECK(worst * 10 < dialBox);
+}
+
+TEST(one_step_second_hand_update_is_cheap) {
+  currentApp = APP_HOME; cursorX = 150; cursorY = 120;
+  for (int i = 0; i < 3; i++) dialSetHand(homeDial, i, i * 100);
+  fullRedraw();
+  uint32_t worst = 0;
+  for (int s = 1; s <= 60; s++) {
+    dialSetHand(homeDial, 2, s * 6 + 200);
+    gfx.resetClip();
+    uint32_t px = gfx.pixelsPushed;
+    dialUpdate(homeDial);
+    flushDamage();
+    worst = max(worst, gfx.pixelsPushed - px);
+  }
+  printf("  home second hand step: worst %u px\n", (unsigned)worst);
+  CHECK(worst > 0);
+  CHECK(worst <= 200);
+}
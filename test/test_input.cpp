@@ -0,0 +1,191 @@
+// Button edge ring (inputISR -> inputPoll) and the events it synthesizes
+#include "../main.cpp"
+#include "test.h"
+
+static std::vector<InputEvent> got;
+
+// Changes the button level and fires the pin-change ISR, as the core would
+static void setButton(bool down) {
+  hostPin[JOY_SW] = down ? LOW : HIGH;
+  hostIsr[JOY_SW]();
+}
+
+// Runs the sampler task's poll every 2.5 ms for `ms`, collecting events
+static void pollFor(uint32_t ms) {
+  for (uint32_t t = 0; t < ms * 1000; t += 2500) {
+    hostAdvanceUs(2500);
+    inputPoll();
+    InputEvent ev;
+    while (inputPop(ev)) got.push_back(ev);
+  }
+}
+
+static void resetInput() {
+  hostPin[JOY_SW] = HIGH;
+  centerX = centerY = 512;
+  joyBegin();
+  rawX = rawY = 512;
+  joystick_rotation = 0;
+  inputBegin();
+  hostAdvanceMs(100);
+  pollFor(20);
+  got.clear();
+}
+
+static std::vector<InputEventType> types() {
+  std::vector<InputEventType> t;
+  for (auto &e : got) t.push_back(e.type);
+  return t;
+}
+
+TEST(bounces_collapse_into_one_click) {
+  resetInput();
+  uint32_t t0 = millis();
+  setButton(true);
+  for (int i = 0; i < 3; i++) {   // contact bounce inside the lockout
+    hostAdvanceUs(1500); setButton(false);
+    hostAdvanceUs(1500); setButton(true);
+  }
+  pollFor(60);
+  uint32_t t1 = millis();
+  setButton(false);
+  hostAdvanceUs(2000); setButton(true);
+  hostAdvanceUs(2000); setButton(false);
+  pollFor(30);
+  CHECK(types() == std::vector<InputEventType>({ EV_PRESS, EV_RELEASE, EV_CLICK }));
+  if (got.size() == 3) {
+    CHECK_EQ(got[0].ms, t0);
+    CHECK_EQ(got[1].ms, t1);
+    CHECK_EQ(got[2].ms, t1);
+  }
+  CHECK(!btnPressed);
+}
+
+TEST(edge_lost_to_the_lockout_is_resynced) {
+  resetInput();
+  setButton(true);
+  hostAdvanceMs(3);
+  setButton(false);               // inside the lockout: ignored by the ISR
+  CHECK(inputIsrDown);
+  pollFor(15);
+  CHECK(types() == std::vector<InputEventType>({ EV_PRESS, EV_RELEASE, EV_CLICK }));
+  CHECK(!inputIsrDown);
+  CHECK(!btnPressed);
+}
+
+TEST(tap_between_polls_still_clicks) {
+  resetInput();
+  uint32_t t0 = millis();
+  hostAdvanceMs(1); setButton(true);
+  hostAdvanceMs(19); setButton(false);
+  // no poll ran during the tap; the ISR timestamps survive
+  pollFor(10);
+  CHECK(types() == std::vector<InputEventType>({ EV_PRESS, EV_RELEASE, EV_CLICK }));
+  if (got.size() == 3) {
+    CHECK_EQ(got[0].ms, t0 + 1);
+    CHECK_EQ(got[1].ms, t0 + 20);
+  }
+}
+
+TEST(long_press_fires_once_at_the_threshold) {
+  resetInput();
+  uint32_t t0 = millis();
+  setButton(true);
+  pollFor(INPUT_LONG_MS - 10);
+  CHECK(types() == std::vector<InputEventType>({ EV_PRESS }));
+  pollFor(20);
+  CHECK(types() == std::vector<InputEventType>({ EV_PRESS, EV_LONG_PRESS }));
+  if (got.size() == 2) CHECK_EQ(got[1].ms, t0 + INPUT_LONG_MS);
+  pollFor(2000);                  // holding on does not repeat it
+  setButton(false);
+  pollFor(10);
+  // a long press is not also a click
+  CHECK(types() == std::vector<InputEventType>({ EV_PRESS, EV_LONG_PRESS, EV_RELEASE }));
+}
+
+TEST(button_events_carry_the_cursor) {
+  resetInput();
+  cursorX = 33; cursorY = 44;
+  setButton(true);
+  pollFor(20);
+  setButton(false);
+  pollFor(10);
+  CHECK_EQ(got.size(), 3);
+  for (auto &e : got) { CHECK_EQ(e.x, 33); CHECK_EQ(e.y, 44); }
+}
+
+TEST(full_edge_ring_drops_without_desync) {
+  resetInput();
+  // More edges than the ring holds, with no poll in between
+  for (int i = 0; i < INPUT_RING + 4; i++) {
+    hostAdvanceMs(INPUT_DEBOUNCE_MS + 1);
+    setButton(i % 2 == 0);
+  }
+  CHECK_EQ((inputEdgeHead - inputEdgeTail) & (INPUT_RING - 1), INPUT_RING - 1);
+  // the event ring is smaller than what 15 edges produce, so the edges
+  // drain over several polls
+  pollFor(50);
+  setButton(false);
+  pollFor(20);
+  // presses and releases still alternate and end released
+  bool down = false;
+  for (auto &e : got) {
+    if (e.type == EV_PRESS) { CHECK(!down); down = true; }
+    if (e.type == EV_RELEASE) { CHECK(down); down = false; }
+  }
+  CHECK(!down);
+  CHECK(!btnPressed);
+}
+
+TEST(direction_then_repeats_on_schedule) {
+  resetInput();
+  uint32_t t0 = millis();
+  rawX = 512 + JOY_MIN_SPAN;      // full right
+  pollFor(1100);
+  rawX = 512;
+  pollFor(50);
+  // one JOY_DIR, then REPEATs after the delay at the repeat interval
+  CHECK(got.size() >= 2);
+  CHECK_EQ(got[0].type, EV_JOY_DIR);
+  CHECK_EQ(got[0].x, 1); CHECK_EQ(got[0].y, 0);
+  CHECK(got[0].ms - t0 <= 3);
+  uint32_t due = got[0].ms + INPUT_REPEAT_DELAY_MS;
+  int repeats = 0;
+  for (size_t i = 1; i < got.size(); i++) {
+    CHECK_EQ(got[i].type, EV_REPEAT);
+    CHECK_EQ(got[i].x, 1);
+    CHECK(got[i].ms >= due && got[i].ms - due < 3);
+    due += INPUT_REPEAT_MS;
+    repeats++;
+  }
+  CHECK_EQ(repeats, (1100 - 3 - INPUT_REPEAT_DELAY_MS) / INPUT_REPEAT_MS + 1);
+}
+
+TEST(direction_change_restarts_the_delay) {
+  resetInput();
+  rawY = 512 - JOY_MIN_SPAN;      // up
+  pollFor(300);
+  rawX = 512 + JOY_MIN_SPAN;      // up-right before the first repeat
+  pollFor(300);
+  rawX = rawY = 512;
+  pollFor(20);
+  CHECK(types() == std::vector<InputEventType>({ EV_JOY_DIR, EV_JOY_DIR }));
+  if (got.size() == 2) {
+    CHECK_EQ(got[0].x, 0); CHECK_EQ(got[0].y, -1);
+    CHECK_EQ(got[1].x, 1); CHECK_EQ(got[1].y, -1);
+  }
+}
+
+TEST(button_and_stick_events_interleave_in_time) {
+  resetInput();
+  rawX = 512 - JOY_MIN_SPAN;
+  pollFor(10);
+  setButton(true);
+  pollFor(10);
+  setButton(false);
+  pollFor(10);
+  rawX = 512;
+  pollFor(10);
+  CHECK(types() == std::vector<InputEventType>({ EV_JOY_DIR, EV_PRESS, EV_RELEASE, EV_CLICK }));
+  for (size_t i = 1; i < got.size(); i++) CHECK(got[i].ms >= got[i - 1].ms);
+}
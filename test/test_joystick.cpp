@@ -0,0 +1,139 @@
+// Joystick sampler, deadzone and expo on synthetic ADC traces
+#include "../main.cpp"
+#include "test.h"
+
+// The trace gives the ADC value per axis at the sample time; the mux
+// select line picks which axis analogRead sees
+static std::function<int(int axis, uint32_t tick)> trace;
+static uint32_t tick;
+
+static void runSampler(int ticks) {
+  hostAnalogRead = [](uint8_t) { return trace(hostPin[MUX_S0 & 31], tick); };
+  for (int i = 0; i < ticks; i++, tick++) {
+    joySample();
+    hostAdvanceUs(1000000UL / JOY_SAMPLE_HZ);
+  }
+}
+
+static void resetJoystick() {
+  centerX = centerY = 512;
+  joyBegin();
+  tick = 0;
+}
+
+// Full-travel sweep on both axes so the running extents see 0..1023
+static void calibrateSweep() {
+  trace = [](int, uint32_t t) { return (int)(t / 128 % 2 ? 1023 : 0); };
+  runSampler(32 * JOY_SAMPLE_HZ / JOY_AXIS_HZ);
+  trace = [](int, uint32_t) { return 512; };
+  runSampler(16 * JOY_SAMPLE_HZ / JOY_AXIS_HZ);
+}
+
+static double expoRef(double lin) {
+  double e = JOY_EXPO_Q8 / 256.0;
+  return lin * (1 - e) + lin * lin * lin * e;
+}
+
+TEST(each_axis_updates_at_50_hz) {
+  resetJoystick();
+  trace = [](int axis, uint32_t t) { return axis ? 512 : (int)(t * 7 % 1000); };
+  int updates = 0, last = rawX;
+  for (int i = 0; i < JOY_SAMPLE_HZ; i++) {
+    runSampler(1);
+    if (rawX != last) updates++;
+    last = rawX;
+  }
+  CHECK_EQ(JOY_AXIS_HZ, 50);
+  CHECK_EQ(updates, JOY_AXIS_HZ);
+}
+
+TEST(axes_do_not_cross_talk) {
+  resetJoystick();
+  trace = [](int axis, uint32_t) { return axis ? 100 : 900; };
+  runSampler(20 * JOY_SAMPLE_HZ / JOY_AXIS_HZ);
+  CHECK_EQ(rawX, 900);
+  CHECK_EQ(rawY, 100);
+}
+
+TEST(noise_inside_the_deadzone_reads_zero) {
+  resetJoystick();
+  calibrateSweep();
+  CHECK(joyAxes[0].lo < 10 && joyAxes[0].hi > 1013);
+  // +-50 counts of jitter is under 12% of the 512-count half travel
+  srand(7);
+  trace = [](int, uint32_t) { return 512 + rand() % 101 - 50; };
+  for (int i = 0; i < 400; i++) {
+    runSampler(1);
+    int mx, my;
+    mapJoystickToMovement(rawX, rawY, mx, my);
+    CHECK_EQ(mx, 0);
+    CHECK_EQ(my, 0);
+  }
+}
+
+TEST(shape_is_deadzone_then_expo) {
+  // lo..hi = 0..1024 around 512; the reference starts from the same Q8
+  // deflection the shaper sees, so only the curve's own rounding counts
+  double dz = JOY_DEADZONE_Q8 / 256.0;
+  for (int d = -512; d <= 512; d++) {
+    int v = joyShape(512 + d, 512, 0, 1024);
+    double lin = lround(abs(d) * 256 / 512.0) / 256.0;
+    if (lin <= dz) { CHECK_EQ(v, 0); continue; }
+    double want = 256 * expoRef((lin - dz) / (1 - dz));
+    CHECK_NEAR(fabs((double)v), want, 1.5);
+    CHECK(v == 0 || (d > 0) == (v > 0));
+  }
+  CHECK_EQ(joyShape(1024, 512, 0, 1024), 256);
+  CHECK_EQ(joyShape(0, 512, 0, 1024), -256);
+  CHECK_EQ(joyShape(2000, 512, 0, 1024), 256);   // past the extents clamps
+}
+
+TEST(shape_is_monotonic) {
+  int prev = -257;
+  for (int v = 0; v <= 1023; v++) {
+    int s = joyShape(v, 500, 20, 1000);
+    CHECK(s >= prev);
+    prev = s;
+  }
+}
+
+TEST(step_trace_settles_to_full_tilt) {
+  resetJoystick();
+  calibrateSweep();
+  trace = [](int axis, uint32_t) { return axis ? 0 : 1023; };
+  runSampler(10 * JOY_SAMPLE_HZ / JOY_AXIS_HZ);   // ten axis updates
+  int mx, my;
+  joystick_rotation = 0;
+  mapJoystickToMovement(rawX, rawY, mx, my);
+  CHECK(mx >= 250);
+  CHECK(my <= -250);
+}
+
+TEST(full_tilt_moves_joystick_speed_px_per_frame) {
+  for (int speed : { 1, 2, 5 }) {
+    int32_t sub = 0;
+    int px = 0;
+    for (int f = 0; f < 30; f++) px += joyStep(sub, 256, speed);
+    CHECK_EQ(px, 30 * speed);
+  }
+  // Half tilt carries the fraction: 1.5 px per frame on average
+  int32_t sub = 0;
+  int px = 0;
+  for (int f = 0; f < 30; f++) px += joyStep(sub, 128, 3);
+  CHECK_EQ(px, 45);
+}
+
+TEST(ui_cursor_uses_the_baseline_scale) {
+  resetJoystick();
+  calibrateSweep();
+  joystick_rotation = 0;
+  joystick_speed = 2;
+  currentApp = APP_HOME;
+  cursorX = 40; cursorY = 60; cursorSubX = cursorSubY = 0;
+  trace = [](int axis, uint32_t) { return axis ? 512 : 1023; };
+  runSampler(20 * JOY_SAMPLE_HZ / JOY_AXIS_HZ);
+  int x0 = cursorX;
+  taskUI();
+  CHECK_EQ(cursorX - x0, joystick_speed);
+  CHECK_EQ(cursorY, 60);
+}
@@ -0,0 +1,169 @@
+// JsonWriter output, and JsonReader on fixtures fed in every chunking
+#include "../main.cpp"
+#include "test.h"
+
+static std::string q16Json(q16_t v, uint8_t dec) {
+  char buf[48];
+  JsonWriter w(buf, sizeof(buf));
+  w.addQ16("v", v, dec);
+  return std::string(buf + 4);                 // skip "v":
+}
+
+// What the sketch published before: String() of the float copy
+static std::string q16String(q16_t v, uint8_t dec) {
+  return String(v * (1.0f / 65536.0f), dec).c_str();
+}
+
+TEST(q16_matches_string_float_exactly) {
+  long checked = 0;
+  for (q16_t v = -400 * 65536; v <= 400 * 65536; v += 7) {
+    if (q16Json(v, 1) != q16String(v, 1)) {
+      fprintf(stderr, "v=%d: %s vs %s\n", v, q16Json(v, 1).c_str(), q16String(v, 1).c_str());
+      CHECK(!"addQ16 differs from String(float, 1)");
+      return;
+    }
+    checked++;
+  }
+  CHECK(checked > 7000000);
+}
+
+TEST(q16_edge_cases) {
+  CHECK_STR(q16Json(-1, 1).c_str(), "-0.0");
+  CHECK_STR(q16Json(-3276, 1).c_str(), "-0.0");
+  CHECK_STR(q16Json(-3277, 1).c_str(), "-0.1");
+  CHECK_STR(q16Json(0, 1).c_str(), "0.0");
+  CHECK_STR(q16Json(16384, 1).c_str(), q16String(16384, 1).c_str());        // 0.25
+  CHECK_STR(q16Json(-49152, 1).c_str(), q16String(-49152, 1).c_str());      // -0.75
+  for (int k = -2000; k <= 2000; k++) {                                     // every quarter
+    q16_t v = k * 16384;
+    CHECK(q16Json(v, 1) == q16String(v, 1));
+    CHECK(q16Json(v, 2) == q16String(v, 2));
+  }
+  // Beyond 2^24 the float copy rounds; the JSON follows it
+  for (q16_t v = 300000000; v < 300000000 + 200000; v += 13) CHECK(q16Json(v, 1) == q16String(v, 1));
+}
+
+TEST(fixed_and_int_fields) {
+  char buf[96];
+  JsonWriter w(buf, sizeof(buf));
+  w.beginObject();
+  w.addFixed("t", -5, 1);
+  w.addFixed("w", 1234, 2);
+  w.add("n", (int32_t)INT32_MIN);
+  w.add("s", "a\"b\\c\n");
+  w.endObject();
+  CHECK_STR(buf, "{\"t\":-0.5,\"w\":12.34,\"n\":-2147483648,\"s\":\"a\\\"b\\\\c\\u000a\"}");
+  CHECK(!w.overflow);
+}
+
+TEST(overflow_is_flagged_not_written_past) {
+  char buf[8];
+  JsonWriter w(buf, sizeof(buf));
+  w.beginObject();
+  w.add("long", "value");
+  CHECK(w.overflow);
+  CHECK_EQ(strlen(buf), 7);
+}
+
+// ---- JsonReader ----
+static std::string events;
+static void collect(const char *path, const char *value) { events += path; events += '='; events += value; events += '\n'; }
+
+struct ReadResult { std::string events; bool done, failed; };
+
+static ReadResult readChunked(const std::string &doc, size_t chunk) {
+  JsonReader r(collect);
+  events.clear();
+  for (size_t i = 0; i < doc.size(); i += chunk) r.feed(doc.data() + i, std::min(chunk, doc.size() - i));
+  return { events, r.done(), r.failed() };
+}
+
+// Same result whatever the chunk size, including one byte at a time and
+// a split at every position
+static ReadResult readAllWays(const std::string &doc) {
+  ReadResult whole = readChunked(doc, doc.size() ? doc.size() : 1);
+  for (size_t chunk : { (size_t)1, (size_t)2, (size_t)3, (size_t)7, (size_t)64 }) {
+    ReadResult r = readChunked(doc, chunk);
+    CHECK(r.events == whole.events && r.done == whole.done && r.failed == whole.failed);
+  }
+  for (size_t split = 1; split < doc.size(); split++) {
+    JsonReader r(collect);
+    events.clear();
+    r.feed(doc.data(), split);
+    r.feed(doc.data() + split, doc.size() - split);
+    CHECK(events == whole.events && r.done() == whole.done);
+  }
+  return whole;
+}
+
+static const char *OWM_FIXTURE =
+  "{\"coord\":{\"lon\":77.22,\"lat\":28.65},\"weather\":[{\"id\":721,\"main\":\"Haze\","
+  "\"description\":\"haze\",\"icon\":\"50d\"}],\"base\":\"stations\",\"main\":{\"temp\":-3.46,"
+  "\"feels_like\":31.2,\"pressure\":1006,\"humidity\":62},\"visibility\":3000,\"wind\":{\"speed\":2.57,"
+  "\"deg\":300},\"clouds\":{\"all\":20},\"dt\":1696150000,\"sys\":{\"type\":1,\"country\":\"IN\"},"
+  "\"timezone\":19800,\"id\":1273294,\"name\":\"Delhi\",\"cod\":200}";
+
+TEST(reader_reports_paths_of_a_weather_response) {
+  ReadResult r = readAllWays(OWM_FIXTURE);
+  CHECK(r.done && !r.failed);
+  CHECK(r.events.find("weather[0].main=Haze\n") != std::string::npos);
+  CHECK(r.events.find("main.temp=-3.46\n") != std::string::npos);
+  CHECK(r.events.find("main.humidity=62\n") != std::string::npos);
+  CHECK(r.events.find("wind.speed=2.57\n") != std::string::npos);
+  CHECK(r.events.find("sys.country=IN\n") != std::string::npos);
+  CHECK(r.events.find("cod=200\n") != std::string::npos);
+
+  // And the fields the sketch keeps
+  JsonReader wx(weatherField);
+  for (const char *p = OWM_FIXTURE; *p; p++) wx.feed(*p);
+  CHECK(wx.done());
+  CHECK_STR(weatherMain, "Haze");
+  CHECK_EQ(weatherTempTenths, -35);
+  CHECK_STR(weatherTemp, "-3 C");                 // truncated, as (int)toFloat() did
+  CHECK_EQ(weatherHumidity, 62);
+  CHECK_EQ(weatherWindTenths, 26);
+}
+
+TEST(reader_nested_arrays_and_literals) {
+  ReadResult r = readAllWays(" { \"a\" : [ [1, 2], [], [ {\"b\": true}, null ] ],\n\t\"c\": {}, \"d\": -0.5e3 } ");
+  CHECK(r.done && !r.failed);
+  CHECK_STR(r.events.c_str(), "a[0][0]=1\na[0][1]=2\na[2][0].b=true\na[2][1]=null\nd=-0.5e3\n");
+}
+
+TEST(reader_strings_escapes_and_limits) {
+  ReadResult r = readAllWays("{\"s\":\"a\\\"b\\\\c\\nd\\u00e9e\\/\",\"k\\\"q\":1}");
+  CHECK(r.done);
+  CHECK_STR(r.events.c_str(), "s=a\"b\\c\nd?e/\nk\"q=1\n");
+
+  // Tokens are truncated to the buffer, paths to theirs; parsing goes on
+  std::string longVal(100, 'x'), longKey(80, 'k');
+  r = readAllWays("{\"v\":\"" + longVal + "\",\"" + longKey + "\":{\"z\":5},\"after\":1}");
+  CHECK(r.done);
+  CHECK(r.events.find("v=" + std::string(sizeof(JsonReader::tok) - 1, 'x') + "\n") == 0);
+  CHECK(r.events.find("after=1\n") != std::string::npos);
+}
+
+TEST(reader_rejects_malformed_input) {
+  const char *bad[] = { "{\"a\" 1}", "{\"a\":1,}", "[1,]", "{\"a\":1]", "[1 2]", "{a:1}", "}",
+                        "{\"a\":1,\"b\"}", "[[[[[[[[[1]]]]]]]]]", "{{{{{{{{{" };
+  for (const char *doc : bad) {
+    ReadResult r = readAllWays(doc);
+    if (r.done && !r.failed) fprintf(stderr, "accepted: %s\n", doc);
+    CHECK(r.failed || !r.done);
+  }
+  ReadResult ok = readAllWays("[[[[[[[[1]]]]]]]]");                  // JSON_MAX_DEPTH levels
+  CHECK(ok.done && !ok.failed);
+  ReadResult cut = readAllWays("{\"a\":[1,2");                      // truncated body
+  CHECK(!cut.done && !cut.failed);
+  ReadResult tail = readAllWays("{\"a\":1}\r\n}");                  // input after the end is ignored
+  CHECK(tail.done && !tail.failed);
+}
+
+TEST(parse_tenths_rounds_half_up) {
+  CHECK_EQ(parseTenths("12.34"), 123);
+  CHECK_EQ(parseTenths("12.35"), 124);
+  CHECK_EQ(parseTenths("-0.05"), -1);
+  CHECK_EQ(parseTenths("7"), 70);
+  CHECK_EQ(parseTenths("-3.46"), -35);
+  CHECK_EQ(parseTenths("0.9"), 9);
+}
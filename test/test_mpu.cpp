@@ -0,0 +1,98 @@
+// MPU6050 FIFO drain against the register-level fake behind Wire
+#include "../main.cpp"
+#include "test.h"
+
+static const int16_t ONE_G = 16384;
+static const int16_t DPS = 131;                       // gyro LSB per deg/s
+static const double SAMPLE_S = 1.0 / MPU_SAMPLE_RATE_HZ;
+
+static double yawDeg() { return yaw_q / 65536.0; }
+
+static void resetMpu() {
+  hostMpu.reset();
+  gx_offset = gy_offset = gz_offset = ax_offset = ay_offset = az_offset = 0;
+  fusionSetOffsets();
+  mpuSetupFifo();
+  hostMpu.fifoResets = 0;
+}
+
+static void pushFlat(int n, int16_t gz) {
+  for (int i = 0; i < n; i++) hostMpu.pushSample(0, 0, ONE_G, 0, 0, gz);
+}
+
+TEST(setup_programs_rate_and_fifo) {
+  resetMpu();
+  CHECK_EQ(hostMpu.regs[MPU_REG_SMPLRT_DIV], 1000 / MPU_SAMPLE_RATE_HZ - 1);
+  CHECK_EQ(hostMpu.regs[MPU_REG_FIFO_EN], 0x78);
+  CHECK_EQ(hostMpu.regs[MPU_REG_USER_CTRL], 0x40);
+  CHECK(hostMpu.fifo.empty());
+}
+
+TEST(every_queued_sample_is_integrated_at_the_sample_interval) {
+  resetMpu();
+  pushFlat(25, 20 * DPS);
+  hostAdvanceMs(500);                  // the wall-clock gap does not matter
+  uint32_t fused = mpuFifoSamples;
+  double y0 = yawDeg();
+  mpuDrainFifo();
+  CHECK_EQ(mpuFifoSamples - fused, 25);
+  CHECK(hostMpu.fifo.empty());
+  CHECK_NEAR(yawDeg() - y0, 25 * SAMPLE_S * 20, 0.01);
+  CHECK_NEAR(yaw, yawDeg(), 1e-4);      // published after the drain
+}
+
+TEST(bursts_fit_the_wire_buffer) {
+  resetMpu();
+  pushFlat(25, 0);
+  mpuDrainFifo();
+  // 10 whole frames per read, the remainder in a short last one
+  CHECK(hostMpu.fifoBursts == std::vector<size_t>({ 120, 120, 60 }));
+  for (size_t n : hostMpu.fifoBursts) {
+    CHECK(n <= BUFFER_LENGTH);
+    CHECK_EQ(n % MPU_FIFO_SAMPLE_BYTES, 0);
+  }
+}
+
+TEST(overflow_is_counted_and_the_fifo_reset) {
+  resetMpu();
+  pushFlat(100, 20 * DPS);             // 1200 bytes into a 1 KB FIFO
+  CHECK(hostMpu.overflow);
+  uint32_t overflows = mpuFifoOverflows, fused = mpuFifoSamples;
+  double y0 = yawDeg();
+  mpuDrainFifo();
+  CHECK_EQ(mpuFifoOverflows - overflows, 1);
+  CHECK_EQ(hostMpu.fifoResets, 1);
+  CHECK(hostMpu.fifo.empty());
+  CHECK_EQ(mpuFifoSamples, fused);     // misaligned data is dropped, not fused
+  CHECK_NEAR(yawDeg(), y0, 1e-9);
+  // and the next drain picks up cleanly
+  pushFlat(4, 20 * DPS);
+  mpuDrainFifo();
+  CHECK_EQ(mpuFifoSamples - fused, 4);
+  CHECK_EQ(mpuFifoOverflows - overflows, 1);
+  CHECK_NEAR(yawDeg() - y0, 4 * SAMPLE_S * 20, 0.01);
+}
+
+TEST(partial_frame_is_left_for_the_next_drain) {
+  resetMpu();
+  pushFlat(2, 0);
+  // the third frame turns at 40 deg/s; only half of it has landed
+  HostMpu6050 frame;
+  frame.pushSample(0, 0, ONE_G, 0, 0, 40 * DPS);
+  for (int i = 0; i < 6; i++) hostMpu.pushByte(frame.fifo[i]);
+  uint32_t fused = mpuFifoSamples;
+  double y0 = yawDeg();
+  mpuDrainFifo();
+  CHECK_EQ(mpuFifoSamples - fused, 2);
+  CHECK_EQ(hostMpu.fifo.size(), 6);
+  CHECK_NEAR(yawDeg(), y0, 0.001);
+  for (int i = 6; i < MPU_FIFO_SAMPLE_BYTES; i++) hostMpu.pushByte(frame.fifo[i]);
+  pushFlat(1, 0);
+  mpuDrainFifo();
+  CHECK_EQ(mpuFifoSamples - fused, 4);
+  CHECK(hostMpu.fifo.empty());
+  // still frame aligned: exactly one 40 deg/s sample was integrated
+  CHECK_NEAR(yawDeg() - y0, SAMPLE_S * 40, 0.001);
+  CHECK_NEAR(pitch, 0.0, 0.01);
+  CHECK_NEAR(roll, 0.0, 0.01);
+}
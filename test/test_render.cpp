@@ -0,0 +1,100 @@
+// Banded repaint (flushDamage through the RAM strip) must produce the same
+// pixels as drawing the whole screen directly to the panel
+#include "../main.cpp"
+#include "test.h"
+
+static const AppState APPS[] = { APP_HOME, APP_LAUNCHER, APP_CALCULATOR, APP_COMPASS, APP_ACCEL, APP_CLOCK,
+                                 APP_GAMES, APP_TICTACTOE, APP_PONG, APP_SPACESHOOTER, APP_SETTINGS };
+
+static std::vector<uint16_t> renderDirect() {
+  std::fill(tft.fb.begin(), tft.fb.end(), 0xDEAD);
+  gfx.resetClip();
+  gfx.fillRect(0, 0, DISP_W, DISP_H, C_BG);
+  drawApp();
+  drawStatusBar();
+  if (messageActive) drawWebMessage();
+  drawCursor(cursorX, cursorY);
+  return tft.fb;
+}
+
+static int firstDiff(const std::vector<uint16_t> &a, const std::vector<uint16_t> &b) {
+  for (size_t i = 0; i < a.size(); i++) if (a[i] != b[i]) return i;
+  return -1;
+}
+
+static void setScene(AppState app, bool message) {
+  currentApp = app;
+  messageActive = message;
+  webMessage = "hello from the web dashboard, wrapped";
+  tttBoard[0] = 1; tttBoard[4] = 2; tttBoard[8] = 1;
+  pongGameActive = true;
+  shooterGameActive = true;
+  bullets[0] = { 60 << 8, 50 << 8, 50 << 8, true, -1 };
+  enemies[0] = { 90 << 8, 40 << 8, 40 << 8, true, 0, -1 };
+  cursorX = 70; cursorY = 60;
+}
+
+TEST(full_screen_banded_matches_direct) {
+  for (bool message : { false, true }) {
+    for (AppState app : APPS) {
+      setScene(app, message);
+      std::vector<uint16_t> direct = renderDirect();
+      std::fill(tft.fb.begin(), tft.fb.end(), 0xBEEF);
+      dirtyCount = 0;
+      markDirty(0, 0, DISP_W, DISP_H);
+      flushDamage();
+      int d = firstDiff(direct, tft.fb);
+      if (d >= 0) fprintf(stderr, "app %d message %d: first diff at (%d,%d)\n", app, message, d % DISP_W, d / DISP_W);
+      CHECK_EQ(d, -1);
+    }
+  }
+}
+
+TEST(partial_repaints_match_direct) {
+  const DirtyRect rects[] = { { 0, 0, 40, 12 }, { 65, 55, 13, 13 }, { 3, 17, 150, 9 },
+                              { 100, 90, 60, 38 }, { 31, 40, 1, 70 } };
+  for (bool message : { false, true }) {
+    for (AppState app : APPS) {
+      setScene(app, message);
+      std::vector<uint16_t> direct = renderDirect();
+      dirtyCount = 0;
+      for (const DirtyRect &r : rects) {
+        for (int y = r.y; y < r.y + r.h; y++)
+          for (int x = r.x; x < r.x + r.w; x++) tft.fb[y * DISP_W + x] = 0xBEEF;
+        markDirty(r.x, r.y, r.w, r.h);
+      }
+      flushDamage();
+      int d = firstDiff(direct, tft.fb);
+      if (d >= 0) fprintf(stderr, "app %d message %d: first diff at (%d,%d)\n", app, message, d % DISP_W, d / DISP_W);
+      CHECK_EQ(d, -1);
+    }
+  }
+}
+
+TEST(bands_push_each_damaged_pixel_once) {
+  setScene(APP_LAUNCHER, false);
+  dirtyCount = 0;
+  markDirty(10, 20, 50, 40);
+  markDirty(100, 100, 20, 10);
+  uint32_t px = gfx.pixelsPushed, win = gfx.windowsOpened;
+  flushDamage();
+  // 40 rows in 16-row bands = 3 windows, plus one band for the small rect;
+  // the cursor is outside both, so it is not redrawn
+  CHECK_EQ(gfx.windowsOpened - win, 3 + 1);
+  CHECK_EQ(gfx.pixelsPushed - px, 50 * 40 + 20 * 10);
+}
+
+TEST(culled_glyphs_keep_the_cursor_moving) {
+  DirtyRect clip = { 60, 0, 20, 20 };
+  gfx.setClip(clip);
+  gfx.setTextSize(1);
+  gfx.setCursor(0, 5);
+  gfx.print("0123456789abcdef");
+  CHECK_EQ(gfx.getCursorX(), 16 * 6);
+  CHECK_EQ(gfx.getCursorY(), 5);
+  gfx.setCursor(156, 5);        // wraps before drawing
+  gfx.print("xy");
+  CHECK_EQ(gfx.getCursorX(), 12);
+  CHECK_EQ(gfx.getCursorY(), 13);
+  gfx.resetClip();
+}
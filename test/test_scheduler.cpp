@@ -0,0 +1,105 @@
+// Deadline scheduler driven by the fake clock: the task functions are
+// replaced by stubs that log the run and take a set amount of time
+#include "../main.cpp"
+#include "test.h"
+
+static std::vector<int> ranLog;
+static uint32_t costUs[TASK_COUNT];
+template <int I> static void fakeTask() { ranLog.push_back(I); hostAdvanceUs(costUs[I]); }
+static void (*const FAKES[TASK_COUNT])() = { fakeTask<0>, fakeTask<1>, fakeTask<2>, fakeTask<3>, fakeTask<4>, fakeTask<5> };
+
+static void setup(uint64_t startUs) {
+  hostNowUs = startUs;
+  target_fps = 30;
+  for (int i = 0; i < TASK_COUNT; i++) {
+    tasks[i].fn = FAKES[i];
+    tasks[i].runs = tasks[i].missed = tasks[i].overBudget = tasks[i].maxJitterUs = tasks[i].maxRunUs = 0;
+    costUs[i] = 0;
+  }
+  schedulerBegin();
+  ranLog.clear();
+}
+
+static int periodicRan() {
+  for (int t : ranLog) if (tasks[t].periodUs) return t;
+  return -1;
+}
+
+TEST(runs_the_most_overdue_task_only) {
+  setup(1000000);
+  uint32_t now = micros();
+  for (int i = 0; i < TASK_COUNT; i++) tasks[i].nextDueUs = now + 1000;   // nothing due
+  tasks[TASK_NET].nextDueUs = now - 300;
+  tasks[TASK_PUSH].nextDueUs = now - 900;
+  tasks[TASK_UI].nextDueUs = now - 10;
+  runScheduler();
+  CHECK_EQ(periodicRan(), TASK_PUSH);
+  CHECK_EQ(ranLog.size(), 2);                  // plus the background task
+  CHECK_EQ(ranLog.back(), TASK_AUDIO);
+  CHECK_EQ(tasks[TASK_PUSH].nextDueUs, now - 900 + tasks[TASK_PUSH].periodUs);
+  CHECK_EQ(tasks[TASK_PUSH].maxJitterUs, 900);
+
+  ranLog.clear();
+  runScheduler();
+  CHECK_EQ(periodicRan(), TASK_NET);
+}
+
+TEST(nothing_due_runs_background_only) {
+  setup(5000000);
+  uint32_t now = micros();
+  for (int i = 0; i < TASK_COUNT; i++) tasks[i].nextDueUs = now + 1;
+  runScheduler();
+  CHECK_EQ(ranLog.size(), 1);
+  CHECK_EQ(ranLog[0], TASK_AUDIO);
+}
+
+TEST(late_task_skips_ahead_instead_of_bursting) {
+  setup(2000000);
+  uint32_t p = tasks[TASK_SENSOR].periodUs, due = micros();
+  for (int i = 0; i < TASK_COUNT; i++) tasks[i].nextDueUs = due + 10 * p;
+  tasks[TASK_SENSOR].nextDueUs = due;
+  hostAdvanceUs(3 * p + p / 2);                // 3.5 periods late
+  runScheduler();
+  CHECK_EQ(tasks[TASK_SENSOR].runs, 1);
+  CHECK_EQ(tasks[TASK_SENSOR].missed, 3);
+  CHECK_EQ(tasks[TASK_SENSOR].nextDueUs, due + 4 * p);
+  // Next deadline is in the future: no catch-up burst
+  ranLog.clear();
+  runScheduler();
+  CHECK_EQ(periodicRan(), -1);
+  hostAdvanceUs(p / 2);
+  runScheduler();
+  CHECK_EQ(periodicRan(), TASK_SENSOR);
+  CHECK_EQ(tasks[TASK_SENSOR].missed, 3);
+}
+
+TEST(steady_load_meets_every_period) {
+  setup(0xFFFFFFFFull - 500000);               // crosses the 32-bit micros() wrap
+  costUs[TASK_SENSOR] = 300; costUs[TASK_JOY] = 60; costUs[TASK_UI] = 8000;
+  costUs[TASK_NET] = 500; costUs[TASK_PUSH] = 400; costUs[TASK_AUDIO] = 20;
+  uint64_t end = hostNowUs + 2000000;
+  while (hostNowUs < end) { runScheduler(); hostAdvanceUs(10); }
+  // Every deadline is either run or counted as missed, never run twice
+  CHECK_NEAR(tasks[TASK_SENSOR].runs + tasks[TASK_SENSOR].missed, 2 * MPU_SAMPLE_RATE_HZ, 2);
+  CHECK_NEAR(tasks[TASK_JOY].runs + tasks[TASK_JOY].missed, 2 * JOY_SAMPLE_HZ, 2);
+  CHECK_NEAR(tasks[TASK_UI].runs, 2 * 30, 1);
+  CHECK_NEAR(tasks[TASK_NET].runs, 2 * 20, 1);
+  CHECK_NEAR(tasks[TASK_PUSH].runs, 2 * SSE_MAX_HZ, 1);
+  // An 8 ms UI frame can push the 5 ms and 2.5 ms tasks a period behind;
+  // the longer-period tasks never slip
+  CHECK_EQ(tasks[TASK_UI].missed, 0);
+  CHECK_EQ(tasks[TASK_NET].missed, 0);
+  CHECK_EQ(tasks[TASK_PUSH].missed, 0);
+  CHECK(tasks[TASK_SENSOR].missed <= tasks[TASK_UI].runs);
+  CHECK(tasks[TASK_SENSOR].maxJitterUs < 8000 + 1000);
+}
+
+TEST(ui_period_follows_target_fps) {
+  setup(0);
+  target_fps = 60;
+  runScheduler();
+  CHECK_EQ(tasks[TASK_UI].periodUs, 1000000UL / 60);
+  target_fps = 0;                               // guarded against divide by zero
+  runScheduler();
+  CHECK_EQ(tasks[TASK_UI].periodUs, 1000000UL);
+}
@@ -0,0 +1,87 @@
+// /events subscribers and ssePush() framing, rate limiting and backpressure
+#include "../main.cpp"
+#include "test.h"
+
+static const char *HEADER = "HTTP/1.1 200 OK\r\nContent-Type: text/event-stream\r\n"
+                            "Cache-Control: no-cache\r\nConnection: keep-alive\r\n\r\nretry: 2000\n\n";
+
+static void resetSse() {
+  for (SseClient &s : sseClients) s.client = WiFiClient();
+  server.args.clear();
+  hostNowUs = 10000000;
+}
+
+static std::shared_ptr<HostSocket> subscribe(const char *hz = nullptr) {
+  auto sock = std::make_shared<HostSocket>();
+  server.hostClient = WiFiClient(sock);
+  server.args.clear();
+  if (hz) server.args["hz"] = hz;
+  server.code = 0;
+  handleEvents();
+  return sock;
+}
+
+static int frames(const std::string &s) {
+  int n = 0;
+  for (size_t p = 0; (p = s.find("data: ", p)) != std::string::npos; p++) n++;
+  return n;
+}
+
+// Push every 20 ms (taskPush runs at SSE_MAX_HZ) for `ms` milliseconds
+static void run(int ms) {
+  for (int t = 0; t < ms; t += 20) { hostAdvanceMs(20); ssePush(); }
+}
+
+TEST(subscribe_writes_stream_header_and_frames) {
+  resetSse();
+  auto sock = subscribe();
+  CHECK_EQ(server.code, 0);                     // the handler answers on the socket itself
+  CHECK(sock->out == HEADER);
+  pitch_fq = 3 * 65536 / 2; roll_fq = -1; yaw_fq = -90 * 65536;
+  sock->out.clear();
+  hostAdvanceMs(1000 / SSE_RATE_HZ);
+  ssePush();
+  CHECK_STR(sock->out.c_str(), "data: {\"pitch\":1.5,\"roll\":-0.0,\"yaw\":-90.0}\n\n");
+  CHECK_EQ(sseClients[0].sent, 1);
+}
+
+TEST(rate_follows_hz_argument_and_is_clamped) {
+  resetSse();
+  auto def = subscribe(), ten = subscribe("10"), fast = subscribe("1000"), slow = subscribe("0");
+  def->out.clear(); ten->out.clear(); fast->out.clear(); slow->out.clear();
+  run(2000);
+  CHECK_NEAR(frames(def->out), 2 * SSE_RATE_HZ, 1);
+  CHECK_NEAR(frames(ten->out), 20, 1);
+  CHECK_NEAR(frames(fast->out), 2 * SSE_MAX_HZ, 1);
+  CHECK_NEAR(frames(slow->out), 2, 1);
+}
+
+TEST(full_socket_drops_whole_frames) {
+  resetSse();
+  auto sock = subscribe();
+  sock->out.clear();
+  sock->writeRoom = 10;                         // less than one frame
+  run(1000);
+  CHECK_EQ(sock->out.size(), 0);
+  CHECK_EQ(sseClients[0].sent, 0);
+  CHECK_NEAR(sseClients[0].dropped, SSE_RATE_HZ, 1);
+  sock->writeRoom = 1460;
+  run(1000);
+  CHECK_NEAR(frames(sock->out), SSE_RATE_HZ, 1);
+  CHECK(sock->out.compare(0, 6, "data: ") == 0);
+  CHECK(sock->out.compare(sock->out.size() - 3, 3, "}\n\n") == 0);  // no partial frames
+}
+
+TEST(slots_are_limited_and_freed_on_disconnect) {
+  resetSse();
+  std::shared_ptr<HostSocket> socks[SSE_MAX_CLIENTS];
+  for (auto &s : socks) { s = subscribe(); CHECK_EQ(server.code, 0); }
+  auto extra = subscribe();
+  CHECK_EQ(server.code, 503);
+  socks[1]->connected = false;
+  ssePush();                                    // releases the dead socket
+  CHECK(!sseClients[1].client.sock);
+  auto again = subscribe();
+  CHECK_EQ(server.code, 0);
+  CHECK(sseClients[1].client.sock == again);
+}
@@ -0,0 +1,47 @@
+// Q15 sine table against the C library over every degree
+#include "../main.cpp"
+#include "test.h"
+
+static double rad(int deg) { return deg * M_PI / 180.0; }
+
+TEST(sin_table_within_half_lsb) {
+  double worst = 0;
+  for (int deg = -720; deg <= 720; deg++) {
+    double err = fabs(sinQ15(deg) / 32768.0 - sin(rad(deg)));
+    worst = fmax(worst, err);
+  }
+  CHECK(worst <= 0.5 / 32768 + 1e-12);
+}
+
+TEST(sin_table_matches_sinf) {
+  for (int deg = 0; deg < 360; deg++) {
+    long ref = lroundf(sinf(deg * (float)M_PI / 180.0f) * 32768.0f);
+    CHECK(labs(sinQ15(deg) - ref) <= 1);
+  }
+}
+
+TEST(symmetry_and_cos) {
+  for (int deg = 0; deg < 360; deg++) {
+    CHECK_EQ(sinQ15(-deg), -sinQ15(deg));
+    CHECK_EQ(sinQ15(deg + 360), sinQ15(deg));
+    CHECK_EQ(cosQ15(deg), sinQ15(90 - deg));
+  }
+  CHECK_EQ(sinQ15(90), 32768);
+  CHECK_EQ(sinQ15(180), 0);
+  CHECK_EQ(sinQ15(270), -32768);
+}
+
+// dialPoint rounds to the nearest pixel; it may only disagree with a float
+// reference where the exact point sits on a half pixel (e.g. r*sin 30)
+static bool onHalf(double v) { return fabs(v - floor(v) - 0.5) < 1e-3; }
+
+TEST(dial_point_matches_float) {
+  for (int r = 1; r <= DIAL_MAX_REACH; r++)
+    for (int deg = 0; deg < 360; deg++) {
+      int x, y; dialPoint(80, 64, r, deg, x, y);
+      double fx = 80 + r * sin(rad(deg)), fy = 64 - r * cos(rad(deg));
+      CHECK(x == (int)floor(fx + 0.5) || onHalf(fx));
+      CHECK(y == (int)floor(fy + 0.5) || onHalf(fy));
+      CHECK(fabs(x - fx) <= 0.5 + 1e-3 && fabs(y - fy) <= 0.5 + 1e-3);
+    }
+}
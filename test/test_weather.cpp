@@ -0,0 +1,178 @@
+// Weather refresh state machine on fake lwIP: every step returns at once,
+// DNS and connect complete through callbacks, the response is parsed from
+// arbitrary segments, and failures back off exponentially
+#include "../main.cpp"
+#include "test.h"
+
+static const ip_addr_t SERVER_IP = { 0x0a00a8c0 };
+static const std::string RESPONSE =
+  "HTTP/1.1 200 OK\r\nContent-Type: application/json\r\nConnection: close\r\n\r\n"
+  "{\"weather\":[{\"main\":\"Rain\"}],\"main\":{\"temp\":12.96,\"humidity\":81},\"wind\":{\"speed\":4.1}}";
+
+static void resetWeather() {
+  weatherClose();
+  weather = WeatherJob();
+  weatherLastFetch = 0;
+  hostPcbs.clear();
+  hostDnsResult = ERR_INPROGRESS; hostDnsQueries = 0; hostDnsCb = nullptr;
+  hostConnectResult = ERR_OK; hostTcpNewFails = false;
+  WiFi.hostStatus = WL_CONNECTED;
+  hostNowUs = 100000000;
+  weatherRequest();
+}
+
+// Steps until `state` or `limit` steps; the clock must not move inside a step
+static bool stepUntil(WeatherState state, int limit = 50) {
+  for (int i = 0; i < limit && weather.state != state; i++) {
+    uint64_t before = hostNowUs;
+    weatherStep();
+    CHECK_EQ(hostNowUs, before);
+    hostAdvanceMs(10);
+  }
+  return weather.state == state;
+}
+
+static void serve(const std::string &resp, size_t segment) {
+  for (size_t i = 0; i < resp.size(); i += segment) hostTcpDeliver(hostPcb(), resp.substr(i, segment));
+  hostTcpRemoteClose(hostPcb());
+}
+
+TEST(fetch_goes_through_dns_connect_and_parse) {
+  for (size_t segment : { (size_t)1, (size_t)5, (size_t)100, (size_t)1460 }) {
+    resetWeather();
+    strcpy(weatherMain, "N/A");
+    weatherStep();
+    CHECK_EQ(weather.state, WX_DNS);
+    CHECK(stepUntil(WX_IDLE, 5) == false);       // waits on the lookup without blocking
+    hostDnsAnswer(&SERVER_IP);
+    CHECK(stepUntil(WX_CONNECT));
+    CHECK_EQ(hostPcb()->ip.addr, SERVER_IP.addr);
+    CHECK_EQ(hostPcb()->port, WEATHER_PORT);
+    CHECK(hostPcb()->nagleOff);
+    weatherStep();
+    CHECK_EQ(weather.state, WX_CONNECT);          // still waiting on the handshake
+    hostTcpAccept(hostPcb());
+    CHECK(stepUntil(WX_STATUS));
+    CHECK(hostPcb()->sent.compare(0, 29, "GET /data/2.5/weather?id=city") == 0);
+    CHECK(hostPcb()->sent.find("HTTP/1.0\r\nHost: " WEATHER_HOST "\r\n\r\n") != std::string::npos);
+
+    serve(RESPONSE, segment);
+    CHECK(stepUntil(WX_IDLE, 200));
+    CHECK_STR(weatherMain, "Rain");
+    CHECK_EQ(weatherTempTenths, 130);
+    CHECK_EQ(weatherHumidity, 81);
+    CHECK_EQ(weatherWindTenths, 41);
+    CHECK(weatherLastFetch != 0);
+    CHECK_EQ(weather.failures, 0);
+    CHECK_EQ(hostPcbsOpen(), 0);
+    CHECK_EQ(hostPbufLive, 0);
+    CHECK_EQ(hostPcb()->recved, RESPONSE.size());  // window reopened for everything read
+    CHECK_EQ(weather.nextAttemptMs, millis() - 10 + WEATHER_REFRESH_MS);
+  }
+}
+
+TEST(dns_is_cached_between_refreshes) {
+  resetWeather();
+  hostDnsResult = ERR_OK; hostDnsCached = SERVER_IP;   // lwIP answers from its cache
+  weatherStep();
+  CHECK_EQ(weather.state, WX_CONNECT);
+  hostTcpAccept(hostPcb());
+  stepUntil(WX_STATUS);
+  serve(RESPONSE, 64);
+  CHECK(stepUntil(WX_IDLE));
+  CHECK_EQ(hostDnsQueries, 1);
+
+  hostAdvanceMs(WEATHER_REFRESH_MS);
+  weatherStep();
+  CHECK_EQ(weather.state, WX_CONNECT);
+  CHECK_EQ(hostDnsQueries, 1);                         // within WEATHER_DNS_TTL_MS
+  weatherClose();
+}
+
+// One failed attempt of each kind; the retry delay doubles up to the cap
+TEST(failures_back_off_exponentially) {
+  resetWeather();
+  uint32_t expect = WEATHER_RETRY_MIN_MS;
+  for (int attempt = 0; attempt < 9; attempt++) {
+    hostAdvanceMs(weather.nextAttemptMs - millis());
+    weatherStep();
+    switch (attempt % 5) {
+      case 0:                                           // DNS never answers
+        stepUntil(WX_IDLE, WEATHER_CONNECT_TIMEOUT_MS / 10 + 5);
+        break;
+      case 1:                                           // DNS says no such host
+        hostDnsAnswer(nullptr);
+        stepUntil(WX_IDLE);
+        break;
+      case 2:                                           // connect never completes
+        hostDnsAnswer(&SERVER_IP);
+        stepUntil(WX_IDLE, WEATHER_CONNECT_TIMEOUT_MS / 10 + 5);
+        break;
+      case 3:                                           // server error
+        hostDnsAnswer(&SERVER_IP);
+        stepUntil(WX_CONNECT);
+        hostTcpAccept(hostPcb());
+        stepUntil(WX_STATUS);
+        serve("HTTP/1.1 500 Internal Server Error\r\n\r\n", 64);
+        stepUntil(WX_IDLE);
+        break;
+      case 4:                                           // reset mid-body
+        hostDnsAnswer(&SERVER_IP);
+        stepUntil(WX_CONNECT);
+        hostTcpAccept(hostPcb());
+        stepUntil(WX_STATUS);
+        hostTcpDeliver(hostPcb(), RESPONSE.substr(0, RESPONSE.size() - 10));
+        weatherStep();
+        hostTcpReset(hostPcb());
+        stepUntil(WX_IDLE);
+        break;
+    }
+    CHECK_EQ(weather.state, WX_IDLE);
+    CHECK_EQ(weather.failures, attempt + 1);
+    CHECK_EQ(weather.retryMs, expect);
+    CHECK_EQ(hostPcbsOpen(), 0);
+    CHECK_EQ(hostPbufLive, 0);
+    expect = iMin(expect * 2, WEATHER_RETRY_MAX_MS);
+  }
+  CHECK_EQ(weather.retryMs, WEATHER_RETRY_MAX_MS);
+  CHECK_EQ(weatherLastFetch, 0);
+}
+
+TEST(late_dns_answer_is_ignored) {
+  resetWeather();
+  weatherStep();
+  stepUntil(WX_IDLE, WEATHER_CONNECT_TIMEOUT_MS / 10 + 5);   // lookup timed out
+  dns_found_callback stale = hostDnsCb;
+  void *staleArg = hostDnsArg;
+  hostAdvanceMs(weather.retryMs);
+  weatherStep();                                             // next lookup in flight
+  CHECK_EQ(weather.state, WX_DNS);
+  stale("host", &SERVER_IP, staleArg);
+  weatherStep();
+  CHECK_EQ(weather.state, WX_DNS);
+  hostDnsAnswer(&SERVER_IP);
+  CHECK(stepUntil(WX_CONNECT));
+  weatherClose();
+}
+
+TEST(response_timeout_closes_the_socket) {
+  resetWeather();
+  weatherStep();
+  hostDnsAnswer(&SERVER_IP);
+  stepUntil(WX_CONNECT);
+  hostTcpAccept(hostPcb());
+  stepUntil(WX_STATUS);
+  hostTcpDeliver(hostPcb(), "HTTP/1.1 200 OK\r\n");          // then nothing
+  CHECK(stepUntil(WX_IDLE, WEATHER_RESPONSE_TIMEOUT_MS / 10 + 5));
+  CHECK_EQ(weather.failures, 1);
+  CHECK_EQ(hostPcbsOpen(), 0);
+  CHECK_EQ(hostPbufLive, 0);
+}
+
+TEST(nothing_happens_offline) {
+  resetWeather();
+  WiFi.hostStatus = WL_DISCONNECTED;
+  stepUntil(WX_DNS, 10);
+  CHECK_EQ(weather.state, WX_IDLE);
+  CHECK_EQ(hostDnsQueries, 0);
+}
@@ -0,0 +1,63 @@
+#!/usr/bin/env python3
+"""Compress dashboard.html into dashboard_html.h (gzip bytes in PROGMEM + ETag).
+
+Run from anywhere after editing dashboard.html:
+    python3 tools/gen_dashboard.py
+Verify the committed header is current (exit status 1 if not):
+    python3 tools/gen_dashboard.py --check
+"""
+import gzip
+import hashlib
+import os
+import sys
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+SRC = os.path.join(ROOT, "dashboard.html")
+DST = os.path.join(ROOT, "dashboard_html.h")
+
+
+def render():
+    with open(SRC, "rb") as f:
+        html = f.read()
+    # mtime=0 keeps the output byte-identical for identical input
+    gz = gzip.compress(html, compresslevel=9, mtime=0)
+    etag = hashlib.sha1(gz).hexdigest()[:16]
+
+    lines = [
+        "// Generated by tools/gen_dashboard.py from dashboard.html - do not edit.",
+        "#pragma once",
+        "",
+        '#define DASHBOARD_ETAG "\\"%s\\""' % etag,
+        "#define DASHBOARD_HTML_GZ_LEN %d" % len(gz),
+        "",
+        "const uint8_t DASHBOARD_HTML_GZ[] PROGMEM = {",
+    ]
+    for i in range(0, len(gz), 16):
+        lines.append("  " + ",".join("0x%02x" % b for b in gz[i:i + 16]) + ",")
+    lines.append("};")
+    lines.append("")
+    return "\n".join(lines), len(html), len(gz), etag
+
+
+def main():
+    text, raw_len, gz_len, etag = render()
+    if "--check" in sys.argv[1:]:
+        try:
+            with open(DST) as f:
+                current = f.read()
+        except OSError:
+            current = None
+        if current != text:
+            print("%s is stale: run python3 tools/gen_dashboard.py" % os.path.basename(DST))
+            return 1
+        print("%s is up to date (etag %s)" % (os.path.basename(DST), etag))
+        return 0
+
+    with open(DST, "w") as f:
+        f.write(text)
+    print("%s: %d -> %d bytes, etag %s" % (os.path.basename(DST), raw_len, gz_len, etag))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
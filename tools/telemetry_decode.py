@@ -0,0 +1,70 @@
+#!/usr/bin/env python3
+"""Decode the binary /history dump into CSV.
+
+    curl -o hist.bin http://miniconsole.local/history
+    python3 tools/telemetry_decode.py hist.bin > hist.csv
+
+A URL can be passed instead of a file. Layout (little-endian):
+    "MCT1", u8 channels, u8 blocks
+    per block: u16 used, u16 count, used bytes of
+        keyframe: u32 ms, 6 x i16 raw accel/gyro, 3 x i32 centidegrees
+        count-1 samples: varint ms delta, channels x zigzag varint deltas
+"""
+import struct
+import sys
+import urllib.request
+
+HEADER = "ms,ax,ay,az,gx,gy,gz,pitch_cdeg,roll_cdeg,yaw_cdeg"
+
+
+def varint(buf, pos):
+    v = shift = 0
+    while True:
+        b = buf[pos]
+        pos += 1
+        v |= (b & 0x7F) << shift
+        if not b & 0x80:
+            return v, pos
+        shift += 7
+
+
+def decode(data):
+    if data[:4] != b"MCT1":
+        raise ValueError("bad magic")
+    channels, blocks = data[4], data[5]
+    pos = 6
+    for _ in range(blocks):
+        used, count = struct.unpack_from("<HH", data, pos)
+        pos += 4
+        blk, pos = data[pos:pos + used], pos + used
+        if count == 0:
+            continue
+        ms = struct.unpack_from("<I", blk, 0)[0]
+        vals = list(struct.unpack_from("<6h", blk, 4)) + list(struct.unpack_from("<%di" % (channels - 6), blk, 16))
+        yield ms, list(vals)
+        p = 4 + 12 + 4 * (channels - 6)
+        for _ in range(count - 1):
+            d, p = varint(blk, p)
+            ms = (ms + d) & 0xFFFFFFFF
+            for i in range(channels):
+                z, p = varint(blk, p)
+                vals[i] += (z >> 1) ^ -(z & 1)
+            yield ms, list(vals)
+
+
+def main():
+    if len(sys.argv) != 2:
+        sys.exit(__doc__)
+    src = sys.argv[1]
+    if src.startswith("http://"):
+        data = urllib.request.urlopen(src).read()
+    else:
+        with open(src, "rb") as f:
+            data = f.read()
+    print(HEADER)
+    for ms, vals in decode(data):
+        print(",".join(str(x) for x in [ms] + vals))
+
+
+if __name__ == "__main__":
+    main()